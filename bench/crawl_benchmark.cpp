@@ -0,0 +1,525 @@
+#include "fixture_server.hpp"
+#include "synthetic_web.hpp"
+#include "synthetic_fetcher.hpp"
+#include "html_link_scanner.hpp"
+#include "url_frontier.hpp"
+#include "crawler.hpp"
+#include "config.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// End-to-end crawl benchmark against a local synthetic web.
+//
+// Starts a FixtureServer on 127.0.0.1, points a WebCrawler at it through a
+// temporary config file and reports throughput, fetch latency and CPU cost
+// per page. The server runs in this process, so its CPU time is measured
+// separately and subtracted. With --in-memory the crawler uses the synthetic
+// fetcher instead and no sockets are involved at all, which measures the
+// crawler's own ceiling.
+//
+// With --node and --peers several copies of the benchmark form a cluster on
+// localhost, each crawling its share of the hosts (use --in-memory --hosts N
+// so there is more than one host to share).
+//
+// With --in-memory --async N the crawler is left out: the frontier and the
+// link scanner are driven directly by the synthetic fetcher's fetchAsync(),
+// with N fetches in flight, so simulated latency ties up no thread and the
+// page rate is bounded only by scanning and queueing.
+
+namespace {
+
+struct BenchmarkOptions {
+    SyntheticWeb::Options web;
+    int pages = 2000;
+    int threads = 8;
+    bool inMemory = false;
+    std::string node;                   // Cluster address of this process
+    std::string peers;                  // Comma-separated addresses of the other processes
+    std::string results;                // Columnar results file to write, if any
+    int rankLinks = 0;                  // Link analysis interval in seconds, 0 leaves it off
+    std::string topic;                  // Focus topic, empty for an unfocused crawl
+    std::string pageModel;              // Linear page model for the inference stage, if any
+    int async = 0;                      // Fetches in flight for the async pipeline, 0 runs the crawler
+};
+
+double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto toSeconds = [](const FILETIME& time) {
+        return static_cast<double>((static_cast<long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+    };
+    return toSeconds(kernel) + toSeconds(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --pages N            Pages to crawl (default 2000)\n"
+              << "  --threads N          Crawler threads (default 8)\n"
+              << "  --web-size N         Distinct pages in the synthetic web (default 10000)\n"
+              << "  --fanout N           Links per page (default 10)\n"
+              << "  --page-kb N          Approximate page size in KiB (default 16)\n"
+              << "  --latency-ms X       Median server latency (default 5)\n"
+              << "  --latency-p99-ms X   99th percentile server latency (default 50)\n"
+              << "  --error-rate X       Share of pages answering 503 (default 0.01)\n"
+              << "  --redirect-rate X    Share of pages answering 301 (default 0.02)\n"
+              << "  --no-gzip            Serve uncompressed pages\n"
+              << "  --seed N             Seed for the synthetic web (default 42)\n"
+              << "  --in-memory          Use the synthetic fetcher instead of a local HTTP server\n"
+              << "  --hosts N            Spread the synthetic web over N hosts (needs --in-memory)\n"
+              << "  --node HOST:PORT     Join a cluster as this address\n"
+              << "  --peers A,B,...      Other cluster members\n"
+              << "  --results PATH       Export every fetch to a columnar results file\n"
+              << "  --rank-links SECS    Record the link graph and re-rank the queue every SECS seconds\n"
+              << "  --topic TERMS        Focus the crawl on a topic and report its harvest rate\n"
+              << "  --page-model PATH    Score pages with a linear model on the inference stage\n"
+              << "  --async N            Skip the crawler and drive the frontier from N async fetches\n"
+              << "                       (needs --in-memory)\n";
+}
+
+bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--no-gzip") {
+            options.web.gzip = false;
+        } else if (arg == "--in-memory") {
+            options.inMemory = true;
+        } else if (arg == "--pages" && hasValue) {
+            options.pages = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--web-size" && hasValue) {
+            options.web.pageCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--fanout" && hasValue) {
+            options.web.fanout = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--page-kb" && hasValue) {
+            options.web.pageBytes = std::strtoull(argv[++i], nullptr, 10) * 1024;
+        } else if (arg == "--latency-ms" && hasValue) {
+            options.web.latencyMedianMs = std::atof(argv[++i]);
+        } else if (arg == "--latency-p99-ms" && hasValue) {
+            options.web.latencyP99Ms = std::atof(argv[++i]);
+        } else if (arg == "--error-rate" && hasValue) {
+            options.web.errorRate = std::atof(argv[++i]);
+        } else if (arg == "--redirect-rate" && hasValue) {
+            options.web.redirectRate = std::atof(argv[++i]);
+        } else if (arg == "--hosts" && hasValue) {
+            options.web.hostCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--node" && hasValue) {
+            options.node = argv[++i];
+        } else if (arg == "--peers" && hasValue) {
+            options.peers = argv[++i];
+        } else if (arg == "--results" && hasValue) {
+            options.results = argv[++i];
+        } else if (arg == "--rank-links" && hasValue) {
+            options.rankLinks = std::atoi(argv[++i]);
+        } else if (arg == "--topic" && hasValue) {
+            options.topic = argv[++i];
+        } else if (arg == "--page-model" && hasValue) {
+            options.pageModel = argv[++i];
+        } else if (arg == "--async" && hasValue) {
+            options.async = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.web.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.web.hostCount > 1 && !options.inMemory) {
+        std::cerr << "--hosts needs --in-memory: the fixture server only answers on 127.0.0.1" << std::endl;
+        return false;
+    }
+    if (options.async > 0 && !options.inMemory) {
+        std::cerr << "--async needs --in-memory: only the synthetic fetcher parks fetches without a thread" << std::endl;
+        return false;
+    }
+    return options.pages > 0 && options.threads > 0;
+}
+
+std::string writeConfig(const std::filesystem::path& directory, const std::string& startUrl,
+                        const BenchmarkOptions& options) {
+    std::filesystem::path configPath = directory / "config.json";
+    std::ofstream file(configPath);
+    file << "{\n"
+         << "  \"crawler\": {\n"
+         << "    \"start_url\": \"" << startUrl << "\",\n"
+         << "    \"max_depth\": 1000,\n"
+         << "    \"max_pages\": " << options.pages << ",\n"
+         << "    \"seed_from_sitemaps\": false\n"
+         << "  },\n"
+         << "  \"threading\": {\n"
+         << "    \"thread_count\": " << options.threads << "\n"
+         << "  },\n"
+         << "  \"storage\": {\n"
+         << "    \"database_path\": \"" << (directory / "crawler.db").generic_string() << "\",\n"
+         << "    \"save_html\": false,\n"
+         << "    \"save_images\": false,\n"
+         << "    \"image_directory\": \"" << (directory / "images").generic_string() << "\",\n"
+         << "    \"content_directory\": \"" << (directory / "content").generic_string() << "\",\n"
+         << "    \"results_file\": \"" << std::filesystem::path(options.results).generic_string() << "\"\n"
+         << "  },\n"
+         << "  \"filters\": {\n"
+         << "    \"allowed_domains\": [\"" << (options.web.hostCount > 1 ? "*.test" : "127.0.0.1") << "\"]\n"
+         << "  },\n"
+         << "  \"monitoring\": {\n"
+         << "    \"log_level\": \"WARNING\",\n"
+         << "    \"log_file\": \"" << (directory / "crawler.log").generic_string() << "\",\n"
+         << "    \"enable_console_output\": false\n"
+         << "  }";
+    if (options.inMemory) {
+        file << ",\n"
+             << "  \"advanced\": {\n"
+             << "    \"fetcher\": \"synthetic\"\n"
+             << "  },\n"
+             << "  \"synthetic\": {\n"
+             << "    \"page_count\": " << options.web.pageCount << ",\n"
+             << "    \"fanout\": " << options.web.fanout << ",\n"
+             << "    \"page_kb\": " << options.web.pageBytes / 1024 << ",\n"
+             << "    \"latency_ms\": " << options.web.latencyMedianMs << ",\n"
+             << "    \"latency_p99_ms\": " << options.web.latencyP99Ms << ",\n"
+             << "    \"error_rate\": " << options.web.errorRate << ",\n"
+             << "    \"redirect_rate\": " << options.web.redirectRate << ",\n"
+             << "    \"seed\": " << options.web.seed << ",\n"
+             << "    \"host_count\": " << options.web.hostCount << "\n"
+             << "  }";
+    }
+    if (options.rankLinks > 0) {
+        file << ",\n"
+             << "  \"link_graph\": {\n"
+             << "    \"enabled\": true,\n"
+             << "    \"rank_interval_seconds\": " << options.rankLinks << "\n"
+             << "  }";
+    }
+    if (!options.topic.empty()) {
+        file << ",\n"
+             << "  \"focus\": {\n"
+             << "    \"topic\": \"" << options.topic << "\"\n"
+             << "  }";
+    }
+    if (!options.pageModel.empty()) {
+        file << ",\n"
+             << "  \"inference\": {\n"
+             << "    \"backend\": \"linear\",\n"
+             << "    \"page_model\": \"" << std::filesystem::path(options.pageModel).generic_string() << "\"\n"
+             << "  }";
+    }
+    if (!options.node.empty()) {
+        file << ",\n"
+             << "  \"cluster\": {\n"
+             << "    \"node\": \"" << options.node << "\",\n"
+             << "    \"peers\": [";
+        size_t start = 0;
+        bool first = true;
+        while (start < options.peers.size()) {
+            size_t comma = options.peers.find(',', start);
+            if (comma == std::string::npos) {
+                comma = options.peers.size();
+            }
+            if (comma > start) {
+                file << (first ? "" : ", ") << "\"" << options.peers.substr(start, comma - start) << "\"";
+                first = false;
+            }
+            start = comma + 1;
+        }
+        file << "]\n"
+             << "  }";
+    }
+    file << "\n}\n";
+    return configPath.string();
+}
+
+/**
+ * @class AsyncPipeline
+ * @brief Crawls the synthetic web through fetchAsync() with a frontier and link scanner only
+ *
+ * A fixed number of fetches is kept in flight. Bodies are buffered as the
+ * fetcher's timer thread delivers them, then scanned for links by worker
+ * threads, which queue new URLs and start the next fetches.
+ */
+class AsyncPipeline {
+public:
+    explicit AsyncPipeline(const BenchmarkOptions& options)
+        : options(options)
+        , fetcher(options.web) {
+    }
+
+    void run(const std::string& startUrl) {
+        std::vector<UrlFrontier::Entry> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.insert(startUrl);
+            frontier.push({startUrl, 0});
+            takeFetchesLocked(batch);
+        }
+        launch(batch);
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < options.threads; ++i) {
+            workers.emplace_back(&AsyncPipeline::workerLoop, this);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    long long getPages() const { return pages; }
+    long long getFailed() const { return failed; }
+    long long getLinks() const { return links; }
+    long long getBytes() const { return bytes; }
+
+private:
+    struct Page {
+        std::string url;
+        int depth = 0;
+        std::string body;
+        Fetcher::Result result;
+    };
+
+    // Next URLs to fetch, up to the in-flight and page limits
+    void takeFetchesLocked(std::vector<UrlFrontier::Entry>& batch) {
+        UrlFrontier::Entry entry;
+        while (inFlight < options.async && started < options.pages && frontier.pop(entry)) {
+            inFlight++;
+            started++;
+            batch.push_back(std::move(entry));
+        }
+    }
+
+    // Outside the lock: a fetch without latency completes before fetchAsync() returns
+    void launch(std::vector<UrlFrontier::Entry>& batch) {
+        for (auto& entry : batch) {
+            auto page = std::make_shared<Page>();
+            page->url = std::move(entry.url);
+            page->depth = entry.depth;
+
+            Fetcher::Request request;
+            request.url = page->url;
+            fetcher.fetchAsync(request,
+                [](long, const std::string&, long long) { return true; },
+                [page](const char* data, size_t size) {
+                    page->body.append(data, size);
+                    return true;
+                },
+                [this, page](const Fetcher::Result& result) {
+                    page->result = result;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        fetched.push_back(page);
+                    }
+                    condition.notify_one();
+                });
+        }
+        batch.clear();
+    }
+
+    bool finishedLocked() const {
+        return inFlight == 0 && scanning == 0 && (frontier.empty() || started >= options.pages);
+    }
+
+    void workerLoop() {
+        std::vector<std::string> found;
+        std::vector<UrlFrontier::Entry> batch;
+        while (true) {
+            std::shared_ptr<Page> page;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !fetched.empty() || finishedLocked(); });
+                if (fetched.empty()) {
+                    break;
+                }
+                page = std::move(fetched.front());
+                fetched.pop_front();
+                scanning++;
+            }
+
+            found.clear();
+            bool ok = page->result.completed && page->result.status == 200;
+            if (ok) {
+                HtmlLinkScanner scanner([this, &found](const std::string& ref, HtmlLinkScanner::RefKind,
+                                                       const std::string&) {
+                    found.push_back(ref.compare(0, 1, "/") == 0 ? origin + ref : ref);
+                });
+                scanner.feed(page->body.data(), page->body.size());
+                scanner.finish();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                inFlight--;
+                scanning--;
+                (ok ? pages : failed)++;
+                bytes += static_cast<long long>(page->body.size());
+                for (auto& url : found) {
+                    if (seen.insert(url).second) {
+                        frontier.push({std::move(url), page->depth + 1});
+                        links++;
+                    }
+                }
+                takeFetchesLocked(batch);
+            }
+            launch(batch);
+            condition.notify_all();
+        }
+    }
+
+    const BenchmarkOptions& options;
+    const std::string origin = "http://127.0.0.1";     // For the paths of a single-host web
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    UrlFrontier frontier;
+    std::unordered_set<std::string> seen;
+    std::deque<std::shared_ptr<Page>> fetched;         // Completed, waiting to be scanned
+    int inFlight = 0;                                   // Started and not yet scanned
+    int scanning = 0;
+    int started = 0;
+    long long pages = 0;
+    long long failed = 0;
+    long long links = 0;
+    long long bytes = 0;
+
+    // Last, so fetches cancelled at destruction complete into live state
+    SyntheticFetcher fetcher;
+};
+
+int runAsyncPipeline(const BenchmarkOptions& options) {
+    SyntheticWeb web(options.web);
+    std::string startUrl = web.pageUrl(0);
+    if (options.web.hostCount <= 1) {
+        startUrl = "http://127.0.0.1" + startUrl;
+    }
+
+    AsyncPipeline pipeline(options);
+    double cpuStart = processCpuSeconds();
+    auto wallStart = std::chrono::steady_clock::now();
+    pipeline.run(startUrl);
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallStart;
+    double cpu = processCpuSeconds() - cpuStart;
+
+    long long fetched = pipeline.getPages() + pipeline.getFailed();
+    std::cout << std::fixed << std::setprecision(2)
+              << "pages fetched:     " << pipeline.getPages() << " (" << pipeline.getFailed() << " failed)\n"
+              << "fetches in flight: " << options.async << "\n"
+              << "pages/sec:         " << (wall.count() > 0 ? fetched / wall.count() : 0.0) << "\n"
+              << "URLs queued:       " << pipeline.getLinks() << "\n"
+              << "CPU per page (ms): " << (fetched > 0 ? cpu * 1000.0 / fetched : 0.0) << "\n"
+              << "body bytes:        " << pipeline.getBytes() << "\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+    if (options.async > 0) {
+        return runAsyncPipeline(options);
+    }
+
+    SyntheticWeb web(options.web);
+    // Server latency is a sleep per request, so keep plenty of handlers free
+    FixtureServer server(web, std::max<size_t>(64, static_cast<size_t>(options.threads) * 4));
+    if (!options.inMemory && !server.start()) {
+        std::cerr << "Failed to start fixture server" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+        ("crawler_bench_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+
+    double pagesPerSecond = 0.0;
+    WebCrawler::CrawlerStats stats;
+    double crawlerCpu = 0.0;
+    {
+        // The synthetic fetcher serves the same web for any host
+        std::string startUrl = web.pageUrl(0);
+        if (options.web.hostCount <= 1) {
+            startUrl = (options.inMemory ? "http://127.0.0.1" : server.getBaseUrl()) + startUrl;
+        }
+        Config config(writeConfig(directory, startUrl, options));
+        WebCrawler crawler(config);
+
+        double cpuStart = processCpuSeconds();
+        double serverCpuStart = server.getCpuTime().count();
+        auto wallStart = std::chrono::steady_clock::now();
+
+        if (!crawler.start()) {
+            std::cerr << "Failed to start crawler" << std::endl;
+            server.stop();
+            return 1;
+        }
+        crawler.waitForCompletion();
+
+        std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallStart;
+        stats = crawler.getStats();
+        crawlerCpu = (processCpuSeconds() - cpuStart) - (server.getCpuTime().count() - serverCpuStart);
+        pagesPerSecond = wall.count() > 0 ? stats.visitedUrls / wall.count() : 0.0;
+    }
+
+    server.stop();
+    std::error_code ignored;
+    std::filesystem::remove_all(directory, ignored);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "pages crawled:     " << stats.visitedUrls << " (" << stats.failedUrls << " failed)\n"
+              << "server requests:   " << server.getRequests() << "\n"
+              << "pages/sec:         " << pagesPerSecond << "\n"
+              << "fetch p50 (ms):    " << stats.fetchLatencyP50Ms << "\n"
+              << "fetch p99 (ms):    " << stats.fetchLatencyP99Ms << "\n"
+              << "CPU per page (ms): "
+              << (stats.visitedUrls > 0 ? crawlerCpu * 1000.0 / stats.visitedUrls : 0.0) << "\n"
+              << "wire bytes:        " << stats.wireBytes << " (" << stats.totalBytes << " decoded)\n";
+    if (stats.clusterMembers > 0) {
+        std::cout << "cluster members:   " << stats.clusterMembers << "\n"
+                  << "URLs forwarded:    " << stats.forwardedUrls << " (" << stats.receivedUrls << " received)\n"
+                  << "exchange bytes:    " << stats.exchangeBytes << "\n";
+    }
+    if (stats.linkEdges > 0) {
+        std::cout << "links recorded:    " << stats.linkEdges << "\n";
+    }
+    if (!options.topic.empty()) {
+        std::cout << "harvest rate:      " << stats.harvestRate << "\n";
+    }
+    if (stats.inferredItems > 0) {
+        std::cout << "pages scored:      " << stats.inferredItems << " (" << stats.meanInferenceBatch
+                  << " per batch)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,323 @@
+#include "fixture_server.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef int socklen_t;
+#define CLOSE_SOCKET closesocket
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <ctime>
+#define CLOSE_SOCKET close
+#endif
+
+namespace {
+
+const long long INVALID = -1;
+
+// Requests with larger headers are rejected
+const size_t MAX_HEADER_BYTES = 64 * 1024;
+
+// How often blocked calls wake up to check for shutdown
+const int POLL_INTERVAL_MS = 200;
+
+long long threadCpuMicroseconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    auto toMicros = [](const FILETIME& time) {
+        return ((static_cast<long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+    };
+    return toMicros(kernel) + toMicros(user);
+#else
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 301: return "Moved Permanently";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+bool sendAll(long long socket, const char* data, size_t size) {
+    while (size > 0) {
+        int sent = send(static_cast<int>(socket), data, static_cast<int>(std::min<size_t>(size, 1 << 30)), 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool headerContains(const std::string& headers, const char* name, const char* token) {
+    std::string lower = headers;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    size_t pos = lower.find(std::string("\r\n") + name + ":");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    size_t end = lower.find("\r\n", pos + 2);
+    return lower.substr(pos, end - pos).find(token) != std::string::npos;
+}
+
+} // namespace
+
+FixtureServer::FixtureServer(const SyntheticWeb& web, size_t handlerThreads)
+    : web(web)
+    , handlerThreads(std::max<size_t>(1, handlerThreads))
+    , listenSocket(INVALID)
+    , port(0)
+    , running(false)
+    , requests(0)
+    , bytesSent(0)
+    , cpuMicroseconds(0) {
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+FixtureServer::~FixtureServer() {
+    stop();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool FixtureServer::start(int requestedPort) {
+    if (running) {
+        return true;
+    }
+
+    long long s = static_cast<long long>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (s < 0) {
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(static_cast<int>(s), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<unsigned short>(requestedPort));
+    if (bind(static_cast<int>(s), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(static_cast<int>(s), 1024) != 0) {
+        CLOSE_SOCKET(static_cast<int>(s));
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(static_cast<int>(s), reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    listenSocket = s;
+
+    running = true;
+    for (size_t i = 0; i < handlerThreads; ++i) {
+        handlers.emplace_back(&FixtureServer::handlerLoop, this);
+    }
+    acceptor = std::thread(&FixtureServer::acceptLoop, this);
+    return true;
+}
+
+void FixtureServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    connectionCondition.notify_all();
+    if (acceptor.joinable()) {
+        acceptor.join();
+    }
+    for (auto& handler : handlers) {
+        handler.join();
+    }
+    handlers.clear();
+
+    for (long long s : pendingConnections) {
+        CLOSE_SOCKET(static_cast<int>(s));
+    }
+    pendingConnections.clear();
+
+    CLOSE_SOCKET(static_cast<int>(listenSocket));
+    listenSocket = INVALID;
+}
+
+int FixtureServer::getPort() const {
+    return port;
+}
+
+std::string FixtureServer::getBaseUrl() const {
+    return "http://127.0.0.1:" + std::to_string(port);
+}
+
+size_t FixtureServer::getRequests() const {
+    return requests;
+}
+
+size_t FixtureServer::getBytesSent() const {
+    return bytesSent;
+}
+
+std::chrono::duration<double> FixtureServer::getCpuTime() const {
+    return std::chrono::duration<double>(static_cast<double>(cpuMicroseconds.load()) / 1e6);
+}
+
+void FixtureServer::acceptLoop() {
+    while (running) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(static_cast<int>(listenSocket), &readable);
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = POLL_INTERVAL_MS * 1000;
+        if (select(static_cast<int>(listenSocket) + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        long long client = static_cast<long long>(accept(static_cast<int>(listenSocket), nullptr, nullptr));
+        if (client < 0) {
+            continue;
+        }
+
+        int noDelay = 1;
+        setsockopt(static_cast<int>(client), IPPROTO_TCP, TCP_NODELAY,
+                   reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#ifdef _WIN32
+        DWORD receiveTimeout = POLL_INTERVAL_MS;
+#else
+        timeval receiveTimeout;
+        receiveTimeout.tv_sec = 0;
+        receiveTimeout.tv_usec = POLL_INTERVAL_MS * 1000;
+#endif
+        setsockopt(static_cast<int>(client), SOL_SOCKET, SO_RCVTIMEO,
+                   reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            pendingConnections.push_back(client);
+        }
+        connectionCondition.notify_one();
+    }
+}
+
+void FixtureServer::handlerLoop() {
+    while (true) {
+        long long client;
+        {
+            std::unique_lock<std::mutex> lock(connectionMutex);
+            connectionCondition.wait(lock, [this] { return !running || !pendingConnections.empty(); });
+            if (!running) {
+                break;
+            }
+            client = pendingConnections.front();
+            pendingConnections.pop_front();
+        }
+
+        serveConnection(client);
+        CLOSE_SOCKET(static_cast<int>(client));
+    }
+}
+
+void FixtureServer::serveConnection(long long client) {
+    std::string buffer;
+    char chunk[16 * 1024];
+
+    // Charged after every response so the total is current while serving
+    long long cpuMark = threadCpuMicroseconds();
+
+    while (running) {
+        // Read one request head; anything after it belongs to the next request
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer.size() > MAX_HEADER_BYTES) {
+                return;
+            }
+            int received = recv(static_cast<int>(client), chunk, sizeof(chunk), 0);
+            if (received == 0) {
+                return;
+            }
+            if (received < 0) {
+                // Receive timeout: keep waiting unless the server is stopping
+                if (!running) {
+                    return;
+                }
+                continue;
+            }
+            buffer.append(chunk, static_cast<size_t>(received));
+        }
+
+        std::string head = buffer.substr(0, headerEnd + 2);
+        buffer.erase(0, headerEnd + 4);
+
+        size_t firstSpace = head.find(' ');
+        size_t secondSpace = firstSpace == std::string::npos ? std::string::npos : head.find(' ', firstSpace + 1);
+        if (secondSpace == std::string::npos) {
+            const char badRequest[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            sendAll(client, badRequest, sizeof(badRequest) - 1);
+            return;
+        }
+        std::string method = head.substr(0, firstSpace);
+        std::string target = head.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+        bool http10 = head.compare(secondSpace + 1, 8, "HTTP/1.0") == 0;
+        bool close = headerContains(head, "connection", "close") ||
+                     (http10 && !headerContains(head, "connection", "keep-alive"));
+        bool acceptGzip = headerContains(head, "accept-encoding", "gzip");
+
+        SyntheticWeb::Response response = web.respond(target, acceptGzip);
+        if (response.delay.count() > 0) {
+            std::this_thread::sleep_for(response.delay);
+        }
+
+        std::string out = "HTTP/1.1 " + std::to_string(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+        out += "Content-Type: " + response.contentType + "\r\n";
+        out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        if (!response.contentEncoding.empty()) {
+            out += "Content-Encoding: " + response.contentEncoding + "\r\n";
+        }
+        if (!response.location.empty()) {
+            out += "Location: " + response.location + "\r\n";
+        }
+        out += close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+        if (method != "HEAD") {
+            out += response.body;
+        }
+
+        if (!sendAll(client, out.data(), out.size())) {
+            return;
+        }
+        requests++;
+        bytesSent += out.size();
+        long long cpuNow = threadCpuMicroseconds();
+        cpuMicroseconds += cpuNow - cpuMark;
+        cpuMark = cpuNow;
+
+        if (close) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "synthetic_web.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @class FixtureServer
+ * @brief Minimal HTTP/1.1 server on the loopback interface for benchmarks
+ *
+ * Serves a SyntheticWeb on 127.0.0.1. Accepted connections are handed to a
+ * fixed pool of handler threads; each handler serves keep-alive requests on
+ * its connection until the client closes it. Simulated server latency is a
+ * sleep in the handler, so the pool should be larger than the number of
+ * crawler threads. Handler CPU time is tracked separately so the driver can
+ * subtract the server's share from the process total.
+ */
+class FixtureServer {
+public:
+    /**
+     * @brief Constructor
+     * @param web Site to serve; must outlive the server
+     * @param handlerThreads Connections served concurrently
+     */
+    FixtureServer(const SyntheticWeb& web, size_t handlerThreads = 64);
+    ~FixtureServer();
+
+    /**
+     * @brief Bind and start serving
+     * @param port Port to listen on, or 0 for any free port
+     * @return False if the socket could not be set up
+     */
+    bool start(int port = 0);
+
+    /**
+     * @brief Stop accepting, close connections and join all threads
+     */
+    void stop();
+
+    int getPort() const;
+    std::string getBaseUrl() const;
+
+    // Statistics
+    size_t getRequests() const;
+    size_t getBytesSent() const;
+    std::chrono::duration<double> getCpuTime() const;
+
+private:
+    void acceptLoop();
+    void handlerLoop();
+    void serveConnection(long long socket);
+
+    const SyntheticWeb& web;
+    size_t handlerThreads;
+
+    long long listenSocket;
+    int port;
+    std::atomic<bool> running;
+
+    std::thread acceptor;
+    std::vector<std::thread> handlers;
+    std::deque<long long> pendingConnections;
+    std::mutex connectionMutex;
+    std::condition_variable connectionCondition;
+
+    std::atomic<size_t> requests;
+    std::atomic<size_t> bytesSent;
+    std::atomic<long long> cpuMicroseconds;
+};
@@ -0,0 +1,439 @@
+#include "synthetic_web.hpp"
+#include "crawler.hpp"
+#include "config.hpp"
+#include "url_parser.hpp"
+#include "file_indexer.hpp"
+#include "database.hpp"
+#include "monitoring.hpp"
+#include "text_normalizer.hpp"
+#include "keyword_matcher.hpp"
+#include "language_identifier.hpp"
+#include "inference_stage.hpp"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <regex>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+// Microbenchmarks for the crawler's hot paths.
+//
+// Pages come from a corpus directory of recorded HTML (data/content by
+// default, override with --corpus <dir>); if it holds no pages, pages from
+// the synthetic web are used instead. Run with --benchmark_format=json or
+// --benchmark_out=<file> --benchmark_out_format=json for machine-readable
+// results.
+
+namespace {
+
+struct Page {
+    std::string url;
+    std::string html;
+};
+
+std::string corpusDirectory = "data/content";
+
+std::filesystem::path scratchDirectory() {
+    static const std::filesystem::path directory = [] {
+        std::filesystem::path path = std::filesystem::temp_directory_path() /
+            ("crawler_micro_" + std::to_string(getpid()));
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return directory;
+}
+
+const std::vector<Page>& corpus() {
+    static const std::vector<Page> pages = [] {
+        std::vector<Page> loaded;
+        std::error_code error;
+        for (const auto& file : std::filesystem::directory_iterator(corpusDirectory, error)) {
+            if (!file.is_regular_file()) {
+                continue;
+            }
+            std::ifstream in(file.path(), std::ios::binary);
+            std::ostringstream html;
+            html << in.rdbuf();
+            // Recorded files are named <host>_<depth>_<n>.html
+            std::string name = file.path().filename().string();
+            loaded.push_back({"https://" + name.substr(0, name.find('_')) + "/" + name, html.str()});
+        }
+
+        if (loaded.empty()) {
+            SyntheticWeb::Options options;
+            options.gzip = false;
+            SyntheticWeb web(options);
+            for (size_t i = 0; i < 32; ++i) {
+                std::string path = SyntheticWeb::pagePath(i);
+                loaded.push_back({"https://synthetic.example" + path, web.respond(path, false).body});
+            }
+        }
+        return loaded;
+    }();
+    return pages;
+}
+
+const std::vector<std::string>& corpusLinks() {
+    static const std::vector<std::string> links = [] {
+        URLParser parser;
+        std::vector<std::string> all;
+        for (const auto& page : corpus()) {
+            std::vector<std::string> found = parser.extractLinks(page.html, page.url);
+            all.insert(all.end(), found.begin(), found.end());
+        }
+        if (all.empty()) {
+            all.push_back("https://synthetic.example/page/0");
+        }
+        return all;
+    }();
+    return links;
+}
+
+// Distinct URLs spread over many hosts, like a frontier mid-crawl
+std::vector<std::string> makeUrls(size_t count, size_t salt) {
+    std::vector<std::string> urls;
+    urls.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        urls.push_back("https://host" + std::to_string((i * 2654435761u + salt) % 4096) +
+                       ".example/articles/" + std::to_string(salt) + "/" + std::to_string(i) + ".html");
+    }
+    return urls;
+}
+
+// Corpus pages joined until they reach a given size
+std::string corpusText(size_t bytes) {
+    std::string text;
+    for (size_t i = 0; text.size() < bytes; ++i) {
+        text += corpus()[i % corpus().size()].html;
+    }
+    text.resize(bytes);
+    return text;
+}
+
+std::string writeCrawlerConfig() {
+    std::filesystem::path directory = scratchDirectory() / "crawler";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path configPath = directory / "config.json";
+    std::ofstream file(configPath);
+    // No robots.txt or DNS lookups, so nothing leaves the process. Trap
+    // detection is off because the synthetic URLs all share one pattern per
+    // host and would otherwise measure the drop path instead of the queue.
+    file << "{\n"
+         << "  \"crawler\": { \"max_pages\": 0, \"max_depth\": 100, \"respect_robots_txt\": false,"
+         << " \"seed_from_sitemaps\": false },\n"
+         << "  \"storage\": { \"database_path\": \"" << (directory / "crawler.db").generic_string() << "\","
+         << " \"content_directory\": \"" << (directory / "content").generic_string() << "\","
+         << " \"image_directory\": \"" << (directory / "images").generic_string() << "\" },\n"
+         << "  \"monitoring\": { \"log_level\": \"WARNING\", \"enable_console_output\": false,"
+         << " \"log_file\": \"" << (directory / "crawler.log").generic_string() << "\" },\n"
+         << "  \"advanced\": { \"dns_resolver_threads\": 0, \"detect_url_traps\": false }\n"
+         << "}\n";
+    return configPath.string();
+}
+
+// A crawler that is configured but never started, to drive scheduling
+WebCrawler& idleCrawler() {
+    static Config config(writeCrawlerConfig());
+    static WebCrawler crawler(config);
+    return crawler;
+}
+
+// The container WebCrawler keeps its visited URLs in
+using VisitedSet = std::set<std::string>;
+
+} // namespace
+
+// URLParser
+
+static void BM_ExtractLinks(benchmark::State& state) {
+    const auto& pages = corpus();
+    URLParser parser;
+    size_t bytes = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        const Page& page = pages[i++ % pages.size()];
+        benchmark::DoNotOptimize(parser.extractLinks(page.html, page.url));
+        bytes += page.html.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_ExtractLinks);
+
+static void BM_Join(benchmark::State& state) {
+    static const char* const refs[] = {
+        "/watch?v=abc123", "../images/logo.png", "page.html", "//cdn.example.com/a.js",
+        "https://other.example/path", "?page=2", "#top", "a/b/../c/./d.html"
+    };
+    URLParser parser;
+    const std::string base = "https://www.example.com/dir/sub/index.html";
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.join(base, refs[i++ % (sizeof(refs) / sizeof(refs[0]))]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Join);
+
+static void BM_GetDomain(benchmark::State& state) {
+    const auto& links = corpusLinks();
+    URLParser parser;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.getDomain(links[i++ % links.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetDomain);
+
+// Scheduling
+
+static void BM_ScheduleUrl(benchmark::State& state) {
+    WebCrawler& crawler = idleCrawler();
+    if (state.thread_index() == 0) {
+        crawler.clearUrls();
+    }
+    const std::vector<std::string> urls = makeUrls(1 << 16, static_cast<size_t>(state.thread_index()));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        crawler.addUrl(urls[i++ & (urls.size() - 1)], 1);
+
+        // Keep the queue at a realistic size instead of growing without bound
+        if (state.thread_index() == 0 && (i & 0xffff) == 0 && crawler.getQueuedCount() > (1 << 18)) {
+            crawler.clearUrls();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScheduleUrl)->ThreadRange(1, 16)->UseRealTime();
+
+// Visited set
+
+static void BM_VisitedInsert(benchmark::State& state) {
+    const std::vector<std::string> urls = makeUrls(static_cast<size_t>(state.range(0)), 0);
+    for (auto _ : state) {
+        VisitedSet visited;
+        for (const auto& url : urls) {
+            visited.insert(url);
+        }
+        benchmark::DoNotOptimize(visited.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VisitedInsert)->Range(1 << 10, 1 << 18);
+
+static void BM_VisitedLookup(benchmark::State& state) {
+    const std::vector<std::string> urls = makeUrls(static_cast<size_t>(state.range(0)), 0);
+    const std::vector<std::string> misses = makeUrls(static_cast<size_t>(state.range(0)), 1);
+    VisitedSet visited(urls.begin(), urls.end());
+
+    // Half hits, half misses, as when most discovered links are new
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& url = (i & 1) ? misses[(i >> 1) % misses.size()] : urls[(i >> 1) % urls.size()];
+        benchmark::DoNotOptimize(visited.find(url) != visited.end());
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VisitedLookup)->Range(1 << 10, 1 << 18);
+
+// Storage
+
+static void BM_SavePage(benchmark::State& state) {
+    const auto& pages = corpus();
+    FileIndexer indexer((scratchDirectory() / "indexer").string());
+    size_t bytes = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        const Page& page = pages[i % pages.size()];
+        benchmark::DoNotOptimize(indexer.savePage(page.url + "?copy=" + std::to_string(i), page.html));
+        bytes += page.html.size();
+        ++i;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SavePage)->Iterations(2000);
+
+static void BM_DatabaseAddPage(benchmark::State& state) {
+    const auto& pages = corpus();
+    Database database((scratchDirectory() / "pages.db").string());
+    database.initialize();
+    size_t i = 0;
+    for (auto _ : state) {
+        const Page& page = pages[i % pages.size()];
+        std::string url = page.url + "?copy=" + std::to_string(i);
+        benchmark::DoNotOptimize(database.addPage(url, "Benchmark page", page.html, "content/page.html"));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DatabaseAddPage)->Iterations(2000);
+
+// Text analysis
+
+// How ContentAnalyzer used to normalize text, for comparison
+static void BM_NormalizeTextRegex(benchmark::State& state) {
+    const std::string text = corpusText(static_cast<size_t>(state.range(0)));
+    const std::regex htmlRegex("<[^>]*>");
+    const std::regex specialRegex("[^a-z0-9\\s]");
+    const std::regex whitespaceRegex("\\s+");
+    for (auto _ : state) {
+        std::string processed = text;
+        std::transform(processed.begin(), processed.end(), processed.begin(), ::tolower);
+        processed = std::regex_replace(processed, htmlRegex, "");
+        processed = std::regex_replace(processed, specialRegex, " ");
+        processed = std::regex_replace(processed, whitespaceRegex, " ");
+        benchmark::DoNotOptimize(processed.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_NormalizeTextRegex)->Range(4 << 10, 256 << 10);
+
+static void BM_NormalizeText(benchmark::State& state) {
+    const std::string text = corpusText(static_cast<size_t>(state.range(0)));
+    std::string processed;
+    for (auto _ : state) {
+        TextNormalizer::normalize(text, processed);
+        benchmark::DoNotOptimize(processed.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_NormalizeText)->Range(4 << 10, 256 << 10);
+
+// Terms that look like words without being common ones
+std::vector<std::string> makeTerms(size_t count) {
+    std::vector<std::string> terms;
+    for (size_t i = 0; i < count; ++i) {
+        terms.push_back("term" + std::to_string(i * 7919 % 100003));
+    }
+    return terms;
+}
+
+// How ContentAnalyzer used to look for spam terms, for comparison
+static void BM_KeywordFind(benchmark::State& state) {
+    const std::string text = TextNormalizer::normalize(corpusText(64 << 10));
+    const std::vector<std::string> terms = makeTerms(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& term : terms) {
+            hits += text.find(term) != std::string::npos;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (64 << 10));
+}
+BENCHMARK(BM_KeywordFind)->Range(16, 4096);
+
+static void BM_KeywordMatch(benchmark::State& state) {
+    const std::string text = corpusText(64 << 10);
+    KeywordMatcher matcher;
+    for (const auto& term : makeTerms(static_cast<size_t>(state.range(0)))) {
+        matcher.add(term);
+    }
+    matcher.build();
+    KeywordMatcher::Matches matches;
+    for (auto _ : state) {
+        matcher.match(text, matches);
+        benchmark::DoNotOptimize(matches.total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (64 << 10));
+}
+BENCHMARK(BM_KeywordMatch)->Range(16, 4096);
+
+// Scanning stops once the language is clear, so this is per page
+static void BM_IdentifyLanguage(benchmark::State& state) {
+    const auto& pages = corpus();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LanguageIdentifier::identify(pages[i++ % pages.size()].html).language);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IdentifyLanguage);
+
+// Inference
+
+static void BM_PageFeatures(benchmark::State& state) {
+    const auto& pages = corpus();
+    std::vector<float> features(4096);
+    size_t i = 0;
+    for (auto _ : state) {
+        InferenceStage::pageFeatures(pages[i++ % pages.size()].html, features.data(), features.size());
+        benchmark::DoNotOptimize(features.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PageFeatures);
+
+// Items per second by batch size, for a model that fits in L2 (4096 inputs,
+// 64 labels: 1 MB) and one that does not (16384 inputs, 512 labels: 32 MB)
+static void BM_LinearModel(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const size_t inputs = static_cast<size_t>(state.range(1));
+    const size_t labels = static_cast<size_t>(state.range(2));
+    std::vector<float> weights(inputs * labels);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = static_cast<float>(i * 7919 % 1000) / 1000.0f - 0.5f;
+    }
+    LinearBackend model(inputs, std::vector<std::string>(labels, "label"), weights, std::vector<float>(labels));
+    std::vector<float> features(batch * inputs, 1.0f / 64.0f);
+    std::vector<float> scores(batch * labels);
+    std::string error;
+    for (auto _ : state) {
+        model.run(features.data(), batch, scores.data(), error);
+        benchmark::DoNotOptimize(scores.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch));
+}
+BENCHMARK(BM_LinearModel)->ArgsProduct({{1, 4, 16, 64}, {4096}, {64}})->ArgsProduct({{1, 4, 16, 64}, {16384}, {512}});
+
+// Logging
+
+static void BM_MonitoringLog(benchmark::State& state) {
+    static Monitoring monitoring((scratchDirectory() / "monitoring.log").string(), Monitoring::LogLevel::INFO);
+    monitoring.setConsoleOutput(false);
+
+    // Arg 0 logs below the threshold, which every DEBUG call pays for
+    Monitoring::LogLevel level = state.range(0) ? Monitoring::LogLevel::INFO : Monitoring::LogLevel::DEBUG;
+    for (auto _ : state) {
+        monitoring.log(level, "Processing URL: https://www.example.com/articles/2024/benchmark (depth: 3)");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MonitoringLog)->Arg(0)->Arg(1)->ThreadRange(1, 8);
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // Flags left over after Google Benchmark took its own
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--corpus" && i + 1 < argc) {
+            corpusDirectory = argv[++i];
+        } else {
+            benchmark::ReportUnrecognizedArguments(argc, argv);
+            return 1;
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::error_code ignored;
+    std::filesystem::remove_all(scratchDirectory(), ignored);
+    return 0;
+}
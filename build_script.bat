@@ -31,7 +31,7 @@ if %ERRORLEVEL% NEQ 0 (
 
 :: Build the crawler
 echo Building with CL.EXE...
-cl.exe /std:c++17 /EHsc /W4 /MD /Iinclude /Febuild/universal_crawler.exe main.cpp src/universal_crawler.cpp
+cl.exe /std:c++17 /EHsc /W4 /MD /Iinclude /Febuild/universal_crawler.exe main.cpp src/universal_crawler.cpp src/url_trap_detector.cpp src/host_filter.cpp
 
 if %ERRORLEVEL% NEQ 0 (
     echo Build failed!
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class AhoCorasick
+ * @brief Finds every occurrence of many literal patterns in one pass over the text
+ *
+ * Patterns are compiled into a deterministic automaton: failure links are
+ * folded into a full transition table, so scanning costs one table lookup
+ * per input byte regardless of the number of patterns. Bytes that no
+ * pattern uses share a single column, which keeps the table small.
+ *
+ * add() all patterns, then build(); the built matcher is read-only and may
+ * be shared between threads.
+ */
+class AhoCorasick {
+public:
+    /**
+     * @brief Constructor
+     * @param caseInsensitive Match ASCII letters regardless of case
+     */
+    explicit AhoCorasick(bool caseInsensitive = false);
+
+    /**
+     * @brief Add a pattern; empty patterns are ignored
+     * @param pattern Literal to search for
+     * @param id Value reported when the pattern matches
+     */
+    void add(std::string_view pattern, uint32_t id);
+
+    /**
+     * @brief Compile the automaton; must be called after the last add()
+     */
+    void build();
+
+    /**
+     * @brief Report every match in the text
+     * @param onMatch Called as onMatch(id, end) with end the offset just past
+     *        the match; return false to stop scanning
+     */
+    template <typename Callback>
+    void scan(std::string_view text, Callback&& onMatch) const {
+        if (!built || patternCount == 0) {
+            return;
+        }
+        uint32_t state = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            state = transitions[state * classCount + byteClass[static_cast<unsigned char>(text[i])]];
+            for (uint32_t o = outputStart[state]; o < outputStart[state + 1]; ++o) {
+                if (!onMatch(outputs[o], i + 1)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Whether any pattern occurs in the text
+     */
+    bool containsAny(std::string_view text) const;
+
+    bool empty() const;
+    size_t getPatternCount() const;
+    size_t getStateCount() const;
+
+private:
+    bool caseInsensitive;
+    bool built;
+    size_t patternCount;
+
+    // Trie built by add(): sparse children, converted to a table by build()
+    struct TrieNode {
+        std::vector<std::pair<unsigned char, uint32_t>> children;
+        std::vector<uint32_t> ids;
+    };
+    std::vector<TrieNode> trie;
+
+    uint16_t byteClass[256];
+    size_t classCount;
+    std::vector<uint32_t> transitions;      // state * classCount + class -> state
+    std::vector<uint32_t> outputStart;      // outputs of state s: [outputStart[s], outputStart[s + 1])
+    std::vector<uint32_t> outputs;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @class AllocationStats
+ * @brief Process-wide heap allocation counters
+ *
+ * Built with COUNT_ALLOCATIONS (CMake option COUNT_ALLOCATIONS), the global
+ * operator new and delete are replaced by versions that count every heap
+ * allocation, both in total and for the calling thread, so the cost of a
+ * code path can be measured by sampling the thread counter around it.
+ * Without the option the counters always read zero.
+ */
+class AllocationStats {
+public:
+    /**
+     * @brief Whether operator new is being counted in this build
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Heap allocations made by the calling thread so far
+     */
+    static size_t getThreadAllocations();
+
+    // Totals across all threads
+    static size_t getTotalAllocations();
+    static size_t getTotalBytes();
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class BufferPool
+ * @brief Thread-safe pool of reusable body buffers
+ *
+ * Download buffers are handed out with their previous capacity intact, so a
+ * crawler in steady state stops reallocating while appending response data.
+ */
+class BufferPool {
+public:
+    /**
+     * @brief Constructor
+     * @param initialCapacity Capacity reserved for newly created buffers
+     * @param maxPooled Maximum number of idle buffers kept
+     * @param maxRetainedCapacity Buffers grown beyond this are freed instead of pooled
+     */
+    BufferPool(size_t initialCapacity = 64 * 1024,
+               size_t maxPooled = 32,
+               size_t maxRetainedCapacity = 4 * 1024 * 1024);
+
+    /**
+     * @brief Take an empty buffer from the pool
+     * @return Empty buffer, possibly with reserved capacity
+     */
+    std::string acquire();
+
+    /**
+     * @brief Return a buffer to the pool
+     * @param buffer Buffer to recycle; its contents are discarded
+     */
+    void release(std::string&& buffer);
+
+    // Statistics
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getIdleCount() const;
+
+private:
+    size_t initialCapacity;
+    size_t maxPooled;
+    size_t maxRetainedCapacity;
+
+    std::vector<std::string> idle;
+    mutable std::mutex poolMutex;
+
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+};
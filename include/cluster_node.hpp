@@ -0,0 +1,200 @@
+#pragma once
+
+#include "hash_ring.hpp"
+#include "url_exchange.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+class Monitoring;
+
+/**
+ * @class ClusterNode
+ * @brief Membership, host partitioning and URL forwarding for a distributed crawl
+ *
+ * Every crawler process in a cluster runs one ClusterNode, identified by
+ * the "host:port" address it listens on. Hosts are partitioned over the
+ * live members with a HashRing, so each host is crawled by exactly one
+ * node and per-host state (robots.txt, politeness, trap detection) stays
+ * local. URLs discovered for a host owned elsewhere go through a
+ * UrlExchange, which drops recent repeats and batches them per
+ * destination; batches are sent front-coded (and gzip-compressed when
+ * large) over TCP once they fill up or the flush interval passes.
+ * Exchange volume is reported as Monitoring counters.
+ *
+ * Membership is driven by heartbeats, which also carry the sender's view
+ * of the ring. A node joins by sending heartbeats to its seeds, which add
+ * it on first contact and pass it on to everyone else; it leaves by
+ * announcing so on stop(), or is dropped once nothing has been heard from
+ * it for the failure timeout. Whenever the ring changes, the membership
+ * handler is told so the crawler can hand queued URLs to their new owners,
+ * and URLs still waiting for a departed node are rerouted.
+ *
+ * Heartbeats also carry whether the sender is idle and how many URLs it
+ * has sent and received. isQuiescent() reports the cluster as finished
+ * once every member is idle and all forwarded URLs have arrived, stably
+ * for two heartbeats, so all nodes of a crawl stop together.
+ *
+ * Handlers are called on the node's own threads, never with its lock held.
+ */
+class ClusterNode {
+public:
+    struct Options {
+        std::string self;                   // "host:port" this node listens on and is known by
+        std::vector<std::string> seeds;     // Other members to contact at startup
+        size_t virtualNodes = 64;           // Ring points per member
+        size_t batchSize = 256;             // URLs per destination before an early flush
+        size_t recentCapacity = 16384;      // URLs remembered to drop repeats before sending
+        std::chrono::milliseconds flushInterval{100};
+        std::chrono::milliseconds heartbeatInterval{500};
+        std::chrono::milliseconds failureTimeout{5000};
+    };
+
+    struct Stats {
+        long long urlsSent = 0;
+        long long urlsReceived = 0;
+        long long batchesSent = 0;
+        long long batchBytesSent = 0;       // URL batches on the wire, framing included
+        long long messagesSent = 0;
+        long long messagesReceived = 0;
+        long long bytesSent = 0;            // On the wire, after compression
+        long long bytesReceived = 0;
+        long long duplicatesDropped = 0;    // Repeats never sent
+        size_t members = 0;                 // Live members, including this node
+    };
+
+    /**
+     * @brief Receives a URL forwarded by another node
+     */
+    using UrlHandler = std::function<void(std::string url, int depth)>;
+
+    /**
+     * @brief Told when a member joins or leaves the ring
+     */
+    using MembershipHandler = std::function<void(const std::string& node, bool joined)>;
+
+    /**
+     * @brief Reports whether the local crawler has nothing left to do
+     */
+    using IdleProbe = std::function<bool()>;
+
+    /**
+     * @brief Constructor
+     * @param options Cluster settings
+     * @param onUrl Receives URLs forwarded to this node
+     * @param onMembershipChange Told about members joining and leaving
+     * @param isLocallyIdle Polled for every heartbeat
+     * @param monitoring Receives exchange counters and the batch delay, may be null
+     */
+    ClusterNode(const Options& options, UrlHandler onUrl, MembershipHandler onMembershipChange,
+                IdleProbe isLocallyIdle, Monitoring* monitoring = nullptr);
+
+    /**
+     * @brief Destructor, leaves the cluster if still running
+     */
+    ~ClusterNode();
+
+    ClusterNode(const ClusterNode&) = delete;
+    ClusterNode& operator=(const ClusterNode&) = delete;
+
+    /**
+     * @brief Start listening and contact the seeds
+     * @param error Receives the reason on failure
+     * @return False if the listening socket could not be opened
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief Flush queued URLs, announce the departure and stop the threads
+     */
+    void stop();
+
+    /**
+     * @brief True if this node owns the host of a URL
+     */
+    bool owns(std::string_view url) const;
+
+    /**
+     * @brief Queue a URL for the node owning its host
+     *
+     * URLs forwarded moments ago are dropped; the owner has them already.
+     */
+    void forward(std::string url, int depth);
+
+    /**
+     * @brief True once the whole cluster has run out of work
+     *
+     * Only meaningful when the caller is itself idle.
+     */
+    bool isQuiescent();
+
+    /**
+     * @brief Live members, including this node
+     */
+    std::vector<std::string> getMembers() const;
+
+    Stats getStats() const;
+
+    const std::string& getSelf() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Peer {
+        Clock::time_point lastSeen;
+        bool heardFrom = false;
+        bool left = false;              // Announced its departure
+        bool reportedIdle = false;
+        long long reportedSent = 0;
+        long long reportedReceived = 0;
+    };
+
+    struct Connection {
+        long long socket;
+        std::string buffer;
+    };
+
+    void receiveLoop();
+    void sendLoop();
+    void handleFrame(unsigned char type, const std::string& payload);
+    void handleUrls(const std::string& payload);
+    void handleHeartbeat(const std::string& payload);
+    bool addMemberLocked(const std::string& node);
+    std::string heartbeatPayload(bool idle);
+
+    Options options;
+    UrlHandler onUrl;
+    MembershipHandler onMembershipChange;
+    IdleProbe isLocallyIdle;
+    Monitoring* monitoring;
+
+    mutable std::mutex mutex;               // Guards ring, peers, exchange and the counters below
+    std::condition_variable senderCondition;
+    HashRing ring;
+    UrlExchange exchange;                   // Outgoing URLs by destination
+    std::map<std::string, Peer> peers;      // Live members other than this node
+    std::map<std::string, Clock::time_point> departedAt;   // Not re-added from gossip for a while
+    long long urlsSent;
+    long long urlsReceived;
+    long long batchesSent;
+    long long batchBytesSent;
+    Clock::time_point quiescentSince;
+    bool quiescentCandidate;
+
+    std::atomic<bool> running;
+    long long listenSocket;
+    std::thread receiver;
+    std::thread sender;
+
+    std::atomic<long long> messagesSent;
+    std::atomic<long long> messagesReceived;
+    std::atomic<long long> bytesSent;
+    std::atomic<long long> bytesReceived;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct CrawlRecord
+ * @brief Outcome of one fetch, as exported for analysis
+ */
+struct CrawlRecord {
+    std::string url;
+    std::string host;
+    int depth = 0;
+    int status = 0;                 // HTTP status, 0 if no response arrived
+    std::string contentType;
+    long long bytes = 0;            // Decoded body size
+    long long wireBytes = 0;        // Bytes on the wire, 0 if unknown
+    long long fetchMicros = 0;      // Time in the transfer
+    long long processMicros = 0;    // Time from the end of the transfer to the page being stored
+    long long fetchedAt = 0;        // Unix time in milliseconds
+    uint64_t contentHash = 0;       // ColumnarWriter::hashContent() of the body, 0 if none
+    std::string language;           // LanguageIdentifier code of HTML pages, empty otherwise
+};
+
+/**
+ * @class ColumnarWriter
+ * @brief Writes crawl records to a column-oriented file for analytics
+ *
+ * Records are buffered in row groups, one per writer thread (threads are
+ * spread over a fixed set of slots), and a full row group is encoded and
+ * appended without holding up the other threads. Within a row group each
+ * column is stored on its own: integers as zigzag varints, hashes as
+ * 8-byte words, and strings either plainly or, when few distinct values
+ * repeat (hosts, content types, languages), dictionary-encoded as varint indices.
+ * Column chunks of 256 bytes or more are then gzip-compressed if that makes
+ * them smaller; the rest are stored as is.
+ *
+ * Layout, with all integers varints unless noted:
+ *
+ *     "WCOL" version:u8
+ *     row groups: per column, encoding:u8 compression:u8 rawSize storedSize bytes
+ *     footer: columns (nameLength name type:u8)..., row groups (rows (offset size)...)..., total rows
+ *     footerSize:u32le "WCOL"
+ *
+ * The footer locates every column chunk, so a reader can fetch just the
+ * columns it needs; tools/wcol.py reads the format. The file is complete
+ * only once close() has written the footer. Safe to call from multiple
+ * threads.
+ */
+class ColumnarWriter {
+public:
+    enum class ColumnType : unsigned char {
+        INT64 = 1,
+        STRING = 2,
+        HASH64 = 3
+    };
+
+    struct Column {
+        const char* name;
+        ColumnType type;
+    };
+
+    /**
+     * @brief Create or truncate a results file
+     * @param path Path to the file
+     * @param rowGroupRows Rows buffered per thread before they are written
+     */
+    explicit ColumnarWriter(const std::string& path, size_t rowGroupRows = 8192);
+
+    /**
+     * @brief Destructor, closes the file if still open
+     */
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    /**
+     * @brief True if the file could be opened
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Buffer a record in the calling thread's row group
+     */
+    void append(const CrawlRecord& record);
+
+    /**
+     * @brief Write the buffered rows and the footer
+     * @return False if any write failed
+     */
+    bool close();
+
+    /**
+     * @brief Rows written or buffered so far
+     */
+    long long getRowCount() const;
+
+    /**
+     * @brief Columns of every file, in storage order
+     */
+    static const std::vector<Column>& getSchema();
+
+    /**
+     * @brief Stable 64-bit hash of a body, never 0 for non-empty input
+     */
+    static uint64_t hashContent(std::string_view content);
+
+private:
+    struct RowGroup;
+
+    struct Slot {
+        std::mutex mutex;
+        std::unique_ptr<RowGroup> rows;
+    };
+
+    void writeRowGroup(const RowGroup& rows);
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    size_t rowGroupRows;
+    std::atomic<long long> rowCount;
+
+    mutable std::mutex fileMutex;           // Guards everything below
+    std::ofstream file;
+    uint64_t offset;
+    std::string footerGroups;               // Row group entries of the footer
+    size_t groupCount;
+    long long writtenRows;
+    bool failed;
+    bool closed;
+};
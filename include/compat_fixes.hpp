@@ -12,6 +12,7 @@
 typedef void CURL;
 typedef int CURLcode;
 #define CURLE_OK 0
+#define CURLE_WRITE_ERROR 23
 #define CURLOPT_URL 10000
 #define CURLOPT_WRITEFUNCTION 20000
 #define CURLOPT_WRITEDATA 10001
@@ -20,8 +21,15 @@ typedef int CURLcode;
 #define CURLOPT_USERAGENT 10004
 #define CURLOPT_TIMEOUT 13
 #define CURLOPT_FOLLOWLOCATION 52
+#define CURLOPT_ACCEPT_ENCODING 10102
+#define CURLOPT_HEADERDATA 10029
+#define CURLOPT_HEADERFUNCTION 20079
+#define CURLOPT_RESOLVE 10203
 #define CURLINFO_RESPONSE_CODE 2097154
 #define CURLINFO_CONTENT_TYPE 1048594
+#define CURLINFO_SIZE_DOWNLOAD_T 6291464
+#define CURLINFO_CONTENT_LENGTH_DOWNLOAD_T 6291471
+typedef long curl_off_t;
 
 // Stub declarations for curl functions
 inline CURL* curl_easy_init() { return nullptr; }
@@ -30,6 +38,12 @@ inline CURLcode curl_easy_perform(CURL*) { return CURLE_OK; }
 inline CURLcode curl_easy_getinfo(CURL*, int, ...) { return CURLE_OK; }
 inline void curl_easy_cleanup(CURL*) {}
 inline const char* curl_easy_strerror(CURLcode) { return "No error"; }
+struct curl_slist {
+    char* data;
+    struct curl_slist* next;
+};
+inline curl_slist* curl_slist_append(curl_slist* list, const char*) { return list; }
+inline void curl_slist_free_all(curl_slist*) {}
 #endif
 
 // Fix for missing nlohmann/json.hpp
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @class GzipInflater
+ * @brief Streaming gzip decoder with a fixed-size output window
+ *
+ * Input is fed in arbitrary chunks and decoded output is handed to a
+ * callback in pieces of at most 16 KiB, so memory use does not depend on
+ * the size of the stream. Input that does not start with the gzip magic bytes
+ * is passed through unchanged, which lets callers feed a response
+ * without knowing whether it was compressed. Concatenated gzip members are
+ * decoded back to back.
+ */
+class GzipInflater {
+public:
+    /**
+     * @brief Receives decoded data; return false to stop decoding
+     */
+    using OutputCallback = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @brief Constructor
+     * @param output Callback receiving decoded data
+     */
+    explicit GzipInflater(OutputCallback output);
+
+    /**
+     * @brief Destructor
+     */
+    ~GzipInflater();
+
+    GzipInflater(const GzipInflater&) = delete;
+    GzipInflater& operator=(const GzipInflater&) = delete;
+
+    /**
+     * @brief Decode a chunk of input
+     * @return False on corrupt input or if the callback stopped decoding
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * @brief Signal the end of input
+     * @return False if the compressed stream was truncated
+     */
+    bool finish();
+
+    /**
+     * @brief True once the input was detected as compressed
+     */
+    bool isCompressed() const;
+
+    /**
+     * @brief Description of the last error, empty if none
+     */
+    const std::string& getError() const;
+
+private:
+    enum class Mode {
+        DETECT,
+        PASSTHROUGH,
+        INFLATE,
+        FAILED
+    };
+
+    bool startInflate();
+    bool inflateChunk(const char* data, size_t size);
+
+    OutputCallback output;
+    Mode mode;
+    std::string header;     // First bytes, held until the format is known
+    void* stream;           // z_stream, kept opaque to keep zlib out of this header
+    bool streamEnded;
+    std::string error;
+};
+
+/**
+ * @brief Compress a buffer into a single gzip member
+ * @param data Input bytes
+ * @param size Input size
+ * @param output Receives the gzip stream
+ * @param level zlib compression level (1 = fastest, 9 = smallest)
+ * @return False if compression failed or zlib is not available
+ */
+bool gzipCompress(const char* data, size_t size, std::string& output, int level = 1);
@@ -44,6 +44,9 @@ public:
     bool getFollowRedirects() const;
     int getTimeoutSeconds() const;
     int getRetryCount() const;
+    bool getCompressedTransfer() const;
+    bool getSeedFromSitemaps() const;
+    const std::vector<std::string>& getSitemapUrls() const;
     
     // Thread settings
     int getThreadCount() const;
@@ -56,6 +59,7 @@ public:
     bool getSaveImages() const;
     std::string getImageDirectory() const;
     std::string getContentDirectory() const;
+    std::string getResultsFile() const;
     
     // Filter settings
     const std::vector<std::string>& getAllowedDomains() const;
@@ -71,6 +75,67 @@ public:
     bool getEnableConsoleOutput() const;
     int getStatusUpdateInterval() const;
     
+    // Advanced settings
+    int getMaxFileSizeMB() const;
+    int getDnsResolverThreads() const;
+    int getDnsCacheTtlSeconds() const;
+    int getDnsNegativeTtlSeconds() const;
+    int getRobotsCacheSize() const;
+    int getRobotsFetchThreads() const;
+    bool getDetectDuplicates() const;
+    int getNearDuplicateDistance() const;
+    bool getDetectUrlTraps() const;
+    int getUrlPatternSoftLimit() const;
+    int getUrlPatternHardLimit() const;
+    int getMaxRepeatedSegments() const;
+    std::string getReplayArchive() const;
+    std::string getRecordArchive() const;
+    std::string getFetcher() const;
+    
+    // Synthetic web settings (used by the synthetic fetcher)
+    int getSyntheticPageCount() const;
+    int getSyntheticFanout() const;
+    int getSyntheticPageKB() const;
+    double getSyntheticLatencyMs() const;
+    double getSyntheticLatencyP99Ms() const;
+    double getSyntheticErrorRate() const;
+    double getSyntheticRedirectRate() const;
+    int getSyntheticSeed() const;
+    int getSyntheticHostCount() const;
+    
+    // Cluster settings
+    std::string getClusterNode() const;
+    const std::vector<std::string>& getClusterPeers() const;
+    int getClusterVirtualNodes() const;
+    int getClusterBatchSize() const;
+    int getClusterFlushIntervalMs() const;
+    int getClusterRecentUrls() const;
+    int getClusterHeartbeatIntervalMs() const;
+    int getClusterFailureTimeoutMs() const;
+    
+    // Link graph settings
+    bool getLinkGraphEnabled() const;
+    std::string getLinkRankAlgorithm() const;
+    int getLinkRankIntervalSeconds() const;
+    int getLinkRankIterations() const;
+    double getLinkRankDamping() const;
+    int getLinkRankThreads() const;
+    double getLinkRankWeight() const;
+    
+    // Focused crawl settings
+    std::string getFocusTopic() const;
+    double getFocusAnchorWeight() const;
+    double getFocusMinRelevance() const;
+    
+    // Inference settings
+    std::string getInferenceBackend() const;
+    std::string getPageModel() const;
+    std::string getImageModel() const;
+    int getInferenceBatchSize() const;
+    int getInferenceMaxLatencyMs() const;
+    int getInferenceThreads() const;
+    int getInferenceQueueLimit() const;
+    
 private:
     void parseConfig();
     
@@ -87,6 +152,9 @@ private:
     bool followRedirects = true;
     int timeoutSeconds = 30;
     int retryCount = 3;
+    bool compressedTransfer = true;
+    bool seedFromSitemaps = true;
+    std::vector<std::string> sitemapUrls;
     
     // Thread settings
     int threadCount = 4;
@@ -99,6 +167,7 @@ private:
     bool saveImages = true;
     std::string imageDirectory = "images";
     std::string contentDirectory = "content";
+    std::string resultsFile;       // Columnar export of every fetch; empty disables it
     
     // Filter settings
     std::vector<std::string> allowedDomains;
@@ -113,4 +182,65 @@ private:
     std::string logLevel = "INFO";
     bool enableConsoleOutput = true;
     int statusUpdateInterval = 5;
+    
+    // Advanced settings
+    int maxFileSizeMB = 10;
+    int dnsResolverThreads = 2;
+    int dnsCacheTtlSeconds = 300;
+    int dnsNegativeTtlSeconds = 30;
+    int robotsCacheSize = 1024;
+    int robotsFetchThreads = 2;
+    bool detectDuplicates = true;
+    int nearDuplicateDistance = 3;
+    bool detectUrlTraps = true;
+    int urlPatternSoftLimit = 100;
+    int urlPatternHardLimit = 1000;
+    int maxRepeatedSegments = 3;
+    std::string replayArchive;     // Serve fetches from this WARC file instead of the network
+    std::string recordArchive;     // Append every fetched response to this WARC file
+    std::string fetcher;           // "curl", "replay" or "synthetic"; empty picks from replayArchive
+    
+    // Synthetic web settings
+    int syntheticPageCount = 10000;
+    int syntheticFanout = 10;
+    int syntheticPageKB = 16;
+    double syntheticLatencyMs = 5.0;
+    double syntheticLatencyP99Ms = 50.0;
+    double syntheticErrorRate = 0.01;
+    double syntheticRedirectRate = 0.02;
+    int syntheticSeed = 42;
+    int syntheticHostCount = 1;
+    
+    // Cluster settings
+    std::string clusterNode;                // "host:port" of this node; empty crawls alone
+    std::vector<std::string> clusterPeers;
+    int clusterVirtualNodes = 64;
+    int clusterBatchSize = 256;
+    int clusterFlushIntervalMs = 100;
+    int clusterRecentUrls = 16384;
+    int clusterHeartbeatIntervalMs = 500;
+    int clusterFailureTimeoutMs = 5000;
+    
+    // Link graph settings
+    bool linkGraphEnabled = false;
+    std::string linkRankAlgorithm = "pagerank";     // "pagerank" or "hits"
+    int linkRankIntervalSeconds = 30;
+    int linkRankIterations = 20;
+    double linkRankDamping = 0.85;
+    int linkRankThreads = 0;                        // 0 uses every hardware thread
+    double linkRankWeight = 0.5;
+    
+    // Focused crawl settings
+    std::string focusTopic;                         // Empty crawls without a topic
+    double focusAnchorWeight = 0.5;
+    double focusMinRelevance = 0.0;
+    
+    // Inference settings
+    std::string inferenceBackend;                   // "linear" or "onnx"; empty analyzes inline
+    std::string pageModel;                          // Empty leaves pages unscored
+    std::string imageModel;                         // Empty analyzes images inline
+    int inferenceBatchSize = 32;
+    int inferenceMaxLatencyMs = 20;
+    int inferenceThreads = 1;
+    int inferenceQueueLimit = 256;
 }; 
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "text_normalizer.hpp"
+#include "keyword_matcher.hpp"
+#include "language_identifier.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <limits>
@@ -38,7 +42,8 @@ public:
     bool isSpam(const std::string& content);
     std::vector<std::string> extractEntities(const std::string& content);
 
-    // Model management
+    // Model management; a spam_terms.txt in modelDir (see KeywordMatcher)
+    // replaces the built-in spam terms
     void loadModels(const std::string& modelDir);
     void saveModels(const std::string& modelDir);
 
@@ -49,10 +54,12 @@ private:
     std::unique_ptr<TorchModule> topicModel;
     std::unique_ptr<TorchModule> spamModel;
     std::unique_ptr<TorchModule> entityModel;
+    std::unique_ptr<KeywordMatcher> spamTerms;
 
-    // Text preprocessing
-    std::string preprocessText(const std::string& text);
-    std::vector<float> tokenize(const std::string& text);
+    // Text preprocessing; the result lives in a per-thread buffer and is
+    // valid until the next call on the same thread
+    const std::string& preprocessText(std::string_view text,
+                                      TextNormalizer::Case letterCase = TextNormalizer::Case::LOWER);
     
     // Model inference
     std::string detectLanguage(const std::string& content);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cstddef>
+
+/**
+ * @class ContentTypeStats
+ * @brief Learns which URLs are unlikely to be HTML before they are fetched
+ *
+ * Every response whose headers were inspected is recorded against its file
+ * extension and its host. Once an extension (or, for extensionless URLs, a
+ * host) has been seen often enough and almost never produced HTML, further
+ * URLs matching it are skipped without a request.
+ */
+class ContentTypeStats {
+public:
+    /**
+     * @brief Constructor
+     * @param minSamples Observations needed before a key is trusted
+     * @param rejectRatio Fraction of non-HTML responses at which a key is skipped
+     */
+    ContentTypeStats(size_t minSamples = 8, double rejectRatio = 0.95);
+
+    /**
+     * @brief Record the outcome of a header check
+     * @param url Requested URL
+     * @param isHtml True if the response was HTML
+     */
+    void record(const std::string& url, bool isHtml);
+
+    /**
+     * @brief Predict whether a URL will turn out not to be HTML
+     * @param url URL to check
+     * @return True if fetching the URL is very likely wasted
+     */
+    bool isLikelyNonHtml(const std::string& url) const;
+
+    /**
+     * @brief Check if a MIME type is HTML
+     * @param contentType Value of the Content-Type header
+     */
+    static bool isHtmlContentType(const std::string& contentType);
+
+    /**
+     * @brief Lower-cased file extension of a URL path (without the dot)
+     */
+    static std::string getExtension(const std::string& url);
+
+    /**
+     * @brief Host part of a URL
+     */
+    static std::string getHost(const std::string& url);
+
+private:
+    struct Counts {
+        size_t html = 0;
+        size_t other = 0;
+    };
+
+    bool isRejected(const Counts& counts) const;
+
+    size_t minSamples;
+    double rejectRatio;
+
+    std::unordered_map<std::string, Counts> byExtension;
+    std::unordered_map<std::string, Counts> byHost;
+    mutable std::mutex statsMutex;
+
+    // Extensions that are never HTML; skipped without any learning
+    static const std::unordered_set<std::string> NON_HTML_EXTENSIONS;
+};
@@ -10,9 +10,29 @@
 #include "image_analyzer.hpp"
 #include "content_analyzer.hpp"
 #include "config.hpp"
+#include "html_link_scanner.hpp"
+#include "buffer_pool.hpp"
+#include "content_type_stats.hpp"
+#include "dns_cache.hpp"
+#include "robots_cache.hpp"
+#include "url_frontier.hpp"
+#include "sitemap_parser.hpp"
+#include "near_duplicate_detector.hpp"
+#include "url_trap_detector.hpp"
+#include "page_arena.hpp"
+#include "host_filter.hpp"
+#include "path_filter.hpp"
+#include "response_archive.hpp"
+#include "fetcher.hpp"
+#include "cluster_node.hpp"
+#include "columnar_writer.hpp"
+#include "link_graph.hpp"
+#include "topic_scorer.hpp"
+#include "language_identifier.hpp"
+#include "inference_stage.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
@@ -47,8 +67,23 @@ public:
         int queuedUrls;
         int failedUrls;
         int pendingUrls;
-        int totalBytes;
+        long long totalBytes;
+        long long wireBytes;
         int imagesProcessed;
+        int nearDuplicates;
+        int trappedUrls;
+        long long pageAllocations;  // Heap allocations while processing pages (COUNT_ALLOCATIONS builds)
+        long long arenaOverflows;   // Page arena allocations that spilled to the heap
+        double fetchLatencyP50Ms;   // Median time spent in the HTTP transfer
+        double fetchLatencyP99Ms;
+        long long forwardedUrls;    // Sent to the cluster members owning their hosts
+        long long receivedUrls;     // Forwarded here by other members
+        long long exchangeBytes;    // Wire bytes of the URL batches sent
+        int clusterMembers;         // Live cluster members including this one, 0 when crawling alone
+        long long linkEdges;        // Links recorded in the link graph, 0 when it is off
+        double harvestRate;         // Mean topic relevance of the pages crawled, 0 without a topic
+        long long inferredItems;    // Pages and images scored by the inference stage, 0 without it
+        double meanInferenceBatch;  // Items per model call
         int activeThreads;
     };
     
@@ -110,18 +145,70 @@ public:
      */
     int getProgressPercentage() const;
     
+    /**
+     * @brief Schedule a URL as if it had been found on a page
+     * @param url Absolute URL
+     * @param depth Link depth of the URL
+     */
+    void addUrl(const std::string& url, int depth);
+    
+    /**
+     * @brief Get the number of URLs waiting in the queue
+     * @return Queued URLs
+     */
+    size_t getQueuedCount() const;
+    
+    /**
+     * @brief Forget every URL queued, pending or visited, while no crawl is running
+     */
+    void clearUrls();
+    
 private:
+    using UrlEntry = UrlFrontier::Entry;
+    
+    // Outcome of the checks a URL passes before it is queued
+    enum class Admission {
+        REJECTED,
+        QUEUE,
+        DEFERRED    // Waiting for its host's robots.txt
+    };
+    
     // Internal methods
     void crawlerThread();
-    void scheduleUrl(const std::string& url, int depth);
-    bool processUrl(const std::string& url, int depth);
-    bool downloadPage(const std::string& url, std::string& content);
-    void processImage(const std::string& url, const std::vector<uint8_t>& imageData);
-    bool isImageUrl(const std::string& url);
+    void scheduleUrl(std::string url, int depth, float priority = UrlFrontier::DEFAULT_PRIORITY);
+    void enqueueUrl(std::string url, int depth, float priority = UrlFrontier::DEFAULT_PRIORITY);
+    bool scheduleUrls(std::vector<UrlEntry>& entries);
+    Admission admitUrlLocked(UrlEntry& entry);
+    bool processUrl(const std::string& url, int depth, PageArena& arena);
+    bool downloadPage(const std::string& url, std::string& content, HtmlLinkScanner* scanner = nullptr,
+                      CrawlRecord* record = nullptr, TopicScorer::Counter* relevance = nullptr);
+    void exportResult(CrawlRecord& record, const std::string& url, int depth, std::string_view body,
+                      std::chrono::steady_clock::time_point downloaded);
+    void scheduleDiscoveredRef(const std::string& baseUrl, std::string_view ref,
+                               HtmlLinkScanner::RefKind kind, int depth,
+                               std::pmr::vector<std::pmr::string>* links = nullptr,
+                               float priority = UrlFrontier::DEFAULT_PRIORITY);
+    void storePage(const std::string& url, int depth, std::string content, CrawlRecord& record,
+                   std::chrono::steady_clock::time_point downloaded, const InferenceStage::Result* scores);
+    void processImage(const std::string& url, const std::string& imageData);
+    void storeImage(const std::string& url, const std::string& imageData,
+                    const ImageAnalyzer::ImageFeatures& features);
+    void releaseDeferredUrl(const UrlEntry& entry, bool allowed);
+    bool fetchRobotsTxt(const std::string& url, long& status, std::string& body);
+    void sitemapThread(const std::string& startUrl);
+    bool ingestSitemap(const std::string& sitemapUrl, std::vector<std::string>& childSitemaps);
+    bool isDomainAllowed(std::string_view url);
+    bool isLocallyIdle();
+    void rebalance(const std::string& node, bool joined);
+    void rankThread();
+    void rankLinks();
+    bool isImageUrl(std::string_view url);
     std::string getImageExtension(const std::string& url);
     
     // Configuration
     Config config;
+    HostFilter allowedHosts;    // Compiled from config.getAllowedDomains()
+    PathFilter pathFilter;      // Compiled from the path and extension filters
     
     // State
     std::atomic<CrawlerState> state;
@@ -129,19 +216,18 @@ private:
     std::atomic<int> failedRequests;
     
     // URL tracking
-    struct UrlEntry {
-        std::string url;
-        int depth;
-    };
-    
-    std::queue<UrlEntry> urlQueue;
+    UrlFrontier urlQueue;
     std::set<std::string> visitedUrls;
     std::set<std::string> pendingUrls;
-    std::mutex queueMutex;
+    std::set<std::string> deferredUrls;     // Waiting for their host's robots.txt
+    mutable std::mutex queueMutex;
     std::condition_variable queueCondition;
     
     // Worker threads
     std::vector<std::thread> threads;
+    std::thread sitemapWorker;
+    std::atomic<bool> sitemapLoading;
+    std::thread rankWorker;
     
     // Components
     std::unique_ptr<ThreadPool> threadPool;
@@ -151,11 +237,32 @@ private:
     std::unique_ptr<ImageAnalyzer> imageAnalyzer;
     std::unique_ptr<ContentAnalyzer> contentAnalyzer;
     std::unique_ptr<Monitoring> monitoring;
+    std::unique_ptr<BufferPool> bufferPool;
+    std::unique_ptr<ContentTypeStats> contentTypeStats;
+    std::unique_ptr<DnsCache> dnsCache;
+    std::unique_ptr<NearDuplicateDetector> duplicateDetector;
+    std::unique_ptr<UrlTrapDetector> trapDetector;      // Guarded by queueMutex
+    std::unique_ptr<Fetcher> fetcher;                   // Network, replay archive or synthetic web
+    bool replaying;                                     // fetcher serves a replay archive
+    std::unique_ptr<ResponseArchiveWriter> recordArchive;
+    std::unique_ptr<ColumnarWriter> resultsWriter;      // Set when exporting crawl results
+    std::unique_ptr<LinkGraph> linkGraph;               // Set when ranking the frontier by links
+    std::unique_ptr<TopicScorer> topicScorer;           // Set when crawling towards a topic
+    std::unique_ptr<RobotsCache> robotsCache;   // Declared late: its threads call back into the crawler
+    std::unique_ptr<ClusterNode> cluster;       // Likewise; set when crawling as part of a cluster
+    std::unique_ptr<InferenceStage> inferenceStage;     // Likewise; set when a model scores pages or images
     
     // Statistics
     std::atomic<int> totalPages;
-    std::atomic<int> totalBytes;
+    std::atomic<long long> totalBytes;
+    std::atomic<long long> wireBytes;
     std::atomic<int> imagesProcessed;
+    std::atomic<int> nearDuplicates;
+    std::atomic<int> trappedUrls;
+    std::atomic<long long> pageAllocations;
+    std::atomic<long long> arenaOverflows;
+    std::atomic<long long> scoredPages;
+    std::atomic<long long> relevanceSum;       // Of the scored pages, in millionths
     
     // Helper methods
     std::string vectorToString(const std::vector<std::string>& vec);
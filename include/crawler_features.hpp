@@ -7,12 +7,8 @@
 #include <unordered_set>
 #include <mutex>
 #include <chrono>
-// #include <tinyxml2.h>
-
-// Forward declaration
-namespace tinyxml2 {
-    class XMLDocument;
-}
+#include "robots_rules.hpp"
+#include "sitemap_parser.hpp"
 
 // Forward declaration for CURL
 typedef void CURL;
@@ -20,13 +16,6 @@ typedef int CURLcode;
 
 class CrawlerFeatures {
 public:
-    struct RobotsRule {
-        std::string userAgent;
-        std::vector<std::string> allow;
-        std::vector<std::string> disallow;
-        int crawlDelay;
-    };
-
     struct SitemapEntry {
         std::string url;
         std::chrono::system_clock::time_point lastModified;
@@ -63,7 +52,11 @@ private:
     static const std::vector<std::string> SUPPORTED_CONTENT_TYPES;
     
     // Domain-specific settings
-    std::unordered_map<std::string, std::vector<RobotsRule>> robotsRules;
+    std::unordered_map<std::string, std::shared_ptr<RobotsRules>> robotsRules;  // Compiled for userAgent
+    std::unordered_map<std::string, std::string> robotsText;
+    // Compiled on first use for other agents, by domain and then agent
+    mutable std::unordered_map<std::string, std::unordered_map<std::string, std::shared_ptr<RobotsRules>>> agentRules;
+    mutable std::mutex agentRulesMutex;
     std::unordered_map<std::string, std::vector<SitemapEntry>> sitemaps;
     std::unordered_map<std::string, std::chrono::system_clock::time_point> lastRobotsFetch;
     
@@ -74,7 +67,8 @@ private:
     // Helper functions
     bool fetchRobotsTxt(const std::string& domain);
     bool parseRobotsTxt(const std::string& content, const std::string& domain);
-    bool parseSitemap(const std::string& content);
+    bool parseSitemap(const std::string& content, const std::string& sitemapUrl);
+    static SitemapEntry toSitemapEntry(const SitemapParser::Entry& item);
     std::string extractDomain(const std::string& url) const;
     
     // Cache settings
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "fetcher.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class DnsCache;
+
+/**
+ * @class CurlFetcher
+ * @brief Fetches over the network with one libcurl easy handle per transfer
+ *
+ * When a DnsCache is given, each transfer is pinned to the cached
+ * addresses of its host so libcurl skips resolution, and hosts that failed
+ * to resolve are not contacted at all. Asynchronous fetches are run by a
+ * small pool of worker threads that is started on first use; those not
+ * yet started when the fetcher is destroyed complete with an error.
+ */
+class CurlFetcher final : public Fetcher {
+public:
+    /**
+     * @brief Constructor
+     * @param userAgent User-Agent header
+     * @param dnsCache Shared DNS cache, may be null
+     * @param asyncThreads Worker threads for fetchAsync()
+     */
+    CurlFetcher(const std::string& userAgent, DnsCache* dnsCache, size_t asyncThreads = 4);
+    ~CurlFetcher() override;
+
+    Result fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) override;
+    void fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                    CompletionHandler onComplete) override;
+    const char* getName() const override;
+
+private:
+    struct AsyncFetch {
+        Request request;
+        HeaderHandler onHeaders;
+        BodyHandler onBody;
+        CompletionHandler onComplete;
+    };
+
+    void asyncWorker();
+
+    std::string userAgent;
+    DnsCache* dnsCache;
+    size_t asyncThreads;
+
+    std::vector<std::thread> workers;
+    std::deque<AsyncFetch> pending;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+    bool stopping;
+};
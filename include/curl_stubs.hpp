@@ -15,9 +15,16 @@ typedef long curl_off_t;
 #define CURLOPT_WRITEDATA 3
 #define CURLOPT_XFERINFOFUNCTION 4
 #define CURLOPT_XFERINFODATA 5
+#define CURLOPT_ACCEPT_ENCODING 6
+#define CURLOPT_HEADERDATA 7
+#define CURLOPT_HEADERFUNCTION 8
+#define CURLOPT_RESOLVE 9
 #define CURLE_OK 0
+#define CURLE_WRITE_ERROR 23
 #define CURLINFO_RESPONSE_CODE 100
 #define CURLINFO_CONTENT_TYPE 101
+#define CURLINFO_SIZE_DOWNLOAD_T 102
+#define CURLINFO_CONTENT_LENGTH_DOWNLOAD_T 103
 
 // Forward declarations of CURL functions
 CURL* curl_easy_init();
@@ -27,6 +34,14 @@ CURLcode curl_easy_perform(CURL* handle);
 CURLcode curl_easy_getinfo(CURL* handle, int info, ...);
 const char* curl_easy_strerror(CURLcode code);
 
+// String lists (CURLOPT_RESOLVE)
+struct curl_slist {
+    char* data;
+    struct curl_slist* next;
+};
+struct curl_slist* curl_slist_append(struct curl_slist* list, const char* string);
+void curl_slist_free_all(struct curl_slist* list);
+
 // URL encoding/decoding functions
 char* curl_easy_escape(void* handle, const char* string, int length);
 void curl_free(void* ptr);
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @class DnsCache
+ * @brief Shared host name cache with background resolution
+ *
+ * Hosts are resolved by a small pool of resolver threads, either ahead of
+ * time (prefetch when a URL enters the frontier) or on demand. Successful
+ * lookups are kept for a positive TTL and failures for a shorter negative
+ * TTL, so every fetch of a known host skips the resolver entirely. Results
+ * are handed to libcurl through CURLOPT_RESOLVE.
+ *
+ * getaddrinfo does not expose record TTLs, so the configured TTLs are used
+ * for every entry.
+ */
+class DnsCache {
+public:
+    /**
+     * @brief Constructor
+     * @param resolverThreads Number of background resolver threads
+     * @param positiveTtl How long successful lookups are reused
+     * @param negativeTtl How long failed lookups are remembered
+     * @param maxEntries Maximum number of cached hosts
+     */
+    DnsCache(size_t resolverThreads = 2,
+             std::chrono::seconds positiveTtl = std::chrono::seconds(300),
+             std::chrono::seconds negativeTtl = std::chrono::seconds(30),
+             size_t maxEntries = 10000);
+
+    /**
+     * @brief Destructor, stops the resolver threads
+     */
+    ~DnsCache();
+
+    /**
+     * @brief Start resolving a host in the background if it is not cached
+     * @param host Host name
+     */
+    void prefetch(const std::string& host);
+
+    /**
+     * @brief Look up a host, waiting for the resolver if necessary
+     * @param host Host name
+     * @param addresses Receives the resolved addresses
+     * @param timeoutMs Maximum time to wait for an uncached host
+     * @return True if addresses were found; false on failure or timeout
+     */
+    bool lookup(const std::string& host, std::vector<std::string>& addresses, int timeoutMs);
+
+    /**
+     * @brief Check whether a host is known not to resolve
+     * @param host Host name
+     */
+    bool isNegative(const std::string& host);
+
+    /**
+     * @brief Format an entry for CURLOPT_RESOLVE ("host:port:addr[,addr]")
+     */
+    static std::string formatResolveEntry(const std::string& host, int port,
+                                          const std::vector<std::string>& addresses);
+
+    /**
+     * @brief Split the host and port out of a URL
+     * @param url URL to split
+     * @param host Receives the host name
+     * @param port Receives the port (scheme default if absent)
+     * @return True if the URL has a host
+     */
+    static bool splitHostPort(const std::string& url, std::string& host, int& port);
+
+    // Statistics
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getNegativeHits() const;
+    size_t getSize() const;
+
+private:
+    struct Entry {
+        std::vector<std::string> addresses;
+        std::chrono::steady_clock::time_point expires;
+        bool negative;
+    };
+
+    void resolverThread();
+    void resolve(const std::string& host);
+    void evictLocked(std::chrono::steady_clock::time_point now);
+    bool enqueueLocked(const std::string& host);
+
+    std::chrono::seconds positiveTtl;
+    std::chrono::seconds negativeTtl;
+    size_t maxEntries;
+
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_set<std::string> inFlight;
+    std::deque<std::string> pending;
+
+    mutable std::mutex cacheMutex;
+    std::condition_variable pendingCondition;
+    std::condition_variable resolvedCondition;
+
+    std::vector<std::thread> resolvers;
+    bool stopping;
+
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    std::atomic<size_t> negativeHits;
+};
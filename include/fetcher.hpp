@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+class Config;
+class DnsCache;
+
+/**
+ * @class Fetcher
+ * @brief Source of HTTP responses for the crawler
+ *
+ * A fetch reports the status and headers of the final response once,
+ * through the header handler, before any body bytes are delivered; the
+ * handler decides whether the body is wanted. The body is then streamed,
+ * already decoded, to the body handler. Either handler can abort the
+ * transfer by returning false.
+ *
+ * fetch() blocks the calling thread. fetchAsync() returns immediately and
+ * calls the handlers and then the completion handler on a thread owned by
+ * the fetcher; the default implementation simply runs fetch() inline, which
+ * suits fetchers that never wait. All methods are safe to call from
+ * multiple threads.
+ *
+ * Implementations are selected at runtime by create(): CurlFetcher for the
+ * network, ReplayFetcher for a recorded WARC archive and SyntheticFetcher
+ * for an in-memory synthetic web.
+ */
+class Fetcher {
+public:
+    /**
+     * @struct Request
+     * @brief What to fetch and how
+     */
+    struct Request {
+        std::string url;
+        bool followRedirects = true;
+        long timeoutSeconds = 30;
+        bool compressed = true;         // Ask for a content coding; bodies are always delivered decoded
+    };
+
+    /**
+     * @struct Result
+     * @brief Outcome of a fetch
+     */
+    struct Result {
+        bool completed = false;         // The transfer finished and no handler aborted it
+        long status = 0;                // Status of the final response, 0 if none arrived
+        std::string contentType;
+        long long contentLength = -1;   // Content-Length header, -1 if absent
+        long long wireBytes = 0;        // Body bytes received before content decoding
+        std::string error;              // Transport error; empty if a handler aborted or all went well
+    };
+
+    /**
+     * @brief Receives the final response's status and headers; return false to skip the body
+     */
+    using HeaderHandler = std::function<bool(long status, const std::string& contentType, long long contentLength)>;
+
+    /**
+     * @brief Receives decoded body bytes; return false to abort the transfer
+     */
+    using BodyHandler = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @brief Called once when an asynchronous fetch is over
+     */
+    using CompletionHandler = std::function<void(const Result& result)>;
+
+    virtual ~Fetcher() = default;
+
+    /**
+     * @brief Fetch a URL on the calling thread
+     */
+    virtual Result fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) = 0;
+
+    /**
+     * @brief Start a fetch and return without waiting for it
+     *
+     * onComplete is called exactly once, with an error if the fetcher is
+     * destroyed before the fetch is done. The handlers must stay valid
+     * until then.
+     */
+    virtual void fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                            CompletionHandler onComplete);
+
+    /**
+     * @brief Short name of the implementation, for logs
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Create the fetcher selected by the configuration
+     *
+     * advanced.fetcher picks "curl", "replay" or "synthetic"; when it is
+     * empty, a configured replay archive selects replay and curl is used
+     * otherwise.
+     *
+     * @param config Crawler configuration
+     * @param dnsCache Shared DNS cache for the curl fetcher, may be null
+     * @param error Receives a description of any problem; the returned fetcher is still usable
+     * @return Never null
+     */
+    static std::unique_ptr<Fetcher> create(const Config& config, DnsCache* dnsCache, std::string& error);
+};
@@ -42,6 +42,7 @@ public:
 
     // Image operations
     bool saveImage(const std::string& url, const std::vector<uint8_t>& data, const std::string& extension);
+    bool saveImage(const std::string& url, const uint8_t* data, size_t size, const std::string& extension);
 
 private:
     // Base directory for storage
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+/**
+ * @brief 64-bit FNV-1a, the base of the repo's URL, content and key hashes
+ *
+ * Callers that need well-spread bits (ring positions, fingerprints) apply
+ * their own finalizer on top.
+ */
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+inline uint64_t fnvStep(uint64_t hash, unsigned char byte) {
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+inline uint64_t fnv1a(std::string_view data) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (char c : data) {
+        hash = fnvStep(hash, static_cast<unsigned char>(c));
+    }
+    return hash;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class HashRing
+ * @brief Consistent-hash ring mapping keys (host names) to cluster nodes
+ *
+ * Each node is placed on the ring at a number of pseudo-random points,
+ * its virtual nodes, and a key belongs to the node owning the first point
+ * at or after the key's hash. Adding or removing a node therefore only
+ * moves the keys adjacent to that node's points, about 1/N of them, and
+ * the virtual nodes keep the shares of N nodes within a few percent of
+ * each other. Keys are hashed case-insensitively.
+ *
+ * Not thread-safe: the owner guards it.
+ */
+class HashRing {
+public:
+    /**
+     * @brief Constructor
+     * @param virtualNodes Points per node on the ring
+     */
+    explicit HashRing(size_t virtualNodes = 64);
+
+    /**
+     * @brief Add a node
+     * @return False if it was already on the ring
+     */
+    bool addNode(const std::string& node);
+
+    /**
+     * @brief Remove a node
+     * @return False if it was not on the ring
+     */
+    bool removeNode(const std::string& node);
+
+    bool hasNode(const std::string& node) const;
+
+    /**
+     * @brief Node owning a key
+     * @return Node name, or an empty string if the ring is empty
+     */
+    const std::string& ownerOf(std::string_view key) const;
+
+    /**
+     * @brief Nodes on the ring, in the order they were added
+     */
+    const std::vector<std::string>& getNodes() const;
+
+    size_t size() const;
+    bool empty() const;
+
+private:
+    struct Point {
+        uint64_t hash;
+        uint32_t node;      // Index into nodes
+    };
+
+    static uint64_t hashKey(std::string_view key);
+    void rebuild();
+
+    size_t virtualNodes;
+    std::vector<std::string> nodes;
+    std::vector<Point> points;          // Sorted by hash
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class HostFilter
+ * @brief Compiled allow-list of domains, checked in time linear in the host length
+ *
+ * Domains are stored in a trie keyed by labels from right to left
+ * ("www.example.com" is com -> example -> www), so a lookup walks the
+ * host's labels once no matter how many domains are allowed. An entry
+ * admits the domain itself and every subdomain, except when the entry is a
+ * public suffix ("com", "co.uk", "github.io"): those only admit the exact
+ * host, so a stray entry cannot open up a whole registry. A leading "*."
+ * forces subdomain matching for such entries.
+ *
+ * Built once and then read concurrently without locking.
+ */
+class HostFilter {
+public:
+    HostFilter();
+    explicit HostFilter(const std::vector<std::string>& domains);
+
+    /**
+     * @brief Add a domain to the allow-list
+     */
+    void add(const std::string& domain);
+
+    /**
+     * @brief Check a host against the allow-list
+     * @param host Host name, optionally with a port; case-insensitive
+     * @return True if allowed, or if the list is empty
+     */
+    bool matches(std::string_view host) const;
+
+    /**
+     * @brief Check the host part of an absolute URL
+     */
+    bool matchesUrl(std::string_view url) const;
+
+    bool empty() const;
+    size_t size() const;
+
+    /**
+     * @brief Whether a domain is a public suffix (a TLD or a shared
+     *        registry such as "co.uk" or "github.io")
+     */
+    static bool isPublicSuffix(std::string_view domain);
+
+    /**
+     * @brief The registrable part of a host: its public suffix plus one label
+     * @return View into host, or the whole host if it is itself a suffix
+     */
+    static std::string_view registrableDomain(std::string_view host);
+
+    /**
+     * @brief Host part of an absolute URL, without port
+     */
+    static std::string_view hostOf(std::string_view url);
+
+private:
+    struct Node {
+        std::string label;
+        uint32_t parent = 0;
+        bool subdomains = false;    // Entry admits this domain and everything below it
+        bool exact = false;         // Entry admits only this domain
+    };
+
+    // Child lookup: hash of (parent, label) -> node index. Colliding keys
+    // probe the following key values.
+    uint32_t findChild(uint32_t parent, std::string_view label) const;
+    uint32_t addChild(uint32_t parent, std::string_view label);
+    static uint64_t edgeKey(uint32_t parent, std::string_view label);
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, uint32_t> edges;
+    size_t entries;
+};
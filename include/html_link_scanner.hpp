@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @class HtmlLinkScanner
+ * @brief Incremental extractor for <a href> and <img src> references
+ *
+ * The scanner is fed the response body chunk by chunk as it arrives and
+ * reports each reference as soon as its tag is complete. Tags split across
+ * chunk boundaries are carried over in a small internal buffer, so the body
+ * itself never has to be buffered by the scanner.
+ *
+ * Optionally the text of each link (including the alt text of images in
+ * it) is collected too; links are then reported once their </a> arrives.
+ */
+class HtmlLinkScanner {
+public:
+    enum class RefKind {
+        LINK,
+        IMAGE
+    };
+
+    // anchorText is empty for images and when it is not collected
+    using RefCallback = std::function<void(const std::string& ref, RefKind kind, const std::string& anchorText)>;
+
+    /**
+     * @brief Constructor
+     * @param callback Invoked for every href/src value found
+     * @param collectAnchorText Pass each link's text to the callback
+     */
+    explicit HtmlLinkScanner(RefCallback callback, bool collectAnchorText = false);
+
+    /**
+     * @brief Feed the next chunk of the body
+     * @param data Chunk data
+     * @param size Chunk size in bytes
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * @brief Signal end of input, report a link still open and drop any incomplete trailing tag
+     */
+    void finish();
+
+    /**
+     * @brief Reset the scanner so it can be reused for another document
+     */
+    void reset();
+
+    /**
+     * @brief Number of references reported since the last reset
+     */
+    size_t getRefCount() const;
+
+private:
+    void processTag();
+    bool extractAttribute(const char* name, std::string& value) const;
+    void appendAnchorText(const char* data, size_t size);
+    void reportAnchor();
+
+    RefCallback callback;
+    bool collectAnchorText;
+    bool anchorOpen;            // A link's href waits for its closing tag
+    std::string anchorRef;
+    std::string anchorText;
+
+    // Tag currently being accumulated (between '<' and '>')
+    std::string tagBuffer;
+    std::string attrValue;
+    bool inTag;
+    char quote;
+    bool overflow;
+    size_t refCount;
+
+    // Tags longer than this are skipped rather than buffered
+    static constexpr size_t MAX_TAG_LENGTH = 8192;
+    
+    // Link text beyond this is dropped
+    static constexpr size_t MAX_ANCHOR_TEXT_LENGTH = 256;
+};
@@ -36,6 +36,7 @@ public:
     // Image analysis
     ImageFeatures analyzeImage(const std::string& imagePath);
     ImageFeatures analyzeImageData(const std::vector<uint8_t>& imageData);
+    ImageFeatures analyzeImageData(const uint8_t* data, size_t size);
     std::string generateDescription(const ImageFeatures& features);
     bool isNSFW(const std::string& imagePath);
     std::vector<std::string> detectObjects(const std::string& imagePath);
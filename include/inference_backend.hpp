@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @class InferenceBackend
+ * @brief Runs a model over a batch of feature vectors on the CPU
+ *
+ * A model maps a vector of getInputSize() floats to one score per label.
+ * run() takes a whole batch at once, row after row, so that a backend can
+ * stream its weights through the cache once per batch rather than once
+ * per item; that is where batching pays off on a CPU. run() may be called
+ * from several threads at once.
+ *
+ * Implementations are selected at runtime by create(): LinearBackend, built
+ * in, and OnnxBackend when the crawler is built WITH_ONNXRUNTIME.
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    /**
+     * @brief Floats per input row
+     */
+    virtual size_t getInputSize() const = 0;
+
+    /**
+     * @brief Names of the scores in each output row, in order
+     */
+    virtual const std::vector<std::string>& getLabels() const = 0;
+
+    /**
+     * @brief Score a batch
+     * @param inputs rows * getInputSize() floats
+     * @param rows Items in the batch
+     * @param outputs Receives rows * getLabels().size() scores
+     * @param error Receives a description of the failure
+     * @return False if the batch could not be scored
+     */
+    virtual bool run(const float* inputs, size_t rows, float* outputs, std::string& error) const = 0;
+
+    /**
+     * @brief Short name of the implementation, for logs
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Load a model with the named backend
+     * @param name "linear" or "onnx"
+     * @param modelPath Model file
+     * @param error Receives a description of any problem
+     * @return Null if the model could not be loaded
+     */
+    static std::unique_ptr<InferenceBackend> create(const std::string& name, const std::string& modelPath,
+                                                    std::string& error);
+};
+
+/**
+ * @class LinearBackend
+ * @brief Built-in multi-label linear model: a sigmoid of a weighted sum per label
+ *
+ * Model files are text. Blank lines and lines starting with '#' are
+ * skipped; the first other line holds the input size, and every line
+ * after it one label: its name, its bias, then one weight per input, all
+ * separated by whitespace.
+ *
+ * Weights are stored label by label, and each label's row is applied to
+ * every item of a batch before moving on to the next label, so a model
+ * larger than the cache is read from memory once per batch.
+ */
+class LinearBackend : public InferenceBackend {
+public:
+    /**
+     * @brief Load a model file
+     */
+    explicit LinearBackend(const std::string& modelPath);
+
+    /**
+     * @brief Use the given weights, labels.size() rows of inputSize each
+     */
+    LinearBackend(size_t inputSize, std::vector<std::string> labels, std::vector<float> weights,
+                  std::vector<float> biases);
+
+    /**
+     * @brief True if the model was loaded; getError() says why not otherwise
+     */
+    bool isLoaded() const;
+    const std::string& getError() const;
+
+    size_t getInputSize() const override;
+    const std::vector<std::string>& getLabels() const override;
+    bool run(const float* inputs, size_t rows, float* outputs, std::string& error) const override;
+    const char* getName() const override;
+
+private:
+    bool load(const std::string& modelPath);
+
+    size_t inputSize;
+    std::vector<std::string> labels;
+    std::vector<float> weights;         // Row per label
+    std::vector<float> biases;
+    std::string error;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "inference_backend.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @class InferenceStage
+ * @brief Scores pages and images with a model on worker threads of its own, in micro-batches
+ *
+ * Crawl threads submit() a downloaded body and return to fetching at once.
+ * Workers collect submissions of the same kind into batches and start a
+ * batch as soon as it is full, or once its oldest item has waited the
+ * maximum latency, so a trickle of items is never held back for long.
+ * Each item is turned into a feature vector, the batch is scored with one
+ * call to the kind's backend, and each item's completion is called on the
+ * worker with the body handed back and the scores, to store the result.
+ *
+ * Pages are described by hashed counts of their normalized words (see
+ * TextNormalizer), and images, which are not decoded, by their format,
+ * size and byte histogram. Either way the vector is scaled to unit length.
+ *
+ * submit() blocks while the queue is at its limit, so the crawl cannot run
+ * ahead of analysis without bound. Every submitted item is completed, also
+ * when the stage is destroyed. Safe to call from multiple threads.
+ */
+class InferenceStage {
+public:
+    enum class Kind {
+        PAGE,
+        IMAGE
+    };
+
+    struct Result {
+        bool scored = false;                            // False if the backend failed
+        const std::vector<std::string>* labels = nullptr;   // The model's labels, null if not scored
+        std::vector<float> scores;                      // One per label
+        std::string error;
+    };
+
+    /**
+     * @brief Receives the body submitted and what the model made of it
+     */
+    using Completion = std::function<void(std::string body, const Result& result)>;
+
+    struct Options {
+        size_t batchSize = 32;
+        std::chrono::milliseconds maxLatency{20};       // Longest an item waits for its batch to fill
+        size_t threads = 1;
+        size_t queueLimit = 256;                        // Items waiting before submit() blocks
+    };
+
+    struct Stats {
+        long long items = 0;
+        long long batches = 0;
+        long long failedBatches = 0;
+        long long queueMicros = 0;      // Summed over items, from submit() to the start of their batch
+        long long runMicros = 0;        // Summed over batches, featurizing and scoring
+    };
+
+    /**
+     * @brief Start the workers
+     * @param pageModel Scores pages, may be null
+     * @param imageModel Scores images, may be null
+     */
+    InferenceStage(const Options& options, std::unique_ptr<InferenceBackend> pageModel,
+                   std::unique_ptr<InferenceBackend> imageModel);
+
+    /**
+     * @brief Destructor, completes every submitted item
+     */
+    ~InferenceStage();
+
+    InferenceStage(const InferenceStage&) = delete;
+    InferenceStage& operator=(const InferenceStage&) = delete;
+
+    /**
+     * @brief True if there is a model for this kind of item
+     */
+    bool accepts(Kind kind) const;
+
+    /**
+     * @brief Queue a body for scoring; the kind must be accepted
+     */
+    void submit(Kind kind, std::string body, Completion done);
+
+    /**
+     * @brief Wait until every item submitted so far has been completed
+     */
+    void drain();
+
+    bool isIdle() const;
+
+    Stats getStats() const;
+
+    /**
+     * @brief Features of a page, size floats of hashed word counts
+     */
+    static void pageFeatures(std::string_view body, float* features, size_t size);
+
+    // Image features used: format (JPEG, PNG, GIF, WebP, BMP, SVG, other),
+    // log2 of the size over 32, then the share of bytes in each sixteenth of
+    // the byte range. Larger inputs are zero beyond these.
+    static constexpr size_t IMAGE_FEATURES = 24;
+
+    /**
+     * @brief Features of an undecoded image, the first IMAGE_FEATURES of size floats
+     */
+    static void imageFeatures(std::string_view data, float* features, size_t size);
+
+private:
+    struct Item {
+        std::string body;
+        Completion done;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void workerLoop();
+    int nextBatchLocked(std::chrono::steady_clock::time_point now,
+                        std::chrono::steady_clock::time_point& wakeAt) const;
+    void runBatch(Kind kind, std::vector<Item>& batch, std::vector<float>& inputs, std::vector<float>& outputs,
+                  bool& scored);
+
+    Options options;
+    std::unique_ptr<InferenceBackend> models[2];        // By kind
+
+    mutable std::mutex mutex;
+    std::condition_variable workCondition;      // Items arrived, or stopping
+    std::condition_variable spaceCondition;     // The queue dropped below its limit
+    std::condition_variable idleCondition;      // Nothing queued or running
+    std::deque<Item> queues[2];                 // By kind
+    size_t queued;
+    size_t running;                             // Items in batches being scored
+    bool stopping;
+    Stats stats;
+
+    std::vector<std::thread> workers;
+};
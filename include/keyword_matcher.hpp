@@ -0,0 +1,72 @@
+#pragma once
+
+#include "aho_corasick.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class KeywordMatcher
+ * @brief Counts occurrences of a weighted list of terms in a page, for spam and keyword scoring
+ *
+ * Terms and pages are both reduced by TextNormalizer (lowercase, no tags,
+ * punctuation and whitespace runs as single spaces), so "Free  money!"
+ * matches "free money" across markup and line breaks. All terms are
+ * compiled into one Aho-Corasick automaton and the page is scanned once,
+ * so the cost grows with the page size and the number of hits, not with
+ * the number of terms. Terms match anywhere, including inside longer words.
+ *
+ * Term files hold one term per line, optionally followed by a tab and a
+ * weight (default 1). Blank lines and lines starting with '#' are skipped.
+ *
+ * add() or load() every term, then build(); the built matcher is read-only
+ * and may be shared between threads.
+ */
+class KeywordMatcher {
+public:
+    struct Term {
+        std::string text;       // Normalized
+        float weight;
+    };
+
+    struct Matches {
+        std::vector<uint32_t> counts;   // Hits by term index
+        uint32_t total = 0;             // Hits of all terms
+        double score = 0.0;             // Sum of weight times hits
+    };
+
+    /**
+     * @brief Add a term; terms that normalize to nothing are ignored
+     */
+    void add(std::string_view term, float weight = 1.0f);
+
+    /**
+     * @brief Add every term listed in a file
+     * @return False if the file could not be read
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Compile the terms; must be called after the last add()
+     */
+    void build();
+
+    /**
+     * @brief Count the terms in a page (HTML or text)
+     */
+    void match(std::string_view body, Matches& matches) const;
+
+    /**
+     * @brief Weighted hits in a page, as Matches::score
+     */
+    double score(std::string_view body) const;
+
+    const std::vector<Term>& getTerms() const;
+    bool empty() const;
+
+private:
+    std::vector<Term> terms;
+    AhoCorasick automaton;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LanguageIdentifier
+ * @brief Identifies the language of a page from character trigrams, as the body streams in
+ *
+ * Text outside markup, scripts and styles is folded to lowercase letters
+ * (Latin-1 letters stay distinct, other letters share one symbol) with
+ * single spaces between words, and every trigram of " word " is looked up
+ * in an embedded table. Each entry holds a one-byte log-probability per
+ * Latin-script language, derived from the trigram's rank in that
+ * language's profile, and the language with the highest total wins. Pages
+ * mostly written in another script are assigned by script: Cyrillic as
+ * "ru", Greek, Hebrew, Arabic, Devanagari, Hangul, Japanese kana, and
+ * Chinese ideographs.
+ *
+ * Scanning stops once one language leads the next by a clear margin, or
+ * after a set amount of text, so long pages cost no more than their first
+ * few KB. Not thread-safe; use one per document. The table itself is
+ * shared and read-only.
+ */
+class LanguageIdentifier {
+public:
+    struct Result {
+        const char* language;       // ISO 639-1 code, or UNKNOWN
+        double confidence;          // 0 to 1: the winner's lead over the runner-up relative to its
+                                    // score, or the script's share of the letters
+    };
+
+    static constexpr const char* UNKNOWN = "und";
+
+    // Text examined by default before giving up on an early decision
+    static constexpr size_t DEFAULT_MAX_TEXT_BYTES = 4096;
+
+    explicit LanguageIdentifier(size_t maxTextBytes = DEFAULT_MAX_TEXT_BYTES);
+
+    /**
+     * @brief Feed the next chunk of the body
+     * @return False once the language is decided; further input is ignored
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * @brief Language of everything fed so far
+     */
+    Result finish() const;
+
+    void reset();
+
+    /**
+     * @brief Identify the language of a whole document
+     */
+    static Result identify(std::string_view text, size_t maxTextBytes = DEFAULT_MAX_TEXT_BYTES);
+
+    /**
+     * @brief Codes of the languages told apart by trigrams
+     */
+    static std::vector<std::string> getLanguages();
+
+private:
+    enum Script {
+        LATIN,
+        CYRILLIC,
+        GREEK,
+        HEBREW,
+        ARABIC,
+        DEVANAGARI,
+        HANGUL,
+        KANA,
+        HAN,
+        SCRIPT_COUNT
+    };
+
+    void addChar(unsigned char c);
+    void endTag();
+    bool decided() const;
+    void getScores(uint32_t* totals) const;
+
+    size_t maxTextBytes;
+    size_t textBytes;
+    bool done;
+
+    // Markup state
+    bool inTag;
+    bool inRawText;             // Inside <script> or <style>
+    char tagName[8];
+    size_t tagLength;
+    bool tagNameDone;
+    int entityLength;           // Characters since '&', or -1 outside a character reference
+
+    // UTF-8 decoding
+    unsigned char lead;         // Lead byte of the sequence in progress, 0 if none
+    unsigned char second;       // Its second byte, for three-byte sequences
+    int pending;                // Continuation bytes still expected
+
+    // Trigram state: the last two characters, 0 before the first
+    uint32_t history;
+    size_t trigrams;
+    uint32_t scores[8];         // By language, up to the last flush of the lanes below
+    uint64_t lanes[2];          // Recent scores in 16-bit lanes: even languages, then odd ones
+    uint32_t laneHits;          // Trigrams added to the lanes since the last flush
+    uint32_t scriptCounts[SCRIPT_COUNT];
+};
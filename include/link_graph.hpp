@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LinkGraph
+ * @brief Compressed store of the links between crawled pages, with link analysis
+ *
+ * Every URL seen as a page or a link target is given a dense UrlId in the
+ * order it is first seen. A page's out-links are stored as sorted, distinct
+ * UrlIds, delta-gap encoded as in WebGraph: the first target as a zigzag
+ * varint relative to the page's own id, every further target as a varint
+ * of the gap to the previous one minus one. Links found together tend to
+ * have been interned together, so most gaps fit in a byte.
+ *
+ * rank() runs PageRank (or HITS authority) over a snapshot of the graph on
+ * several threads and keeps a log-scaled score in [0, 1] per URL, which
+ * getRank() returns; URLs not yet linked from any crawled page score 0.
+ * Safe to call from multiple threads; adding pages only waits for rank()
+ * while it copies the adjacency data.
+ */
+class LinkGraph {
+public:
+    using UrlId = uint32_t;
+
+    static constexpr UrlId NO_ID = UINT32_MAX;
+
+    enum class Algorithm {
+        PAGERANK,
+        HITS            // Scores are authorities
+    };
+
+    struct RankOptions {
+        Algorithm algorithm = Algorithm::PAGERANK;
+        size_t threads = 0;             // 0 uses one per hardware thread
+        int maxIterations = 20;
+        double damping = 0.85;          // PageRank only
+        double tolerance = 1e-6;        // Stop once scores change less than this in total (L1)
+    };
+
+    struct RankResult {
+        size_t urls = 0;
+        size_t edges = 0;
+        int iterations = 0;
+        double delta = 0.0;             // L1 change in the last iteration
+    };
+
+    struct Stats {
+        size_t urls = 0;
+        size_t pages = 0;               // URLs whose links were added
+        size_t edges = 0;
+        size_t adjacencyBytes = 0;      // Encoded out-links
+    };
+
+    LinkGraph();
+
+    LinkGraph(const LinkGraph&) = delete;
+    LinkGraph& operator=(const LinkGraph&) = delete;
+
+    /**
+     * @brief Id of a URL, assigning the next one if it is new
+     */
+    UrlId intern(std::string_view url);
+
+    /**
+     * @brief Id of a URL, or NO_ID if it was never seen
+     */
+    UrlId find(std::string_view url) const;
+
+    /**
+     * @brief URL of an id, empty if out of range
+     */
+    std::string getUrl(UrlId id) const;
+
+    /**
+     * @brief Record the links found on a page, replacing any recorded before
+     *
+     * Self-links and repeated links are dropped.
+     */
+    void addPage(std::string_view url, const std::pmr::vector<std::pmr::string>& links);
+
+    /**
+     * @brief Decode the out-links of a page, in id order
+     */
+    void getLinks(UrlId page, std::vector<UrlId>& links) const;
+
+    /**
+     * @brief Score every URL from the current links
+     */
+    RankResult rank(const RankOptions& options);
+
+    /**
+     * @brief Score of a URL from the last rank(), in [0, 1]
+     */
+    float getRank(std::string_view url) const;
+
+    Stats getStats() const;
+
+    /**
+     * @brief Forget every URL, link and score
+     */
+    void clear();
+
+    /**
+     * @brief Encode out-links; targets are sorted and deduplicated in place
+     */
+    static void encodeLinks(UrlId source, std::vector<UrlId>& targets, std::string& out);
+
+    /**
+     * @brief Decode count out-links of source, appending them to targets
+     * @return False if the data is truncated or out of range
+     */
+    static bool decodeLinks(UrlId source, std::string_view data, size_t count, std::vector<UrlId>& targets);
+
+private:
+    // Where a page's out-links sit in the adjacency data
+    struct Span {
+        uint64_t offset = UINT64_MAX;   // UINT64_MAX if the page was never added
+        uint32_t size = 0;              // Bytes
+        uint32_t count = 0;             // Links
+    };
+
+    UrlId internLocked(std::string_view url);
+
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> urls;                           // By id; a deque so the map's keys stay valid
+    std::unordered_map<std::string_view, UrlId> ids;
+    std::vector<Span> spans;                                // By id, as far as the highest page
+    std::string adjacency;
+    size_t pageCount;
+    size_t edgeCount;
+    std::vector<float> ranks;                               // By id, from the last rank()
+};
@@ -8,6 +8,7 @@
 #include <chrono>
 #include <fstream>
 #include <memory>
+#include <cstdint>
 
 /**
  * @class Monitoring
@@ -119,6 +120,52 @@ public:
      */
     double getAverageOperationTime(const std::string& operationName) const;
 
+    /**
+     * @brief Record one sample of a latency distribution
+     * @param name Name of the distribution
+     * @param latency Observed latency
+     */
+    void recordLatency(const std::string& name, std::chrono::duration<double> latency);
+
+    /**
+     * @brief Get a percentile of a latency distribution
+     *
+     * Samples are kept in logarithmic buckets (eight per doubling), so the
+     * result is accurate to within about 9%.
+     *
+     * @param name Name of the distribution
+     * @param percentile Percentile between 0 and 100
+     * @return Latency in seconds, or 0 if nothing was recorded
+     */
+    double getLatencyPercentile(const std::string& name, double percentile) const;
+
+    /**
+     * @brief Add to a named counter, creating it at zero
+     * @param name Name of the counter
+     * @param delta Amount to add
+     */
+    void addCounter(const std::string& name, long long delta);
+
+    /**
+     * @brief Get the value of a named counter
+     * @param name Name of the counter
+     * @return Current value, or 0 if it was never added to
+     */
+    long long getCounter(const std::string& name) const;
+
+    /**
+     * @brief Enable or disable echoing log lines to stdout
+     * @param enabled Whether to write to the console
+     */
+    void setConsoleOutput(bool enabled);
+
+    /**
+     * @brief Parse a log level name as used in the configuration file
+     * @param name Level name (DEBUG, INFO, WARNING, ERROR, CRITICAL)
+     * @return Parsed level, INFO if the name is not recognized
+     */
+    static LogLevel parseLogLevel(const std::string& name);
+
 private:
     /**
      * @brief Convert log level to string
@@ -128,13 +175,18 @@ private:
     std::string logLevelToString(LogLevel level) const;
 
     LogLevel currentLogLevel;
+    bool consoleOutput;
     std::string logFilePath;
     std::ofstream logFile;
     
     Metrics metrics;
     std::map<std::string, ProfilingData> profilingData;
+    std::map<std::string, std::vector<uint64_t>> latencyHistograms;
+    std::map<std::string, long long> counters;
     
     mutable std::mutex metricsMutex;
     mutable std::mutex profilingMutex;
     mutable std::mutex logMutex;
+    mutable std::mutex latencyMutex;
+    mutable std::mutex counterMutex;
 };
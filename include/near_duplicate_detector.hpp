@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class NearDuplicateDetector
+ * @brief Finds pages whose text is nearly identical to a page already seen
+ *
+ * Each page is reduced to a 64-bit SimHash over overlapping word shingles
+ * of its visible text, so mirrors and templated copies that differ only in
+ * session IDs, sort order or boilerplate land within a few bits of each
+ * other. Fingerprints are indexed in four tables, one per 16-bit block:
+ * two fingerprints within three bits of each other share at least one
+ * block exactly, so a lookup only compares against that block's bucket
+ * instead of every stored page.
+ */
+class NearDuplicateDetector {
+public:
+    /**
+     * @brief Constructor
+     * @param maxDistance Largest Hamming distance treated as a duplicate (at most 3)
+     * @param maxFingerprints Fingerprints kept before new pages stop being indexed
+     */
+    NearDuplicateDetector(int maxDistance = 3, size_t maxFingerprints = 1000000);
+
+    /**
+     * @brief Compute the SimHash of an HTML page's visible text
+     * @param html Page content
+     * @return Fingerprint, or 0 if the page has too little text
+     */
+    static uint64_t fingerprint(const std::string& html);
+
+    /**
+     * @brief Look up a fingerprint and index it if it is new
+     * @param fingerprint Page fingerprint
+     * @param url Page URL, remembered for reporting
+     * @param duplicateOf Receives the URL of the matching page
+     * @return True if a near-duplicate was already indexed
+     */
+    bool checkAndInsert(uint64_t fingerprint, const std::string& url, std::string& duplicateOf);
+
+    /**
+     * @brief Number of bits that differ between two fingerprints
+     */
+    static int distance(uint64_t a, uint64_t b);
+
+    // Statistics
+    size_t getSize() const;
+    size_t getDuplicates() const;
+
+private:
+    static const int BLOCKS = 4;
+
+    int maxDistance;
+    size_t maxFingerprints;
+
+    // Block value -> indices into fingerprints
+    std::unordered_map<uint16_t, std::vector<uint32_t>> tables[BLOCKS];
+    std::vector<uint64_t> fingerprints;
+    std::vector<std::string> urls;
+    size_t duplicates;
+
+    mutable std::mutex indexMutex;
+};
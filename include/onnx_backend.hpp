@@ -0,0 +1,48 @@
+#pragma once
+
+#include "inference_backend.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Ort {
+struct Env;
+struct Session;
+}
+
+/**
+ * @class OnnxBackend
+ * @brief Runs an ONNX model with ONNX Runtime on the CPU
+ *
+ * The model must take one float tensor of shape [batch, inputs] and give
+ * one float tensor of shape [batch, labels]; the batch dimension may be
+ * dynamic, the others must be fixed. Outputs are passed on as they are, so
+ * a model that should give probabilities ends in its own sigmoid or
+ * softmax. Label names are read from "<model>.labels", one per line, and
+ * are the output indices if that file does not exist.
+ *
+ * Each run uses one thread; the inference stage runs batches in parallel.
+ * Only built WITH_ONNXRUNTIME.
+ */
+class OnnxBackend : public InferenceBackend {
+public:
+    explicit OnnxBackend(const std::string& modelPath);
+    ~OnnxBackend() override;
+
+    bool isLoaded() const;
+    const std::string& getError() const;
+
+    size_t getInputSize() const override;
+    const std::vector<std::string>& getLabels() const override;
+    bool run(const float* inputs, size_t rows, float* outputs, std::string& error) const override;
+    const char* getName() const override;
+
+private:
+    std::unique_ptr<Ort::Env> env;
+    std::unique_ptr<Ort::Session> session;
+    std::string inputName;
+    std::string outputName;
+    size_t inputSize;
+    std::vector<std::string> labels;
+    std::string error;
+};
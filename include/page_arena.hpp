@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory_resource>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class CountingResource
+ * @brief Memory resource that forwards to another and counts what passes through
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    // Statistics
+    size_t getAllocations() const;
+    size_t getBytes() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::pmr::memory_resource* upstream;
+    std::atomic<size_t> allocations;
+    std::atomic<size_t> bytes;
+};
+
+/**
+ * @class PageArena
+ * @brief Per-worker bump allocator for data that lives only while one page is processed
+ *
+ * Allocations are carved out of a block owned by the arena and freed all at
+ * once by reset(), which rewinds to the start of the same block. Only pages
+ * that outgrow the block reach the heap; those overflow allocations are
+ * counted so the block size can be tuned. Not thread-safe: each worker owns
+ * its own arena.
+ */
+class PageArena {
+public:
+    /**
+     * @brief Constructor
+     * @param blockSize Bytes reserved once and reused for every page
+     */
+    explicit PageArena(size_t blockSize = 64 * 1024);
+
+    PageArena(const PageArena&) = delete;
+    PageArena& operator=(const PageArena&) = delete;
+
+    /**
+     * @brief Resource for pmr containers scoped to the current page
+     */
+    std::pmr::memory_resource* resource();
+
+    /**
+     * @brief Free everything allocated since the last reset
+     */
+    void reset();
+
+    // Statistics
+    size_t getOverflowAllocations() const;
+    size_t getOverflowBytes() const;
+
+private:
+    std::unique_ptr<std::byte[]> block;
+    size_t blockSize;
+    CountingResource overflow;
+    std::pmr::monotonic_buffer_resource arena;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "aho_corasick.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class GlobSet
+ * @brief Matches a path against many glob patterns at once
+ *
+ * '*' matches any run of characters other than '/' and '**' matches
+ * across slashes; every other character, '?' included, matches itself.
+ * Each glob must match the whole path. All globs are compiled into a
+ * single DFA, so a path is checked in one pass; the result is the union
+ * of the masks of every glob that matched. Sets whose DFA would grow past a fixed size
+ * fall back to simulating the patterns directly.
+ */
+class GlobSet {
+public:
+    GlobSet();
+
+    /**
+     * @brief Add a glob
+     * @param glob Pattern
+     * @param mask Bits reported when the glob matches
+     */
+    void add(std::string_view glob, uint32_t mask);
+
+    /**
+     * @brief Compile the DFA; must be called after the last add()
+     */
+    void build();
+
+    /**
+     * @brief Union of the masks of all globs matching the whole text
+     */
+    uint32_t match(std::string_view text) const;
+
+    bool empty() const;
+    size_t getStateCount() const;
+
+    /**
+     * @brief Whether a filter entry uses glob syntax
+     */
+    static bool isGlob(std::string_view pattern);
+
+private:
+    enum class Op : uint8_t {
+        CHAR,       // One specific byte
+        STAR,       // '*': any run without '/'
+        GLOBSTAR,   // '**': any run
+        ACCEPT
+    };
+
+    struct Instruction {
+        Op op;
+        unsigned char c;
+        uint32_t mask;      // For ACCEPT
+    };
+
+    void addClosure(uint32_t pc, std::vector<uint32_t>& set) const;
+    void step(const std::vector<uint32_t>& from, unsigned char c, std::vector<uint32_t>& to) const;
+    uint32_t acceptMask(const std::vector<uint32_t>& set) const;
+    uint32_t simulate(std::string_view text) const;
+
+    std::vector<Instruction> program;
+    std::vector<uint32_t> starts;
+
+    bool built;
+    bool useDfa;
+    uint16_t byteClass[256];
+    std::vector<unsigned char> classByte;   // A representative byte per class
+    size_t classCount;
+    std::vector<uint32_t> transitions;      // state * classCount + class -> state; 0 is dead
+    std::vector<uint32_t> accepting;
+};
+
+/**
+ * @class PathFilter
+ * @brief Enforces the allowed_paths, excluded_paths and allowed_extensions filters
+ *
+ * Entries without a '*' are literals: one starting with '/' is a prefix of
+ * the path and query ("/admin" covers "/admin/users", "/search?q="
+ * covers "/search?q=cats"), anything else may occur anywhere in the path
+ * or query ("sessionid="). All literals are matched
+ * together by one Aho-Corasick automaton; glob entries are compiled into a
+ * GlobSet. Built once and then read concurrently without locking.
+ */
+class PathFilter {
+public:
+    PathFilter();
+    PathFilter(const std::vector<std::string>& allowedPaths,
+               const std::vector<std::string>& excludedPaths,
+               const std::vector<std::string>& allowedExtensions);
+
+    /**
+     * @brief Whether a page URL passes all path filters
+     */
+    bool isAllowed(std::string_view url) const;
+
+    /**
+     * @brief Whether a URL matches an excluded path, for resources such as
+     *        images that skip the allow-list and extension checks
+     */
+    bool isExcluded(std::string_view url) const;
+
+    bool empty() const;
+
+private:
+    enum Match : uint32_t {
+        ALLOWED = 1,
+        EXCLUDED = 2
+    };
+
+    struct Literal {
+        uint32_t mask;
+        size_t length;
+        bool prefix;
+    };
+
+    void addPattern(const std::string& pattern, uint32_t mask);
+    uint32_t matchPath(std::string_view url) const;
+
+    AhoCorasick literals;
+    std::vector<Literal> literalInfo;
+    GlobSet globs;
+    std::unordered_set<std::string> extensions;
+    bool hasAllowedPaths;
+    bool hasExcludedPaths;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class RecordSink
+ * @brief Appends records to a CSV or NDJSON file from many threads
+ *
+ * write() does no formatting and takes no lock: it pushes the record on
+ * a lock-free multi-producer queue. A background flusher drains the queue
+ * every flush interval (or sooner once a batch has built up), formats the
+ * whole batch and appends it with a single write to a file handle kept
+ * open for the sink's lifetime (group commit). The CSV header is written
+ * once, when the file is created, so concurrent writers can no longer
+ * repeat it.
+ *
+ * Once the file grows past the rotation size it is renamed to
+ * "<stem>.<n><extension>" with the next free n, and a fresh file with a
+ * new header takes its place.
+ *
+ * Records written before destruction are always flushed; none may be
+ * written during or after it.
+ */
+class RecordSink {
+public:
+    enum class Format {
+        CSV,
+        NDJSON          // One JSON object per line, keyed by column name
+    };
+
+    struct Options {
+        std::string path;
+        std::vector<std::string> columns;           // Header and NDJSON keys
+        Format format = Format::CSV;
+        size_t rotateBytes = 64 * 1024 * 1024;      // 0 never rotates
+        std::chrono::milliseconds flushInterval{200};
+        size_t batchRecords = 1024;                 // Wake the flusher early at this backlog
+    };
+
+    struct Stats {
+        long long records = 0;
+        long long bytes = 0;
+        long long commits = 0;          // Writes to the file, one per batch
+        long long rotations = 0;
+    };
+
+    /**
+     * @brief Open (or create) the file and start the flusher
+     * @param options Sink settings
+     */
+    explicit RecordSink(const Options& options);
+
+    /**
+     * @brief Destructor, flushes every record and closes the file
+     */
+    ~RecordSink();
+
+    RecordSink(const RecordSink&) = delete;
+    RecordSink& operator=(const RecordSink&) = delete;
+
+    /**
+     * @brief True if the file could be opened
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Queue a record, one field per column
+     *
+     * In NDJSON, fields that are integers are written as JSON numbers and
+     * everything else as strings.
+     */
+    void write(std::vector<std::string> fields);
+
+    Stats getStats() const;
+
+    const std::string& getPath() const;
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::vector<std::string> fields;
+    };
+
+    void flushLoop();
+    size_t drain(std::string& buffer);
+    void format(const std::vector<std::string>& fields, std::string& buffer) const;
+    bool openFile();
+    void rotate();
+    void commit(const std::string& buffer);
+
+    Options options;
+
+    // Multi-producer single-consumer queue: producers exchange the head,
+    // the flusher alone follows next pointers from the tail
+    std::atomic<Node*> head;
+    Node* tail;
+    std::atomic<size_t> pending;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool stopping;
+
+    std::ofstream file;             // Only touched by the flusher after construction
+    std::atomic<bool> fileOpen;     // Whether file is open, for other threads
+    uint64_t fileBytes;
+    uint64_t headerBytes;           // Size of the header this sink wrote, if any
+    std::thread flusher;
+
+    mutable std::mutex statsMutex;
+    Stats stats;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "fetcher.hpp"
+#include "response_archive.hpp"
+#include <string>
+
+/**
+ * @class ReplayFetcher
+ * @brief Serves fetches from a recorded WARC archive instead of the network
+ *
+ * URLs that were not recorded fail with an error rather than falling back
+ * to the network, so a replayed crawl never leaves the machine.
+ */
+class ReplayFetcher final : public Fetcher {
+public:
+    /**
+     * @brief Constructor
+     * @param archivePath Path to an uncompressed WARC file
+     */
+    explicit ReplayFetcher(const std::string& archivePath);
+
+    Result fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) override;
+    const char* getName() const override;
+
+    /**
+     * @brief True if the archive was opened
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Description of the failure to open the archive
+     */
+    const std::string& getError() const;
+
+    /**
+     * @brief Number of distinct URLs in the archive
+     */
+    size_t size() const;
+
+private:
+    ResponseArchive archive;
+    bool opened;
+};
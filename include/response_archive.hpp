@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <cstddef>
+
+/**
+ * @class ResponseArchive
+ * @brief Read-only, memory-mapped index over a WARC file of HTTP responses
+ *
+ * Opening the archive maps the file and walks the record headers once,
+ * indexing every `response` record by its target URI; bodies are not read
+ * until they are looked up. When a URI was recorded more than once, the
+ * last record wins. Only uncompressed WARC files can be mapped, so
+ * `.warc.gz` archives must be decompressed first. Chunked transfer coding
+ * and gzip content coding in recorded responses are decoded on lookup.
+ *
+ * After open() the archive is immutable and lookup() may be called from
+ * any number of threads.
+ */
+class ResponseArchive {
+public:
+    /**
+     * @struct Response
+     * @brief A recorded HTTP response
+     */
+    struct Response {
+        long status = 0;
+        std::string contentType;
+        long long contentLength = -1;   // Content-Length header of the original response
+        std::string body;               // Decoded body
+    };
+
+    ResponseArchive();
+    ~ResponseArchive();
+
+    ResponseArchive(const ResponseArchive&) = delete;
+    ResponseArchive& operator=(const ResponseArchive&) = delete;
+
+    /**
+     * @brief Map an archive and index its response records
+     * @param path Path to an uncompressed WARC file
+     * @return False if the file cannot be mapped or is not a WARC file
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Find the recorded response for a URL
+     * @param url Exact URL that was fetched
+     * @param response Receives the response
+     * @return False if the URL is not in the archive or its record is corrupt
+     */
+    bool lookup(const std::string& url, Response& response) const;
+
+    /**
+     * @brief Number of distinct URLs in the archive
+     */
+    size_t size() const;
+
+    /**
+     * @brief Description of the last open() failure
+     */
+    const std::string& getError() const;
+
+private:
+    struct Record {
+        size_t offset;  // Start of the HTTP response block
+        size_t length;
+    };
+
+    bool buildIndex();
+    void unmap();
+
+    const char* data;
+    size_t dataSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+    // Keys point into the mapping
+    std::unordered_map<std::string_view, Record> index;
+    std::string error;
+};
+
+/**
+ * @class ResponseArchiveWriter
+ * @brief Appends HTTP responses to a WARC file readable by ResponseArchive
+ *
+ * Each response becomes one uncompressed WARC/1.0 `response` record whose
+ * block is a synthesized HTTP/1.1 message: the status, Content-Type and
+ * Content-Length of the original response followed by the decoded body.
+ * Content coding is not recorded, since the body is stored decoded. Safe to
+ * call from multiple threads.
+ */
+class ResponseArchiveWriter {
+public:
+    /**
+     * @brief Open a WARC file for appending, writing a warcinfo record if it is new
+     * @param path Path to the archive
+     */
+    explicit ResponseArchiveWriter(const std::string& path);
+
+    /**
+     * @brief True if the file could be opened
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Append a response record
+     * @param url URL that was fetched
+     * @param status HTTP status code
+     * @param contentType Content-Type header, empty if none
+     * @param contentLength Original Content-Length header, -1 to use the body size
+     * @param body Decoded body (may be empty or truncated for rejected responses)
+     * @return False if the write failed
+     */
+    bool record(const std::string& url, long status, const std::string& contentType,
+                long long contentLength, const std::string& body);
+
+    /**
+     * @brief Number of records written by this writer
+     */
+    size_t getRecordCount() const;
+
+private:
+    void writeRecord(const std::string& type, const std::string& targetUri,
+                     const std::string& contentType, const std::string& block);
+    std::string makeRecordId();
+
+    std::ofstream file;
+    mutable std::mutex mutex;
+    std::mt19937_64 random;
+    size_t records;
+};
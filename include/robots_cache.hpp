@@ -0,0 +1,128 @@
+#pragma once
+
+#include "robots_rules.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+/**
+ * @class RobotsCache
+ * @brief Shared, bounded cache of compiled robots.txt rules per origin
+ *
+ * The first URL seen for an origin (scheme, host and port) queues a
+ * robots.txt fetch on a background thread and comes back as PENDING, so
+ * callers never block on it. A caller can register a callback that receives
+ * the verdict once the rules arrive. Entries are evicted least recently
+ * used first and refetched after their TTL.
+ *
+ * Fetch outcomes follow RFC 9309: 2xx is parsed, 4xx allows everything, and
+ * 5xx or network errors disallow everything until the shorter error TTL
+ * runs out.
+ */
+class RobotsCache {
+public:
+    enum class Verdict {
+        ALLOWED,
+        DISALLOWED,
+        PENDING
+    };
+
+    /**
+     * @brief Fetches a URL; returns false on network failure
+     */
+    using FetchFunction = std::function<bool(const std::string& url, long& status, std::string& body)>;
+
+    /**
+     * @brief Receives the verdict for a URL that was PENDING
+     */
+    using VerdictCallback = std::function<void(const std::string& url, bool allowed)>;
+
+    /**
+     * @brief Constructor
+     * @param userAgent User-Agent used to select robots.txt groups
+     * @param fetch Function used to download robots.txt files
+     * @param fetchThreads Number of background fetch threads
+     * @param capacity Maximum number of cached origins
+     * @param ttl How long fetched rules are reused
+     * @param errorTtl How long an unreachable robots.txt blocks its origin
+     */
+    RobotsCache(const std::string& userAgent, FetchFunction fetch,
+                size_t fetchThreads = 2, size_t capacity = 1024,
+                std::chrono::seconds ttl = std::chrono::hours(24),
+                std::chrono::seconds errorTtl = std::chrono::minutes(10));
+
+    /**
+     * @brief Destructor, stops the fetch threads
+     */
+    ~RobotsCache();
+
+    /**
+     * @brief Check a URL, starting a robots.txt fetch if its origin is unknown
+     * @param url Absolute URL
+     * @param onReady Called with the verdict if the result is PENDING
+     * @return Verdict, or PENDING while the rules are being fetched
+     */
+    Verdict check(const std::string& url, VerdictCallback onReady = nullptr);
+
+    /**
+     * @brief Get the cached rules for a URL's origin
+     * @return Rules, or nullptr if not cached
+     */
+    std::shared_ptr<const RobotsRules> getRules(const std::string& url);
+
+    /**
+     * @brief Origin of a URL ("scheme://host[:port]")
+     */
+    static std::string getOrigin(const std::string& url);
+
+    // Statistics
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getSize() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const RobotsRules> rules;
+        std::chrono::steady_clock::time_point expires;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    struct Waiter {
+        std::string url;
+        VerdictCallback callback;
+    };
+
+    void fetchThread();
+    void fetchOrigin(const std::string& origin);
+    void insertLocked(const std::string& origin, std::shared_ptr<const RobotsRules> rules,
+                      std::chrono::seconds lifetime);
+
+    std::string userAgent;
+    FetchFunction fetch;
+    size_t capacity;
+    std::chrono::seconds ttl;
+    std::chrono::seconds errorTtl;
+
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;
+    std::unordered_map<std::string, std::vector<Waiter>> inFlight;
+    std::deque<std::string> pending;
+
+    mutable std::mutex cacheMutex;
+    std::condition_variable pendingCondition;
+
+    std::vector<std::thread> fetchers;
+    bool stopping;
+
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+};
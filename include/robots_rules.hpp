@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @class RobotsRules
+ * @brief robots.txt rules compiled for a single user agent
+ *
+ * Parsing follows RFC 9309: consecutive user-agent lines share one group,
+ * all groups naming the crawler's product token are merged, and "*" is used
+ * only when no group names the crawler. Allow and disallow patterns of the
+ * selected group are compiled into one trie in which '*' matches any run of
+ * characters and a trailing '$' anchors the end of the path. A URL is
+ * checked with a single pass over its path; the longest matching pattern
+ * decides, and allow wins ties.
+ */
+class RobotsRules {
+public:
+    /**
+     * @brief Parse robots.txt content for a user agent
+     * @param content robots.txt body
+     * @param userAgent Full User-Agent header of the crawler
+     * @return Compiled rules
+     */
+    static std::shared_ptr<RobotsRules> parse(const std::string& content, const std::string& userAgent);
+
+    /**
+     * @brief Rules that allow every path (missing robots.txt)
+     */
+    static std::shared_ptr<RobotsRules> allowAll();
+
+    /**
+     * @brief Rules that disallow every path (unreachable robots.txt)
+     */
+    static std::shared_ptr<RobotsRules> disallowAll();
+
+    /**
+     * @brief Check a path against the rules
+     * @param path URL path including the query string
+     * @return True if crawling the path is allowed
+     */
+    bool isAllowed(const std::string& path) const;
+
+    /**
+     * @brief Check a full URL against the rules
+     * @param url Absolute URL
+     * @return True if crawling the URL is allowed
+     */
+    bool isUrlAllowed(const std::string& url) const;
+
+    /**
+     * @brief Crawl-delay of the selected group in seconds (0 if absent)
+     */
+    int getCrawlDelay() const;
+
+    /**
+     * @brief Sitemap URLs declared anywhere in the file
+     */
+    const std::vector<std::string>& getSitemaps() const;
+
+    /**
+     * @brief Number of compiled allow/disallow patterns
+     */
+    size_t getRuleCount() const;
+
+    /**
+     * @brief Path and query of a URL ("/" if empty)
+     */
+    static std::string extractPath(const std::string& url);
+
+    RobotsRules();
+    ~RobotsRules();
+
+private:
+    struct Node;
+
+    void addPattern(const std::string& pattern, bool allow);
+
+    std::unique_ptr<Node> root;
+    size_t ruleCount;
+    int crawlDelay;
+    std::vector<std::string> sitemaps;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <ctime>
+#include <cstddef>
+
+/**
+ * @class SitemapParser
+ * @brief Incremental parser for sitemaps and sitemap indexes
+ *
+ * XML is consumed in arbitrary chunks and each <url> (or, in a sitemap
+ * index, each <sitemap>) is reported as soon as its closing tag has been
+ * seen. Only the current tag and field text are buffered, so a 50,000-URL
+ * sitemap is parsed in constant memory. Plain-text sitemaps (one URL per
+ * line) are recognised as well.
+ */
+class SitemapParser {
+public:
+    struct Entry {
+        std::string loc;
+        std::string lastmod;            // As written in the sitemap
+        std::time_t lastModified;       // 0 if absent or unparseable
+        float priority;                 // 0.0-1.0, 0.5 if absent
+        std::string changeFrequency;
+    };
+
+    /**
+     * @brief Receives one entry of a sitemap or sitemap index
+     */
+    using EntryCallback = std::function<void(const Entry& entry)>;
+
+    /**
+     * @brief Constructor
+     * @param onUrl Called for every <url> of a urlset
+     * @param onSitemap Called for every <sitemap> of a sitemap index
+     */
+    SitemapParser(EntryCallback onUrl, EntryCallback onSitemap);
+
+    /**
+     * @brief Feed a chunk of the document
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * @brief Signal the end of the document
+     */
+    void finish();
+
+    /**
+     * @brief Reset the parser for a new document
+     */
+    void reset();
+
+    /**
+     * @brief True if the document is a sitemap index
+     */
+    bool isIndex() const;
+
+    /**
+     * @brief Number of <url> entries reported
+     */
+    size_t getUrlCount() const;
+
+    /**
+     * @brief Number of <sitemap> entries reported
+     */
+    size_t getSitemapCount() const;
+
+    /**
+     * @brief Parse a W3C datetime ("2024-05-01", "2024-05-01T10:00:00+02:00")
+     * @return Seconds since the epoch (UTC), or 0 if invalid
+     */
+    static std::time_t parseW3cDateTime(const std::string& value);
+
+private:
+    enum class State {
+        START,      // Format not known yet
+        TEXT,
+        TAG,
+        COMMENT,
+        CDATA,
+        PLAIN       // Plain-text sitemap
+    };
+
+    enum class Field {
+        NONE,
+        LOC,
+        LASTMOD,
+        PRIORITY,
+        CHANGEFREQ
+    };
+
+    void handleTag();
+    void handleText(const char* data, size_t size);
+    void finishField();
+    void finishPlainLine();
+    void emitEntry(bool sitemap);
+    static std::string decodeEntities(const std::string& text);
+
+    EntryCallback onUrl;
+    EntryCallback onSitemap;
+
+    State state;
+    std::string tag;
+    std::string text;
+    char quote;
+    int pending;                // Dashes or brackets that may close a comment/CDATA
+
+    int depth;
+    int entryDepth;             // Depth of the open <url>/<sitemap>, -1 if none
+    bool entryIsSitemap;
+    Field field;
+    Entry current;
+
+    bool index;
+    size_t urlCount;
+    size_t sitemapCount;
+
+    static const size_t MAX_TAG_LENGTH = 4096;
+    static const size_t MAX_FIELD_LENGTH = 4096;
+};
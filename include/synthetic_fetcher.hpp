@@ -0,0 +1,65 @@
+#pragma once
+
+#include "fetcher.hpp"
+#include "synthetic_web.hpp"
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @class SyntheticFetcher
+ * @brief Answers fetches from an in-memory SyntheticWeb, without any I/O
+ *
+ * Every host serves the same synthetic site graph, so the crawler can be
+ * driven by deterministic load with configurable page sizes, fan-out,
+ * latency distribution, error and redirect rates. fetch() sleeps for the
+ * page's simulated latency. fetchAsync() instead parks the finished
+ * response on a single timer thread until its latency has passed, so any
+ * number of fetches can be in flight without a thread each. Fetches still
+ * parked when the fetcher is destroyed complete with an error.
+ */
+class SyntheticFetcher final : public Fetcher {
+public:
+    /**
+     * @brief Constructor
+     * @param options Shape of the synthetic web
+     */
+    explicit SyntheticFetcher(const SyntheticWeb::Options& options);
+    ~SyntheticFetcher() override;
+
+    Result fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) override;
+    void fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                    CompletionHandler onComplete) override;
+    const char* getName() const override;
+
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t sequence;              // Keeps timers with equal deadlines in order
+        std::function<void(bool cancelled)> task;
+
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    SyntheticWeb::Response respond(const Request& request) const;
+    static Result deliver(const SyntheticWeb::Response& response, const HeaderHandler& onHeaders,
+                          const BodyHandler& onBody);
+    void timerLoop();
+
+    SyntheticWeb web;
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    uint64_t nextSequence;
+    std::thread timerThread;
+    std::mutex timerMutex;
+    std::condition_variable timerCondition;
+    bool stopping;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class SyntheticWeb
+ * @brief Deterministic site graph for benchmarks and the synthetic fetcher
+ *
+ * Pages are addressed as /page/<n>, and / is page 0. With several hosts,
+ * page n lives on site<n mod hosts>.test and links are absolute, but every
+ * host answers for every path. Everything about a page - its links,
+ * its text, whether it fails or redirects and how long the server takes to
+ * answer - is derived from the seed and the page number, so two runs with
+ * the same options crawl exactly the same web. Page text is drawn from a
+ * word list per page, so pages do not look like near-duplicates of each
+ * other.
+ */
+class SyntheticWeb {
+public:
+    struct Options {
+        size_t pageCount = 10000;       // Distinct pages in the graph
+        size_t fanout = 10;             // Links per page
+        size_t pageBytes = 16 * 1024;   // Approximate HTML size
+        double latencyMedianMs = 5.0;   // Server think time, log-normally distributed
+        double latencyP99Ms = 50.0;
+        double errorRate = 0.01;        // Share of pages answering 503
+        double redirectRate = 0.02;     // Share of pages answering 301
+        bool gzip = true;               // Honour Accept-Encoding: gzip
+        size_t hostCount = 1;           // Above 1, pages are spread over hosts site<k>.test
+        uint64_t seed = 42;
+    };
+
+    struct Response {
+        int status = 200;
+        std::string contentType;
+        std::string location;           // For redirects
+        std::string contentEncoding;
+        std::string body;
+        std::chrono::microseconds delay{0};
+    };
+
+    explicit SyntheticWeb(const Options& options);
+
+    /**
+     * @brief Build the response for a request target
+     * @param target Path and query from the request line
+     * @param acceptGzip Whether the client accepts gzip
+     */
+    Response respond(const std::string& target, bool acceptGzip) const;
+
+    /**
+     * @brief Absolute path of a page
+     */
+    static std::string pagePath(size_t page);
+
+    /**
+     * @brief Link to a page: its path, or an absolute URL when pages span several hosts
+     */
+    std::string pageUrl(size_t page) const;
+
+    const Options& getOptions() const;
+
+private:
+    uint64_t hash(uint64_t a, uint64_t b = 0) const;
+    double unitValue(uint64_t a, uint64_t b) const;
+    std::chrono::microseconds latencyFor(size_t page) const;
+    std::string renderPage(size_t page) const;
+
+    Options options;
+};
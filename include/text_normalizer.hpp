@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @class TextNormalizer
+ * @brief Reduces HTML or text to words separated by single spaces, in one pass
+ *
+ * Tags (from '<' to the next '>') are removed without a trace, every byte
+ * other than an ASCII letter or digit becomes a separator, and each run of
+ * separators is written as one space. Bytes are classified through a
+ * 256-entry table and written straight into the caller's buffer, which
+ * keeps its capacity between calls, so normalizing a page costs no
+ * allocations once the buffer has grown to page size.
+ *
+ * The result matches lowercasing, deleting "<[^>]*>", replacing
+ * "[^a-z0-9\s]" with a space and collapsing "\s+", in that order.
+ */
+class TextNormalizer {
+public:
+    enum class Case {
+        LOWER,          // Letters are lowercased
+        PRESERVE        // Letters keep their case, for finding names
+    };
+
+    /**
+     * @brief Normalize text into out, replacing its contents
+     */
+    static void normalize(std::string_view text, std::string& out, Case letterCase = Case::LOWER);
+
+    /**
+     * @brief Normalize text into a new string
+     */
+    static std::string normalize(std::string_view text, Case letterCase = Case::LOWER);
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class TopicScorer
+ * @brief Relevance of pages and link text to a topic, for focused crawling
+ *
+ * The topic is compiled once from a query of whitespace-separated terms,
+ * each optionally weighted as "term:weight" (default 1). Text is scored
+ * in one pass over its words: a word is a run of ASCII letters and digits
+ * (or non-ASCII bytes), lowercased, and is looked up in a hash table of the
+ * terms. A term contributes its weight scaled by 1 + ln(occurrences),
+ * saturating at eight occurrences, and the score is the sum over the sum
+ * of all weights, so it lies in [0, 1]: 1 when every term occurs often,
+ * 0 when none occurs.
+ */
+class TopicScorer {
+public:
+    // Longer terms and words are ignored
+    static constexpr size_t MAX_WORD_LENGTH = 64;
+
+    struct Term {
+        std::string text;
+        float weight;
+    };
+
+    /**
+     * @class Counter
+     * @brief Scores one HTML document fed chunk by chunk
+     *
+     * Markup, comments, scripts and styles are skipped, so the body can be
+     * fed as it downloads. Not thread-safe; use one per document.
+     */
+    class Counter {
+    public:
+        explicit Counter(const TopicScorer& scorer);
+
+        void feed(const char* data, size_t size);
+
+        /**
+         * @brief Score of everything fed so far
+         */
+        double finish();
+
+        void reset();
+
+    private:
+        void endWord();
+        void endTag();
+
+        const TopicScorer& scorer;
+        std::vector<uint32_t> counts;           // Occurrences by term
+        char word[MAX_WORD_LENGTH];
+        size_t wordLength;                      // Longer than the buffer if the word overflowed
+        bool inTag;
+        char tagName[8];                        // Start of the tag, for script and style
+        size_t tagLength;
+        bool tagNameDone;
+        char lastTwo[2];                        // To find the end of comments
+        bool inComment;
+        bool inRawText;                         // Inside <script> or <style>
+    };
+
+    /**
+     * @brief Compile a topic query
+     */
+    explicit TopicScorer(const std::string& query);
+
+    /**
+     * @brief True if the query held no terms
+     */
+    bool empty() const;
+
+    const std::vector<Term>& getTerms() const;
+
+    /**
+     * @brief Score plain text, such as link text
+     */
+    double scoreText(std::string_view text) const;
+
+    /**
+     * @brief Score an HTML document in one go
+     */
+    double scoreHtml(std::string_view html) const;
+
+private:
+    // Index of the term a lowercased word is, or -1
+    int findTerm(const char* word, size_t length) const;
+    double score(const std::vector<uint32_t>& counts) const;
+
+    std::vector<Term> terms;
+    std::vector<int32_t> table;         // Open addressing over term indices, -1 when empty
+    size_t tableMask;
+    double totalWeight;
+};
@@ -7,6 +7,10 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <memory>
+#include "url_trap_detector.hpp"
+#include "host_filter.hpp"
+#include "record_sink.hpp"
 
 // Simple URL parser class
 class SimpleURLParser {
@@ -46,6 +50,7 @@ public:
     void setMaxThreads(int threads);
     void setMaxDepth(int depth);
     void setAllowedDomains(const std::vector<std::string>& domains);
+    void setOutputFormat(RecordSink::Format format);
     
     // Control methods
     void start(const std::string& seedUrl, int depth = 0);
@@ -81,6 +86,7 @@ private:
     void saveImageToFileSystem(const std::string& domain, const std::string& imageName, 
                               const std::string& imageType, int imageIndex);
     int simulateImageDiscovery(const std::string& domain);
+    void openSinks();
     
     // Thread management
     std::vector<std::thread> threads;
@@ -90,11 +96,18 @@ private:
     // URL queue and tracking
     std::queue<std::pair<std::string, int>> urlQueue; // URL and depth
     std::unordered_set<std::string> visitedUrls;
+    std::unordered_set<std::string> pendingUrls;      // Queued or being processed
+    UrlTrapDetector trapDetector;
     
     // Configuration
     int maxThreads;
     int maxDepth;
-    std::vector<std::string> allowedDomains;
+    HostFilter allowedHosts;
+    RecordSink::Format outputFormat;
+    
+    // Page and image records, open while the crawler runs
+    std::unique_ptr<RecordSink> pageSink;
+    std::unique_ptr<RecordSink> imageSink;
     
     // State
     bool running;
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @class UrlExchange
+ * @brief Per-destination URL buffers for a partitioned crawl
+ *
+ * Links bound for another node are accumulated in one buffer per
+ * destination, together with a 64-bit fingerprint of each URL. A small
+ * direct-mapped cache of recently seen fingerprints drops links that were
+ * already queued or sent a moment ago (navigation links repeat on nearly
+ * every page), so only new URLs cost wire bytes. A buffer is ready to be
+ * sent once it holds enough URLs or bytes, or once its oldest URL has
+ * waited for the flush interval.
+ *
+ * Batches are encoded by sorting the URLs and front-coding them: each URL
+ * is stored as the length of the prefix it shares with the previous one
+ * plus the remaining suffix, with all numbers as varints. URLs of the same
+ * host share long prefixes, so a batch typically costs a few bytes per URL.
+ *
+ * Not thread-safe; the owning ClusterNode serializes access.
+ */
+class UrlExchange {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        size_t batchSize = 256;             // URLs per destination before a batch is ready
+        size_t batchBytes = 64 * 1024;      // URL bytes per destination before a batch is ready
+        std::chrono::milliseconds flushInterval{100};
+        size_t recentCapacity = 16384;      // Fingerprints remembered for deduplication
+    };
+
+    struct Entry {
+        uint64_t fingerprint;
+        std::string url;
+        int depth;
+    };
+
+    struct Batch {
+        std::string destination;
+        std::vector<Entry> entries;
+        Clock::time_point started;          // When the oldest URL was buffered
+    };
+
+    struct Stats {
+        long long urlsAdded = 0;            // Accepted into a buffer
+        long long duplicatesDropped = 0;    // Dropped by the recent-seen cache
+        long long batchesTaken = 0;
+    };
+
+    explicit UrlExchange(const Options& options);
+
+    /**
+     * @brief Buffer a URL for a destination
+     * @return False if the URL was seen recently and dropped
+     */
+    bool add(const std::string& destination, std::string url, int depth);
+
+    /**
+     * @brief Take the batches that are full or have waited long enough
+     * @param now Current time
+     * @param all Take every non-empty buffer regardless
+     */
+    std::vector<Batch> takeReady(Clock::time_point now, bool all = false);
+
+    /**
+     * @brief Take everything buffered for a destination, e.g. one that left
+     */
+    std::vector<Entry> takeAll(const std::string& destination);
+
+    /**
+     * @brief Put back a batch that could not be sent, ahead of newer URLs
+     */
+    void restore(Batch batch);
+
+    /**
+     * @brief Forget recently seen URLs
+     *
+     * Must be called when ownership changes, so a URL sent to a node that
+     * has since gone is not dropped on its way to the new owner.
+     */
+    void forgetRecent();
+
+    /**
+     * @brief True if any buffer has reached its size limit
+     */
+    bool hasFullBuffer() const;
+
+    /**
+     * @brief True if nothing is buffered
+     */
+    bool empty() const;
+
+    Stats getStats() const;
+
+    /**
+     * @brief 64-bit fingerprint of a URL, never 0
+     */
+    static uint64_t fingerprint(std::string_view url);
+
+    /**
+     * @brief Encode a batch for the wire; sorts the entries by URL
+     */
+    static std::string encode(std::vector<Entry>& entries);
+
+    /**
+     * @brief Decode a batch produced by encode()
+     * @param payload Encoded batch
+     * @param urls Receives each URL and its depth
+     * @return False if the payload is malformed, in which case urls is left empty
+     */
+    static bool decode(std::string_view payload, std::vector<std::pair<std::string, int>>& urls);
+
+private:
+    struct Buffer {
+        std::vector<Entry> entries;
+        size_t bytes = 0;
+        Clock::time_point started;
+    };
+
+    bool isFull(const Buffer& buffer) const;
+
+    Options options;
+    std::map<std::string, Buffer> buffers;
+    std::vector<uint64_t> recent;           // Direct-mapped by fingerprint, 0 = empty slot
+    Stats stats;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <functional>
+#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class UrlFrontier
+ * @brief Priority-ordered queue of URLs waiting to be crawled
+ *
+ * URLs are served by descending priority plus link rank; equal values are
+ * served by most recent modification time and then in insertion order, so
+ * a frontier fed only default priorities behaves like a FIFO queue. A URL
+ * already queued is not added again. Not thread-safe: the owner guards it
+ * with its queue mutex.
+ */
+class UrlFrontier {
+public:
+    struct Entry {
+        std::string url;
+        int depth = 0;
+        float priority = DEFAULT_PRIORITY;
+        std::time_t lastModified = 0;   // 0 if unknown
+        float rank = 0.0f;              // Link analysis boost, added to the priority
+    };
+
+    // Priority of URLs without a hint (the sitemap protocol default)
+    static constexpr float DEFAULT_PRIORITY = 0.5f;
+
+    UrlFrontier();
+
+    /**
+     * @brief Add one URL
+     * @return False if it was already queued
+     */
+    bool push(Entry entry);
+
+    /**
+     * @brief Add many URLs at once; entries are moved out of the vector
+     */
+    void pushBatch(std::vector<Entry>& entries);
+
+    /**
+     * @brief Remove the highest-priority URL
+     * @return False if the frontier is empty
+     */
+    bool pop(Entry& entry);
+
+    /**
+     * @brief Let update() change any queued entry, then restore the order
+     */
+    void reprioritize(const std::function<void(Entry&)>& update);
+
+    /**
+     * @brief True if the URL is waiting in the frontier
+     */
+    bool contains(const std::string& url) const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+private:
+    struct Item {
+        Entry entry;
+        uint64_t sequence;
+    };
+
+    // Heap order: true if a should be served after b
+    static bool servedAfter(const Item& a, const Item& b);
+
+    std::vector<Item> heap;
+    std::unordered_set<std::string> queued;     // URLs of the entries in heap
+    uint64_t nextSequence;
+};
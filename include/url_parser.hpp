@@ -1,6 +1,7 @@
 #pragma once
 
 #include "build_config.hpp"
+#include "host_filter.hpp"
 #include <string>
 #include <vector>
 #include <regex>
@@ -43,6 +44,7 @@ public:
 
     // Filter URLs that should not be crawled
     bool shouldCrawl(const std::string& url, const std::vector<std::string>& allowedDomains);
+    bool shouldCrawl(const std::string& url, const HostFilter& allowedHosts);
 
 private:
 #ifndef USE_STUB_IMPLEMENTATION
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+/**
+ * @class UrlTrapDetector
+ * @brief Recognizes URL spaces that grow without bound on a single host
+ *
+ * Calendars, faceted search and session-stamped links produce endless
+ * variants of the same few pages. Each new URL is reduced to a template per
+ * host: digit runs and long hex tokens in the path become placeholders and
+ * query values are dropped, keeping only the sorted parameter names. The
+ * detector counts how many distinct URLs share each template, how many
+ * parameter-name combinations each path template has spawned, and whether
+ * any path segment repeats. Templates past the soft limit are throttled
+ * with a priority penalty that grows with their size; past the hard limit,
+ * or on repeated segments, URLs are dropped.
+ *
+ * Not thread-safe: the owner guards it with its queue mutex.
+ */
+class UrlTrapDetector {
+public:
+    enum class Verdict {
+        ACCEPT,
+        THROTTLE,
+        DROP
+    };
+
+    /**
+     * @brief Constructor
+     * @param softLimit URLs per template before new ones are throttled
+     * @param hardLimit URLs per template before new ones are dropped
+     * @param maxRepeatedSegments Times a path segment may occur in one URL
+     */
+    UrlTrapDetector(size_t softLimit = 100, size_t hardLimit = 1000, size_t maxRepeatedSegments = 3);
+
+    /**
+     * @brief Classify and record a URL that has not been seen before
+     * @param url Absolute URL
+     * @param priorityScale Receives the factor to apply to the URL's priority
+     *        (1 when accepted, below 1 when throttled, 0 when dropped)
+     * @return Verdict for the URL
+     */
+    Verdict check(const std::string& url, float& priorityScale);
+
+    /**
+     * @brief Reduce a URL to its host and pattern template
+     * @return False if the URL has no host
+     */
+    static bool makeTemplate(const std::string& url, std::string& host, std::string& pathTemplate,
+                             std::string& paramNames, std::vector<std::string>& segments);
+
+    /**
+     * @brief Forget all recorded patterns
+     */
+    void clear();
+
+    // Statistics
+    size_t getThrottled() const;
+    size_t getDropped() const;
+
+private:
+    struct PathPattern {
+        // Parameter-name combination -> distinct URLs using it
+        std::unordered_map<std::string, size_t> variants;
+    };
+
+    struct HostPatterns {
+        std::unordered_map<std::string, PathPattern> paths;
+    };
+
+    size_t softLimit;
+    size_t hardLimit;
+    size_t maxRepeatedSegments;
+
+    std::unordered_map<std::string, HostPatterns> hosts;
+    size_t throttled;
+    size_t dropped;
+};
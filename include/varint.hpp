@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief LEB128-style varints and zigzag mapping shared by the binary formats
+ *
+ * Seven bits per byte, least significant group first, high bit set on every
+ * byte but the last. Signed values go through zigzag first so that small
+ * negative numbers stay short. Used by the URL exchange batches, the link
+ * graph adjacency lists and the columnar files, which must all agree.
+ */
+
+inline void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Read one varint at position and advance past it; false on truncated or
+// over-long input
+inline bool getVarint(std::string_view data, size_t& position, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[position++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
@@ -64,7 +64,7 @@ if not exist vcpkg (
 :: Install required packages
 echo Installing required libraries...
 cd vcpkg
-vcpkg install curl:x64-windows sqlite3:x64-windows nlohmann-json:x64-windows
+vcpkg install curl:x64-windows sqlite3:x64-windows nlohmann-json:x64-windows zlib:x64-windows
 if %errorlevel% neq 0 (
     echo Failed to install packages.
     cd ..
@@ -33,6 +33,7 @@ echo Installing required libraries using vcpkg...
 vcpkg\vcpkg install curl:x64-windows
 vcpkg\vcpkg install sqlite3:x64-windows
 vcpkg\vcpkg install nlohmann-json:x64-windows
+vcpkg\vcpkg install zlib:x64-windows
 
 REM Create required directories
 echo Creating required directories...
@@ -0,0 +1,122 @@
+#include "../include/aho_corasick.hpp"
+#include <algorithm>
+#include <cctype>
+
+AhoCorasick::AhoCorasick(bool caseInsensitive)
+    : caseInsensitive(caseInsensitive)
+    , built(false)
+    , patternCount(0)
+    , classCount(1) {
+    trie.emplace_back();
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+}
+
+void AhoCorasick::add(std::string_view pattern, uint32_t id) {
+    if (pattern.empty()) {
+        return;
+    }
+
+    uint32_t node = 0;
+    for (char ch : pattern) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (caseInsensitive) {
+            c = static_cast<unsigned char>(std::tolower(c));
+        }
+
+        uint32_t next = 0;
+        for (const auto& child : trie[node].children) {
+            if (child.first == c) {
+                next = child.second;
+                break;
+            }
+        }
+        if (next == 0) {
+            next = static_cast<uint32_t>(trie.size());
+            trie[node].children.emplace_back(c, next);
+            trie.emplace_back();
+        }
+        node = next;
+    }
+    trie[node].ids.push_back(id);
+    patternCount++;
+    built = false;
+}
+
+void AhoCorasick::build() {
+    // One column per byte that occurs in a pattern; everything else is class 0
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+    classCount = 1;
+    for (const auto& node : trie) {
+        for (const auto& child : node.children) {
+            if (byteClass[child.first] == 0) {
+                byteClass[child.first] = static_cast<uint16_t>(classCount++);
+            }
+        }
+    }
+    if (caseInsensitive) {
+        for (int c = 'A'; c <= 'Z'; ++c) {
+            byteClass[c] = byteClass[std::tolower(c)];
+        }
+    }
+
+    size_t stateCount = trie.size();
+    transitions.assign(stateCount * classCount, 0);
+    std::vector<uint32_t> fail(stateCount, 0);
+    std::vector<std::vector<uint32_t>> stateOutputs(stateCount);
+
+    // Breadth-first, so a state's failure target is complete before it is used
+    std::vector<uint32_t> order;
+    order.reserve(stateCount);
+    order.push_back(0);
+    for (size_t head = 0; head < order.size(); ++head) {
+        uint32_t state = order[head];
+        uint32_t* row = &transitions[state * classCount];
+
+        if (state != 0) {
+            const uint32_t* failRow = &transitions[fail[state] * classCount];
+            std::copy(failRow, failRow + classCount, row);
+
+            stateOutputs[state] = trie[state].ids;
+            const auto& inherited = stateOutputs[fail[state]];
+            stateOutputs[state].insert(stateOutputs[state].end(), inherited.begin(), inherited.end());
+        }
+
+        for (const auto& child : trie[state].children) {
+            uint16_t cls = byteClass[child.first];
+            fail[child.second] = state == 0 ? 0 : transitions[fail[state] * classCount + cls];
+            row[cls] = child.second;
+            order.push_back(child.second);
+        }
+    }
+
+    outputStart.assign(stateCount + 1, 0);
+    outputs.clear();
+    for (size_t state = 0; state < stateCount; ++state) {
+        outputStart[state] = static_cast<uint32_t>(outputs.size());
+        outputs.insert(outputs.end(), stateOutputs[state].begin(), stateOutputs[state].end());
+    }
+    outputStart[stateCount] = static_cast<uint32_t>(outputs.size());
+
+    built = true;
+}
+
+bool AhoCorasick::containsAny(std::string_view text) const {
+    bool found = false;
+    scan(text, [&found](uint32_t, size_t) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool AhoCorasick::empty() const {
+    return patternCount == 0;
+}
+
+size_t AhoCorasick::getPatternCount() const {
+    return patternCount;
+}
+
+size_t AhoCorasick::getStateCount() const {
+    return trie.size();
+}
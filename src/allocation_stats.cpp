@@ -0,0 +1,106 @@
+#include "../include/allocation_stats.hpp"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> totalAllocations(0);
+std::atomic<size_t> totalBytes(0);
+thread_local size_t threadAllocations = 0;
+
+void* countedAllocate(size_t size) {
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    threadAllocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    void* p = countedAllocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = countedAllocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+bool AllocationStats::isEnabled() {
+    return true;
+}
+
+size_t AllocationStats::getThreadAllocations() {
+    return threadAllocations;
+}
+
+size_t AllocationStats::getTotalAllocations() {
+    return totalAllocations.load(std::memory_order_relaxed);
+}
+
+size_t AllocationStats::getTotalBytes() {
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationStats::isEnabled() {
+    return false;
+}
+
+size_t AllocationStats::getThreadAllocations() {
+    return 0;
+}
+
+size_t AllocationStats::getTotalAllocations() {
+    return 0;
+}
+
+size_t AllocationStats::getTotalBytes() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#include "../include/buffer_pool.hpp"
+
+BufferPool::BufferPool(size_t initialCapacity, size_t maxPooled, size_t maxRetainedCapacity)
+    : initialCapacity(initialCapacity)
+    , maxPooled(maxPooled)
+    , maxRetainedCapacity(maxRetainedCapacity)
+    , hits(0)
+    , misses(0) {
+    idle.reserve(maxPooled);
+}
+
+std::string BufferPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!idle.empty()) {
+            std::string buffer = std::move(idle.back());
+            idle.pop_back();
+            hits++;
+            return buffer;
+        }
+    }
+
+    misses++;
+    std::string buffer;
+    buffer.reserve(initialCapacity);
+    return buffer;
+}
+
+void BufferPool::release(std::string&& buffer) {
+    if (buffer.capacity() > maxRetainedCapacity) {
+        return;
+    }
+
+    buffer.clear();
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (idle.size() < maxPooled) {
+        idle.push_back(std::move(buffer));
+    }
+}
+
+size_t BufferPool::getHits() const {
+    return hits;
+}
+
+size_t BufferPool::getMisses() const {
+    return misses;
+}
+
+size_t BufferPool::getIdleCount() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return idle.size();
+}
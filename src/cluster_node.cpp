@@ -0,0 +1,730 @@
+#include "../include/cluster_node.hpp"
+#include "../include/host_filter.hpp"
+#include "../include/compression.hpp"
+#include "../include/monitoring.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef int socklen_t;
+#define CLOSE_SOCKET closesocket
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CLOSE_SOCKET close
+#endif
+
+namespace {
+
+const long long INVALID = -1;
+
+// How often the receiver wakes up to check for shutdown
+const int POLL_INTERVAL_MS = 200;
+
+// Frames larger than this are treated as a corrupt stream
+const size_t MAX_FRAME_BYTES = 64 * 1024 * 1024;
+
+const int CONNECT_TIMEOUT_MS = 2000;
+
+// Encoded URL batches at least this large are also gzip-compressed
+const size_t COMPRESS_MIN_BYTES = 1024;
+
+// Frame: 4-byte big-endian length of type + payload, 1-byte type, payload
+enum FrameType : unsigned char {
+    HEARTBEAT = 1,      // "<node> <idle> <urls sent> <urls received> <member>,<member>..."
+    LEAVE = 2,          // "<node>"
+    URLS = 3            // UrlExchange::encode(), gzip-compressed when large
+};
+
+bool splitAddress(const std::string& address, std::string& host, std::string& port) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        return false;
+    }
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+    // Bracketed IPv6 literals
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    return true;
+}
+
+void setNonBlocking(long long socket, bool enabled) {
+#ifdef _WIN32
+    u_long mode = enabled ? 1 : 0;
+    ioctlsocket(static_cast<SOCKET>(socket), FIONBIO, &mode);
+#else
+    int flags = fcntl(static_cast<int>(socket), F_GETFL, 0);
+    fcntl(static_cast<int>(socket), F_SETFL, enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+#endif
+}
+
+// Connect with a timeout, so an unreachable member cannot stall the sender
+long long connectTo(const std::string& address) {
+    std::string host;
+    std::string port;
+    if (!splitAddress(address, host, port)) {
+        return INVALID;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0) {
+        return INVALID;
+    }
+
+    long long connected = INVALID;
+    for (addrinfo* ai = results; ai && connected == INVALID; ai = ai->ai_next) {
+        long long s = static_cast<long long>(socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol));
+        if (s < 0) {
+            continue;
+        }
+
+        setNonBlocking(s, true);
+        bool ok = connect(static_cast<int>(s), ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen)) == 0;
+        if (!ok) {
+            fd_set writable;
+            FD_ZERO(&writable);
+            FD_SET(static_cast<int>(s), &writable);
+            timeval timeout;
+            timeout.tv_sec = CONNECT_TIMEOUT_MS / 1000;
+            timeout.tv_usec = (CONNECT_TIMEOUT_MS % 1000) * 1000;
+            if (select(static_cast<int>(s) + 1, nullptr, &writable, nullptr, &timeout) > 0) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(static_cast<int>(s), SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+                ok = error == 0;
+            }
+        }
+        setNonBlocking(s, false);
+
+        if (ok) {
+            int noDelay = 1;
+            setsockopt(static_cast<int>(s), IPPROTO_TCP, TCP_NODELAY,
+                       reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+            connected = s;
+        } else {
+            CLOSE_SOCKET(static_cast<int>(s));
+        }
+    }
+
+    freeaddrinfo(results);
+    return connected;
+}
+
+bool sendAll(long long socket, const char* data, size_t size) {
+    while (size > 0) {
+        int sent = send(static_cast<int>(socket), data, static_cast<int>(std::min<size_t>(size, 1 << 30)), 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+std::string makeFrame(unsigned char type, const std::string& payload) {
+    uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+    std::string frame;
+    frame.reserve(5 + payload.size());
+    frame.push_back(static_cast<char>((length >> 24) & 0xff));
+    frame.push_back(static_cast<char>((length >> 16) & 0xff));
+    frame.push_back(static_cast<char>((length >> 8) & 0xff));
+    frame.push_back(static_cast<char>(length & 0xff));
+    frame.push_back(static_cast<char>(type));
+    frame += payload;
+    return frame;
+}
+
+std::string encodeUrls(std::vector<UrlExchange::Entry>& entries) {
+    std::string encoded = UrlExchange::encode(entries);
+    if (encoded.size() < COMPRESS_MIN_BYTES) {
+        return encoded;
+    }
+
+    // The receiver's inflater passes data without a gzip header through
+    std::string compressed;
+    if (gzipCompress(encoded.data(), encoded.size(), compressed) && compressed.size() < encoded.size()) {
+        return compressed;
+    }
+    return encoded;
+}
+
+} // namespace
+
+ClusterNode::ClusterNode(const Options& options, UrlHandler onUrl, MembershipHandler onMembershipChange,
+                         IdleProbe isLocallyIdle, Monitoring* monitoring)
+    : options(options)
+    , onUrl(std::move(onUrl))
+    , onMembershipChange(std::move(onMembershipChange))
+    , isLocallyIdle(std::move(isLocallyIdle))
+    , monitoring(monitoring)
+    , ring(options.virtualNodes)
+    , exchange({options.batchSize, 64 * 1024, options.flushInterval, options.recentCapacity})
+    , urlsSent(0)
+    , urlsReceived(0)
+    , batchesSent(0)
+    , batchBytesSent(0)
+    , quiescentCandidate(false)
+    , running(false)
+    , listenSocket(INVALID)
+    , messagesSent(0)
+    , messagesReceived(0)
+    , bytesSent(0)
+    , bytesReceived(0) {
+    this->options.batchSize = std::max<size_t>(1, options.batchSize);
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+ClusterNode::~ClusterNode() {
+    stop();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool ClusterNode::start(std::string& error) {
+    if (running) {
+        return true;
+    }
+
+    std::string host;
+    std::string port;
+    if (!splitAddress(options.self, host, port)) {
+        error = "Cluster node address must be host:port, got '" + options.self + "'";
+        return false;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0 || !results) {
+        error = "Cannot resolve cluster node address " + options.self;
+        return false;
+    }
+
+    long long s = static_cast<long long>(socket(results->ai_family, results->ai_socktype, results->ai_protocol));
+    if (s >= 0) {
+        int reuse = 1;
+        setsockopt(static_cast<int>(s), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        if (bind(static_cast<int>(s), results->ai_addr, static_cast<socklen_t>(results->ai_addrlen)) != 0 ||
+            listen(static_cast<int>(s), 128) != 0) {
+            CLOSE_SOCKET(static_cast<int>(s));
+            s = INVALID;
+        }
+    }
+    freeaddrinfo(results);
+    if (s < 0) {
+        error = "Cannot listen on " + options.self + ": " + std::strerror(errno);
+        return false;
+    }
+    listenSocket = s;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ring.addNode(options.self);
+        // Seeds count as live until the failure timeout says otherwise, so
+        // members started a little later are not dropped straight away
+        for (const auto& seed : options.seeds) {
+            if (seed != options.self) {
+                addMemberLocked(seed);
+            }
+        }
+        quiescentCandidate = false;
+    }
+
+    running = true;
+    receiver = std::thread(&ClusterNode::receiveLoop, this);
+    sender = std::thread(&ClusterNode::sendLoop, this);
+    return true;
+}
+
+void ClusterNode::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // The sender flushes every buffered URL and announces the departure first
+    senderCondition.notify_all();
+    if (sender.joinable()) {
+        sender.join();
+    }
+    if (receiver.joinable()) {
+        receiver.join();
+    }
+
+    CLOSE_SOCKET(static_cast<int>(listenSocket));
+    listenSocket = INVALID;
+
+    if (monitoring) {
+        Stats stats = getStats();
+        monitoring->log(Monitoring::LogLevel::INFO,
+                        "URL exchange: sent " + std::to_string(stats.urlsSent) + " URLs in " +
+                        std::to_string(stats.batchesSent) + " batches (" + std::to_string(stats.batchBytesSent) +
+                        " bytes), received " + std::to_string(stats.urlsReceived) + ", dropped " +
+                        std::to_string(stats.duplicatesDropped) + " repeats");
+    }
+}
+
+bool ClusterNode::addMemberLocked(const std::string& node) {
+    if (!ring.addNode(node)) {
+        return false;
+    }
+    Peer& peer = peers[node];
+    peer.lastSeen = Clock::now();
+    exchange.forgetRecent();
+    quiescentCandidate = false;
+    return true;
+}
+
+bool ClusterNode::owns(std::string_view url) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::string& owner = ring.ownerOf(HostFilter::hostOf(url));
+    return owner.empty() || owner == options.self;
+}
+
+void ClusterNode::forward(std::string url, int depth) {
+    // Messages are line-based; a URL with a raw line break is not valid anyway
+    if (url.find_first_of("\r\n") != std::string::npos) {
+        return;
+    }
+
+    bool queued = false;
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::string& owner = ring.ownerOf(HostFilter::hostOf(url));
+        if (peers.count(owner)) {
+            queued = true;
+            dropped = !exchange.add(owner, std::move(url), depth);
+            if (!dropped && exchange.hasFullBuffer()) {
+                senderCondition.notify_one();
+            }
+        }
+    }
+    if (queued) {
+        if (dropped && monitoring) {
+            monitoring->addCounter("exchange_duplicates_dropped", 1);
+        }
+        return;
+    }
+
+    // The ring changed since the caller checked: the host is ours now
+    onUrl(std::move(url), depth);
+}
+
+bool ClusterNode::isQuiescent() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    bool quiet = exchange.empty();
+    long long sent = urlsSent;
+    long long received = urlsReceived;
+    for (const auto& [node, peer] : peers) {
+        if (!quiet || !peer.heardFrom || !peer.reportedIdle) {
+            quiet = false;
+            break;
+        }
+        sent += peer.reportedSent;
+        received += peer.reportedReceived;
+    }
+    quiet = quiet && sent == received;
+
+    // Heartbeats are snapshots, so only trust a state that lasts
+    auto now = Clock::now();
+    if (!quiet) {
+        quiescentCandidate = false;
+        return false;
+    }
+    if (!quiescentCandidate) {
+        quiescentCandidate = true;
+        quiescentSince = now;
+    }
+    return now - quiescentSince >= 2 * options.heartbeatInterval;
+}
+
+std::vector<std::string> ClusterNode::getMembers() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ring.getNodes();
+}
+
+ClusterNode::Stats ClusterNode::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.urlsSent = urlsSent;
+        stats.urlsReceived = urlsReceived;
+        stats.batchesSent = batchesSent;
+        stats.batchBytesSent = batchBytesSent;
+        stats.duplicatesDropped = exchange.getStats().duplicatesDropped;
+        stats.members = ring.size();
+    }
+    stats.messagesSent = messagesSent;
+    stats.messagesReceived = messagesReceived;
+    stats.bytesSent = bytesSent;
+    stats.bytesReceived = bytesReceived;
+    return stats;
+}
+
+const std::string& ClusterNode::getSelf() const {
+    return options.self;
+}
+
+std::string ClusterNode::heartbeatPayload(bool idle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle = idle && exchange.empty();
+    std::string payload = options.self + " " + (idle ? "1" : "0") + " " + std::to_string(urlsSent) + " " +
+                          std::to_string(urlsReceived) + " ";
+
+    // Members gossip the ring, so joining through any one of them is enough
+    bool first = true;
+    for (const auto& node : ring.getNodes()) {
+        payload += first ? "" : ",";
+        payload += node;
+        first = false;
+    }
+    return payload;
+}
+
+void ClusterNode::sendLoop() {
+    // Outbound connections are only touched by this thread
+    std::map<std::string, long long> connections;
+    std::map<std::string, Clock::time_point> retryAt;
+    Clock::time_point nextHeartbeat = Clock::now();
+
+    auto sendFrame = [&](const std::string& node, const std::string& frame) {
+        auto it = connections.find(node);
+        if (it == connections.end()) {
+            auto retry = retryAt.find(node);
+            if (retry != retryAt.end() && Clock::now() < retry->second) {
+                return false;
+            }
+            long long s = connectTo(node);
+            if (s == INVALID) {
+                retryAt[node] = Clock::now() + options.heartbeatInterval;
+                return false;
+            }
+            retryAt.erase(node);
+            it = connections.emplace(node, s).first;
+        }
+        if (!sendAll(it->second, frame.data(), frame.size())) {
+            CLOSE_SOCKET(static_cast<int>(it->second));
+            connections.erase(it);
+            return false;
+        }
+        messagesSent++;
+        bytesSent += static_cast<long long>(frame.size());
+        return true;
+    };
+
+    while (true) {
+        bool finalRound = !running;
+        bool idle = isLocallyIdle ? isLocallyIdle() : true;
+        auto now = Clock::now();
+        bool heartbeatDue = now >= nextHeartbeat;
+
+        std::vector<UrlExchange::Batch> batches;
+        std::vector<std::string> targets;
+        std::vector<std::string> departed;
+        std::vector<UrlExchange::Entry> orphans;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = peers.begin(); it != peers.end();) {
+                Peer& peer = it->second;
+                if (peer.left || now - peer.lastSeen > options.failureTimeout) {
+                    departed.push_back(it->first);
+                    departedAt[it->first] = now;
+                    std::vector<UrlExchange::Entry> stranded = exchange.takeAll(it->first);
+                    orphans.insert(orphans.end(), std::make_move_iterator(stranded.begin()),
+                                   std::make_move_iterator(stranded.end()));
+                    ring.removeNode(it->first);
+                    exchange.forgetRecent();
+                    quiescentCandidate = false;
+                    it = peers.erase(it);
+                    continue;
+                }
+                targets.push_back(it->first);
+                ++it;
+            }
+            for (auto it = departedAt.begin(); it != departedAt.end();) {
+                it = now - it->second > 2 * options.failureTimeout ? departedAt.erase(it) : std::next(it);
+            }
+            batches = exchange.takeReady(now, finalRound);
+        }
+
+        for (const auto& node : departed) {
+            auto it = connections.find(node);
+            if (it != connections.end()) {
+                CLOSE_SOCKET(static_cast<int>(it->second));
+                connections.erase(it);
+            }
+            retryAt.erase(node);
+        }
+
+        for (auto& batch : batches) {
+            long long count = static_cast<long long>(batch.entries.size());
+            std::string frame = makeFrame(URLS, encodeUrls(batch.entries));
+            if (sendFrame(batch.destination, frame)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    urlsSent += count;
+                    batchesSent++;
+                    batchBytesSent += static_cast<long long>(frame.size());
+                }
+                if (monitoring) {
+                    monitoring->addCounter("exchange_urls_sent", count);
+                    monitoring->addCounter("exchange_batches_sent", 1);
+                    monitoring->addCounter("exchange_bytes_sent", static_cast<long long>(frame.size()));
+                    monitoring->recordLatency("exchange_delay", Clock::now() - batch.started);
+                }
+                continue;
+            }
+
+            // Keep the batch until the member is reachable again or declared gone
+            std::lock_guard<std::mutex> lock(mutex);
+            if (peers.count(batch.destination) && !finalRound) {
+                exchange.restore(std::move(batch));
+            }
+        }
+
+        if (heartbeatDue && !finalRound) {
+            std::string frame = makeFrame(HEARTBEAT, heartbeatPayload(idle));
+            for (const auto& node : targets) {
+                sendFrame(node, frame);
+            }
+            nextHeartbeat = now + options.heartbeatInterval;
+        }
+
+        for (const auto& node : departed) {
+            if (onMembershipChange) {
+                onMembershipChange(node, false);
+            }
+        }
+        for (auto& entry : orphans) {
+            forward(std::move(entry.url), entry.depth);
+        }
+
+        if (finalRound) {
+            std::string frame = makeFrame(LEAVE, options.self);
+            for (const auto& node : targets) {
+                sendFrame(node, frame);
+            }
+            for (const auto& [node, s] : connections) {
+                CLOSE_SOCKET(static_cast<int>(s));
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        senderCondition.wait_for(lock, std::min(options.flushInterval, options.heartbeatInterval), [this] {
+            return !running || exchange.hasFullBuffer();
+        });
+    }
+}
+
+void ClusterNode::receiveLoop() {
+    std::vector<Connection> connections;
+    std::vector<char> chunk(64 * 1024);
+
+    while (running) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(static_cast<int>(listenSocket), &readable);
+        int maxSocket = static_cast<int>(listenSocket);
+        for (const auto& connection : connections) {
+            FD_SET(static_cast<int>(connection.socket), &readable);
+            maxSocket = std::max(maxSocket, static_cast<int>(connection.socket));
+        }
+
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = POLL_INTERVAL_MS * 1000;
+        if (select(maxSocket + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        if (FD_ISSET(static_cast<int>(listenSocket), &readable)) {
+            long long s = static_cast<long long>(accept(static_cast<int>(listenSocket), nullptr, nullptr));
+            if (s >= 0) {
+                connections.push_back({s, std::string()});
+            }
+        }
+
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (!FD_ISSET(static_cast<int>(it->socket), &readable)) {
+                ++it;
+                continue;
+            }
+
+            int received = recv(static_cast<int>(it->socket), chunk.data(), static_cast<int>(chunk.size()), 0);
+            bool closed = received <= 0;
+            if (!closed) {
+                it->buffer.append(chunk.data(), static_cast<size_t>(received));
+            }
+
+            // Dispatch every complete frame
+            size_t offset = 0;
+            while (!closed && it->buffer.size() - offset >= 5) {
+                const unsigned char* header = reinterpret_cast<const unsigned char*>(it->buffer.data() + offset);
+                size_t length = (static_cast<size_t>(header[0]) << 24) | (static_cast<size_t>(header[1]) << 16) |
+                                (static_cast<size_t>(header[2]) << 8) | header[3];
+                if (length == 0 || length > MAX_FRAME_BYTES) {
+                    closed = true;
+                    break;
+                }
+                if (it->buffer.size() - offset < 4 + length) {
+                    break;
+                }
+                messagesReceived++;
+                bytesReceived += static_cast<long long>(4 + length);
+                handleFrame(header[4], it->buffer.substr(offset + 5, length - 1));
+                offset += 4 + length;
+            }
+            it->buffer.erase(0, offset);
+
+            if (closed) {
+                CLOSE_SOCKET(static_cast<int>(it->socket));
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (const auto& connection : connections) {
+        CLOSE_SOCKET(static_cast<int>(connection.socket));
+    }
+}
+
+void ClusterNode::handleFrame(unsigned char type, const std::string& payload) {
+    switch (type) {
+        case HEARTBEAT:
+            handleHeartbeat(payload);
+            break;
+        case LEAVE: {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = peers.find(payload);
+            if (it != peers.end()) {
+                // Removed by the sender, which also reroutes its buffered URLs
+                it->second.left = true;
+                senderCondition.notify_one();
+            }
+            break;
+        }
+        case URLS:
+            handleUrls(payload);
+            break;
+        default:
+            break;
+    }
+}
+
+void ClusterNode::handleHeartbeat(const std::string& payload) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (start <= payload.size()) {
+        size_t space = payload.find(' ', start);
+        if (space == std::string::npos) {
+            space = payload.size();
+        }
+        fields.push_back(payload.substr(start, space - start));
+        start = space + 1;
+    }
+    if (fields.size() < 4 || fields[0].empty() || fields[0] == options.self) {
+        return;
+    }
+
+    std::vector<std::string> joined;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = peers.find(fields[0]);
+        if (it == peers.end()) {
+            // Hearing from a node directly overrides its recent departure
+            departedAt.erase(fields[0]);
+            if (addMemberLocked(fields[0])) {
+                joined.push_back(fields[0]);
+            }
+            it = peers.find(fields[0]);
+        }
+        Peer& peer = it->second;
+        peer.lastSeen = Clock::now();
+        peer.heardFrom = true;
+        peer.left = false;
+        peer.reportedIdle = fields[1] == "1";
+        peer.reportedSent = std::strtoll(fields[2].c_str(), nullptr, 10);
+        peer.reportedReceived = std::strtoll(fields[3].c_str(), nullptr, 10);
+
+        // Members the sender knows about; ones that departed recently may
+        // still be gossiped by nodes that have not timed them out yet
+        size_t memberStart = 0;
+        const std::string members = fields.size() > 4 ? fields[4] : std::string();
+        while (memberStart < members.size()) {
+            size_t comma = members.find(',', memberStart);
+            if (comma == std::string::npos) {
+                comma = members.size();
+            }
+            std::string member = members.substr(memberStart, comma - memberStart);
+            memberStart = comma + 1;
+            if (!member.empty() && member != options.self && !departedAt.count(member) &&
+                addMemberLocked(member)) {
+                joined.push_back(member);
+            }
+        }
+    }
+
+    if (onMembershipChange) {
+        for (const auto& node : joined) {
+            onMembershipChange(node, true);
+        }
+    }
+}
+
+void ClusterNode::handleUrls(const std::string& payload) {
+    std::string encoded;
+    GzipInflater inflater([&encoded](const char* data, size_t size) {
+        encoded.append(data, size);
+        return true;
+    });
+    std::vector<std::pair<std::string, int>> urls;
+    if (!inflater.feed(payload.data(), payload.size()) || !inflater.finish() ||
+        !UrlExchange::decode(encoded, urls)) {
+        if (monitoring) {
+            monitoring->log(Monitoring::LogLevel::WARNING, "Dropped a malformed URL batch");
+        }
+        return;
+    }
+
+    long long count = static_cast<long long>(urls.size());
+    for (auto& [url, depth] : urls) {
+        onUrl(std::move(url), depth);
+    }
+    if (monitoring) {
+        monitoring->addCounter("exchange_urls_received", count);
+        monitoring->addCounter("exchange_bytes_received", static_cast<long long>(payload.size()));
+    }
+
+    // Counted once scheduled, so the cluster never looks finished in between
+    std::lock_guard<std::mutex> lock(mutex);
+    urlsReceived += count;
+}
@@ -0,0 +1,312 @@
+#include "../include/columnar_writer.hpp"
+#include "../include/compression.hpp"
+#include "../include/fnv_hash.hpp"
+#include "../include/varint.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+const char MAGIC[4] = {'W', 'C', 'O', 'L'};
+const unsigned char FORMAT_VERSION = 1;
+
+enum Encoding : unsigned char {
+    PLAIN = 0,
+    DICTIONARY = 1
+};
+
+enum Compression : unsigned char {
+    UNCOMPRESSED = 0,
+    GZIP = 1
+};
+
+// Row groups are buffered in this many slots, picked by thread
+const size_t SLOT_COUNT = 16;
+
+// Chunks smaller than this are not worth compressing
+const size_t COMPRESS_MIN_BYTES = 256;
+
+void putSigned(std::string& out, long long value) {
+    putVarint(out, zigzagEncode(value));
+}
+
+void putString(std::string& out, std::string_view value) {
+    putVarint(out, value.size());
+    out.append(value.data(), value.size());
+}
+
+std::string encodeIntegers(const std::vector<long long>& values, unsigned char& encoding) {
+    encoding = PLAIN;
+    std::string out;
+    out.reserve(values.size() * 2);
+    for (long long value : values) {
+        putSigned(out, value);
+    }
+    return out;
+}
+
+std::string encodeHashes(const std::vector<uint64_t>& values, unsigned char& encoding) {
+    encoding = PLAIN;
+    std::string out;
+    out.reserve(values.size() * 8);
+    for (uint64_t value : values) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xff));
+        }
+    }
+    return out;
+}
+
+// Dictionary-encode when values repeat enough to pay for the dictionary
+std::string encodeStrings(const std::vector<std::string>& values, unsigned char& encoding) {
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<std::string_view> dictionary;
+    size_t limit = values.size() / 2;
+    for (const auto& value : values) {
+        if (ids.emplace(value, static_cast<uint32_t>(dictionary.size())).second) {
+            dictionary.push_back(value);
+            if (dictionary.size() > limit) {
+                break;
+            }
+        }
+    }
+
+    std::string out;
+    if (dictionary.size() > limit) {
+        encoding = PLAIN;
+        for (const auto& value : values) {
+            putString(out, value);
+        }
+        return out;
+    }
+
+    encoding = DICTIONARY;
+    putVarint(out, dictionary.size());
+    for (const auto& value : dictionary) {
+        putString(out, value);
+    }
+    for (const auto& value : values) {
+        putVarint(out, ids[value]);
+    }
+    return out;
+}
+
+} // namespace
+
+// Column buffers of one row group, in schema order
+struct ColumnarWriter::RowGroup {
+    std::vector<std::string> url;
+    std::vector<std::string> host;
+    std::vector<long long> depth;
+    std::vector<long long> status;
+    std::vector<std::string> contentType;
+    std::vector<long long> bytes;
+    std::vector<long long> wireBytes;
+    std::vector<long long> fetchMicros;
+    std::vector<long long> processMicros;
+    std::vector<long long> fetchedAt;
+    std::vector<uint64_t> contentHash;
+    std::vector<std::string> language;
+
+    size_t size() const { return url.size(); }
+};
+
+const std::vector<ColumnarWriter::Column>& ColumnarWriter::getSchema() {
+    static const std::vector<Column> schema = {
+        {"url", ColumnType::STRING},
+        {"host", ColumnType::STRING},
+        {"depth", ColumnType::INT64},
+        {"status", ColumnType::INT64},
+        {"content_type", ColumnType::STRING},
+        {"bytes", ColumnType::INT64},
+        {"wire_bytes", ColumnType::INT64},
+        {"fetch_us", ColumnType::INT64},
+        {"process_us", ColumnType::INT64},
+        {"fetched_at_ms", ColumnType::INT64},
+        {"content_hash", ColumnType::HASH64},
+        {"language", ColumnType::STRING},
+    };
+    return schema;
+}
+
+uint64_t ColumnarWriter::hashContent(std::string_view content) {
+    if (content.empty()) {
+        return 0;
+    }
+    uint64_t hash = fnv1a(content);
+    return hash ? hash : 1;
+}
+
+ColumnarWriter::ColumnarWriter(const std::string& path, size_t rowGroupRows)
+    : rowGroupRows(std::max<size_t>(1, rowGroupRows))
+    , rowCount(0)
+    , file(path, std::ios::binary | std::ios::trunc)
+    , offset(0)
+    , groupCount(0)
+    , writtenRows(0)
+    , failed(false)
+    , closed(false) {
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        slots.push_back(std::make_unique<Slot>());
+    }
+    if (file.is_open()) {
+        file.write(MAGIC, sizeof(MAGIC));
+        file.put(static_cast<char>(FORMAT_VERSION));
+        offset = sizeof(MAGIC) + 1;
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    close();
+}
+
+bool ColumnarWriter::isOpen() const {
+    return file.is_open();
+}
+
+void ColumnarWriter::append(const CrawlRecord& record) {
+    Slot& slot = *slots[std::hash<std::thread::id>()(std::this_thread::get_id()) % slots.size()];
+
+    std::unique_ptr<RowGroup> full;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (!slot.rows) {
+            slot.rows = std::make_unique<RowGroup>();
+        }
+        RowGroup& rows = *slot.rows;
+        rows.url.push_back(record.url);
+        rows.host.push_back(record.host);
+        rows.depth.push_back(record.depth);
+        rows.status.push_back(record.status);
+        rows.contentType.push_back(record.contentType);
+        rows.bytes.push_back(record.bytes);
+        rows.wireBytes.push_back(record.wireBytes);
+        rows.fetchMicros.push_back(record.fetchMicros);
+        rows.processMicros.push_back(record.processMicros);
+        rows.fetchedAt.push_back(record.fetchedAt);
+        rows.contentHash.push_back(record.contentHash);
+        rows.language.push_back(record.language);
+        if (rows.size() >= rowGroupRows) {
+            full = std::move(slot.rows);
+        }
+    }
+    rowCount++;
+
+    if (full) {
+        writeRowGroup(*full);
+    }
+}
+
+void ColumnarWriter::writeRowGroup(const RowGroup& rows) {
+    if (rows.size() == 0) {
+        return;
+    }
+
+    // Encode and compress every column before taking the file lock
+    std::vector<std::string> chunks;
+    auto addChunk = [&chunks](unsigned char encoding, const std::string& raw) {
+        std::string compressed;
+        bool useCompressed = raw.size() >= COMPRESS_MIN_BYTES &&
+                             gzipCompress(raw.data(), raw.size(), compressed) && compressed.size() < raw.size();
+        const std::string& stored = useCompressed ? compressed : raw;
+
+        std::string chunk;
+        chunk.reserve(stored.size() + 16);
+        chunk.push_back(static_cast<char>(encoding));
+        chunk.push_back(static_cast<char>(useCompressed ? GZIP : UNCOMPRESSED));
+        putVarint(chunk, raw.size());
+        putVarint(chunk, stored.size());
+        chunk += stored;
+        chunks.push_back(std::move(chunk));
+    };
+
+    unsigned char encoding;
+    std::string raw;
+    raw = encodeStrings(rows.url, encoding);
+    addChunk(encoding, raw);
+    raw = encodeStrings(rows.host, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.depth, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.status, encoding);
+    addChunk(encoding, raw);
+    raw = encodeStrings(rows.contentType, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.bytes, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.wireBytes, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.fetchMicros, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.processMicros, encoding);
+    addChunk(encoding, raw);
+    raw = encodeIntegers(rows.fetchedAt, encoding);
+    addChunk(encoding, raw);
+    raw = encodeHashes(rows.contentHash, encoding);
+    addChunk(encoding, raw);
+    raw = encodeStrings(rows.language, encoding);
+    addChunk(encoding, raw);
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (!file.is_open() || closed) {
+        return;
+    }
+
+    putVarint(footerGroups, rows.size());
+    for (const auto& chunk : chunks) {
+        putVarint(footerGroups, offset);
+        putVarint(footerGroups, chunk.size());
+        file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        offset += chunk.size();
+    }
+    groupCount++;
+    writtenRows += static_cast<long long>(rows.size());
+    failed = failed || !file;
+}
+
+bool ColumnarWriter::close() {
+    for (auto& slot : slots) {
+        std::unique_ptr<RowGroup> rows;
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            rows = std::move(slot->rows);
+        }
+        if (rows) {
+            writeRowGroup(*rows);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (!file.is_open() || closed) {
+        return !failed;
+    }
+    closed = true;
+
+    std::string footer;
+    const auto& schema = getSchema();
+    putVarint(footer, schema.size());
+    for (const auto& column : schema) {
+        putString(footer, column.name);
+        footer.push_back(static_cast<char>(column.type));
+    }
+    putVarint(footer, groupCount);
+    footer += footerGroups;
+    putVarint(footer, static_cast<uint64_t>(writtenRows));
+
+    uint32_t footerSize = static_cast<uint32_t>(footer.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        footer.push_back(static_cast<char>((footerSize >> shift) & 0xff));
+    }
+    footer.append(MAGIC, sizeof(MAGIC));
+
+    file.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    file.close();
+    failed = failed || !file;
+    return !failed;
+}
+
+long long ColumnarWriter::getRowCount() const {
+    return rowCount;
+}
@@ -0,0 +1,193 @@
+#include "../include/compression.hpp"
+#include <cstring>
+
+#ifndef STUB_IMPLEMENTATION
+#include <zlib.h>
+#endif
+
+namespace {
+
+const size_t OUTPUT_WINDOW = 16 * 1024;
+
+bool hasGzipMagic(const std::string& header) {
+    return static_cast<unsigned char>(header[0]) == 0x1f &&
+           static_cast<unsigned char>(header[1]) == 0x8b;
+}
+
+} // namespace
+
+GzipInflater::GzipInflater(OutputCallback output)
+    : output(std::move(output))
+    , mode(Mode::DETECT)
+    , stream(nullptr)
+    , streamEnded(false) {
+}
+
+GzipInflater::~GzipInflater() {
+#ifndef STUB_IMPLEMENTATION
+    if (stream) {
+        z_stream* zs = static_cast<z_stream*>(stream);
+        inflateEnd(zs);
+        delete zs;
+    }
+#endif
+}
+
+bool GzipInflater::feed(const char* data, size_t size) {
+    if (mode == Mode::DETECT) {
+        // Hold bytes back until the two-byte header is complete
+        size_t needed = 2 - header.size();
+        size_t take = size < needed ? size : needed;
+        header.append(data, take);
+        data += take;
+        size -= take;
+        if (header.size() < 2) {
+            return true;
+        }
+
+        std::string held;
+        held.swap(header);
+        if (hasGzipMagic(held)) {
+            if (!startInflate() || !inflateChunk(held.data(), held.size())) {
+                return false;
+            }
+        } else {
+            mode = Mode::PASSTHROUGH;
+            if (!output(held.data(), held.size())) {
+                return false;
+            }
+        }
+    }
+
+    if (size == 0) {
+        return mode != Mode::FAILED;
+    }
+
+    switch (mode) {
+        case Mode::PASSTHROUGH:
+            return output(data, size);
+        case Mode::INFLATE:
+            return inflateChunk(data, size);
+        default:
+            return false;
+    }
+}
+
+bool GzipInflater::finish() {
+    if (mode == Mode::DETECT) {
+        // Fewer than two bytes in total: cannot be compressed
+        mode = Mode::PASSTHROUGH;
+        return header.empty() || output(header.data(), header.size());
+    }
+    if (mode == Mode::INFLATE && !streamEnded) {
+        error = "Compressed stream is truncated";
+        mode = Mode::FAILED;
+    }
+    return mode != Mode::FAILED;
+}
+
+bool GzipInflater::isCompressed() const {
+    return stream != nullptr;
+}
+
+const std::string& GzipInflater::getError() const {
+    return error;
+}
+
+bool GzipInflater::startInflate() {
+#ifdef STUB_IMPLEMENTATION
+    error = "Built without zlib; compressed input is not supported";
+    mode = Mode::FAILED;
+    return false;
+#else
+    z_stream* zs = new z_stream();
+    std::memset(zs, 0, sizeof(*zs));
+
+    // 15 + 16: maximum window, gzip framing
+    if (inflateInit2(zs, 15 + 16) != Z_OK) {
+        delete zs;
+        error = "Failed to initialize zlib";
+        mode = Mode::FAILED;
+        return false;
+    }
+
+    stream = zs;
+    mode = Mode::INFLATE;
+    return true;
+#endif
+}
+
+bool GzipInflater::inflateChunk(const char* data, size_t size) {
+#ifdef STUB_IMPLEMENTATION
+    (void)data;
+    (void)size;
+    return false;
+#else
+    z_stream* zs = static_cast<z_stream*>(stream);
+    char window[OUTPUT_WINDOW];
+
+    zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs->avail_in = static_cast<uInt>(size);
+
+    size_t produced;
+    do {
+        if (streamEnded) {
+            if (zs->avail_in == 0) {
+                break;
+            }
+            // Another gzip member follows the previous one
+            inflateReset(zs);
+            streamEnded = false;
+        }
+
+        zs->next_out = reinterpret_cast<Bytef*>(window);
+        zs->avail_out = static_cast<uInt>(sizeof(window));
+
+        int result = inflate(zs, Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+            error = zs->msg ? zs->msg : "Corrupt compressed stream";
+            mode = Mode::FAILED;
+            return false;
+        }
+
+        produced = sizeof(window) - zs->avail_out;
+        if (produced > 0 && !output(window, produced)) {
+            return false;
+        }
+
+        if (result == Z_STREAM_END) {
+            streamEnded = true;
+        } else if (result == Z_BUF_ERROR && produced == 0) {
+            break;
+        }
+        // A full window may leave more output buffered inside zlib
+    } while (zs->avail_in > 0 || produced == sizeof(window));
+
+    return true;
+#endif
+}
+
+bool gzipCompress(const char* data, size_t size, std::string& output, int level) {
+#ifdef STUB_IMPLEMENTATION
+    (void)data;
+    (void)size;
+    (void)output;
+    (void)level;
+    return false;
+#else
+    z_stream stream = {};
+    // Window bits 15 + 16 selects the gzip wrapper
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    output.resize(deflateBound(&stream, static_cast<uLong>(size)));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+#endif
+}
@@ -72,6 +72,9 @@ void Config::parseConfig() {
         followRedirects = crawler.value("follow_redirects", followRedirects);
         timeoutSeconds = crawler.value("timeout_seconds", timeoutSeconds);
         retryCount = crawler.value("retry_count", retryCount);
+        compressedTransfer = crawler.value("compressed_transfer", compressedTransfer);
+        seedFromSitemaps = crawler.value("seed_from_sitemaps", seedFromSitemaps);
+        sitemapUrls = crawler.value("sitemap_urls", sitemapUrls);
     }
     
     // Threading settings
@@ -90,6 +93,7 @@ void Config::parseConfig() {
         saveImages = storage.value("save_images", saveImages);
         imageDirectory = storage.value("image_directory", imageDirectory);
         contentDirectory = storage.value("content_directory", contentDirectory);
+        resultsFile = storage.value("results_file", resultsFile);
         
         // Create directories if they don't exist
         if (!imageDirectory.empty()) {
@@ -104,29 +108,20 @@ void Config::parseConfig() {
     if (configData.contains("filters")) {
         auto& filters = configData["filters"];
         
-        // We can't use iteration methods with the stub implementation
-        // So we'll use a simpler approach for arrays
-        // This won't actually work in minimal build but will compile
-        
         if (filters.contains("allowed_domains")) {
-            // In a real implementation, we would iterate through the array
-            // For the stub, we'll just use the default values
-            // allowedDomains = filters["allowed_domains"];
+            allowedDomains = filters.value("allowed_domains", allowedDomains);
         }
         
         if (filters.contains("allowed_paths")) {
-            // Similar stub implementation
-            // allowedPaths = filters["allowed_paths"];
+            allowedPaths = filters.value("allowed_paths", allowedPaths);
         }
         
         if (filters.contains("excluded_paths")) {
-            // Similar stub implementation
-            // excludedPaths = filters["excluded_paths"];
+            excludedPaths = filters.value("excluded_paths", excludedPaths);
         }
         
         if (filters.contains("allowed_extensions")) {
-            // Similar stub implementation
-            // allowedExtensions = filters["allowed_extensions"];
+            allowedExtensions = filters.value("allowed_extensions", allowedExtensions);
         }
         
         if (filters.contains("image_extensions")) {
@@ -155,6 +150,87 @@ void Config::parseConfig() {
             }
         }
     }
+    
+    // Advanced settings
+    if (configData.contains("advanced")) {
+        auto& advanced = configData["advanced"];
+        maxFileSizeMB = advanced.value("max_file_size_mb", maxFileSizeMB);
+        dnsResolverThreads = advanced.value("dns_resolver_threads", dnsResolverThreads);
+        dnsCacheTtlSeconds = advanced.value("dns_cache_ttl_seconds", dnsCacheTtlSeconds);
+        dnsNegativeTtlSeconds = advanced.value("dns_negative_ttl_seconds", dnsNegativeTtlSeconds);
+        robotsCacheSize = advanced.value("robots_cache_size", robotsCacheSize);
+        robotsFetchThreads = advanced.value("robots_fetch_threads", robotsFetchThreads);
+        detectDuplicates = advanced.value("detect_duplicates", detectDuplicates);
+        nearDuplicateDistance = advanced.value("near_duplicate_distance", nearDuplicateDistance);
+        detectUrlTraps = advanced.value("detect_url_traps", detectUrlTraps);
+        urlPatternSoftLimit = advanced.value("url_pattern_soft_limit", urlPatternSoftLimit);
+        urlPatternHardLimit = advanced.value("url_pattern_hard_limit", urlPatternHardLimit);
+        maxRepeatedSegments = advanced.value("max_repeated_segments", maxRepeatedSegments);
+        replayArchive = advanced.value("replay_archive", replayArchive);
+        recordArchive = advanced.value("record_archive", recordArchive);
+        fetcher = advanced.value("fetcher", fetcher);
+    }
+    
+    // Synthetic web settings
+    if (configData.contains("synthetic")) {
+        auto& synthetic = configData["synthetic"];
+        syntheticPageCount = synthetic.value("page_count", syntheticPageCount);
+        syntheticFanout = synthetic.value("fanout", syntheticFanout);
+        syntheticPageKB = synthetic.value("page_kb", syntheticPageKB);
+        syntheticLatencyMs = synthetic.value("latency_ms", syntheticLatencyMs);
+        syntheticLatencyP99Ms = synthetic.value("latency_p99_ms", syntheticLatencyP99Ms);
+        syntheticErrorRate = synthetic.value("error_rate", syntheticErrorRate);
+        syntheticRedirectRate = synthetic.value("redirect_rate", syntheticRedirectRate);
+        syntheticSeed = synthetic.value("seed", syntheticSeed);
+        syntheticHostCount = synthetic.value("host_count", syntheticHostCount);
+    }
+    
+    // Cluster settings
+    if (configData.contains("cluster")) {
+        auto& cluster = configData["cluster"];
+        clusterNode = cluster.value("node", clusterNode);
+        if (cluster.contains("peers")) {
+            clusterPeers = cluster.value("peers", clusterPeers);
+        }
+        clusterVirtualNodes = cluster.value("virtual_nodes", clusterVirtualNodes);
+        clusterBatchSize = cluster.value("batch_size", clusterBatchSize);
+        clusterFlushIntervalMs = cluster.value("flush_interval_ms", clusterFlushIntervalMs);
+        clusterRecentUrls = cluster.value("recent_urls", clusterRecentUrls);
+        clusterHeartbeatIntervalMs = cluster.value("heartbeat_interval_ms", clusterHeartbeatIntervalMs);
+        clusterFailureTimeoutMs = cluster.value("failure_timeout_ms", clusterFailureTimeoutMs);
+    }
+    
+    // Link graph settings
+    if (configData.contains("link_graph")) {
+        auto& linkGraph = configData["link_graph"];
+        linkGraphEnabled = linkGraph.value("enabled", linkGraphEnabled);
+        linkRankAlgorithm = linkGraph.value("algorithm", linkRankAlgorithm);
+        linkRankIntervalSeconds = linkGraph.value("rank_interval_seconds", linkRankIntervalSeconds);
+        linkRankIterations = linkGraph.value("iterations", linkRankIterations);
+        linkRankDamping = linkGraph.value("damping", linkRankDamping);
+        linkRankThreads = linkGraph.value("threads", linkRankThreads);
+        linkRankWeight = linkGraph.value("weight", linkRankWeight);
+    }
+    
+    // Focused crawl settings
+    if (configData.contains("focus")) {
+        auto& focus = configData["focus"];
+        focusTopic = focus.value("topic", focusTopic);
+        focusAnchorWeight = focus.value("anchor_weight", focusAnchorWeight);
+        focusMinRelevance = focus.value("min_relevance", focusMinRelevance);
+    }
+    
+    // Inference settings
+    if (configData.contains("inference")) {
+        auto& inference = configData["inference"];
+        inferenceBackend = inference.value("backend", inferenceBackend);
+        pageModel = inference.value("page_model", pageModel);
+        imageModel = inference.value("image_model", imageModel);
+        inferenceBatchSize = inference.value("batch_size", inferenceBatchSize);
+        inferenceMaxLatencyMs = inference.value("max_latency_ms", inferenceMaxLatencyMs);
+        inferenceThreads = inference.value("threads", inferenceThreads);
+        inferenceQueueLimit = inference.value("queue_limit", inferenceQueueLimit);
+    }
 }
 
 // Getter methods implementation
@@ -166,6 +242,9 @@ bool Config::getRespectRobotsTxt() const { return respectRobotsTxt; }
 bool Config::getFollowRedirects() const { return followRedirects; }
 int Config::getTimeoutSeconds() const { return timeoutSeconds; }
 int Config::getRetryCount() const { return retryCount; }
+bool Config::getCompressedTransfer() const { return compressedTransfer; }
+bool Config::getSeedFromSitemaps() const { return seedFromSitemaps; }
+const std::vector<std::string>& Config::getSitemapUrls() const { return sitemapUrls; }
 
 int Config::getThreadCount() const { return threadCount; }
 int Config::getQueueSizeLimit() const { return queueSizeLimit; }
@@ -176,6 +255,7 @@ bool Config::getSaveHtml() const { return saveHtml; }
 bool Config::getSaveImages() const { return saveImages; }
 std::string Config::getImageDirectory() const { return imageDirectory; }
 std::string Config::getContentDirectory() const { return contentDirectory; }
+std::string Config::getResultsFile() const { return resultsFile; }
 
 const std::vector<std::string>& Config::getAllowedDomains() const { return allowedDomains; }
 const std::vector<std::string>& Config::getAllowedPaths() const { return allowedPaths; }
@@ -187,4 +267,57 @@ std::string Config::getLogLevel() const { return logLevel; }
 std::string Config::getLogFilePath() const { return logFilePath; }
 std::string Config::getLogFile() const { return logFile; }
 bool Config::getEnableConsoleOutput() const { return enableConsoleOutput; }
-int Config::getStatusUpdateInterval() const { return statusUpdateInterval; } 
\ No newline at end of file
+int Config::getStatusUpdateInterval() const { return statusUpdateInterval; }
+
+int Config::getMaxFileSizeMB() const { return maxFileSizeMB; }
+int Config::getDnsResolverThreads() const { return dnsResolverThreads; }
+int Config::getDnsCacheTtlSeconds() const { return dnsCacheTtlSeconds; }
+int Config::getDnsNegativeTtlSeconds() const { return dnsNegativeTtlSeconds; }
+int Config::getRobotsCacheSize() const { return robotsCacheSize; }
+int Config::getRobotsFetchThreads() const { return robotsFetchThreads; }
+bool Config::getDetectDuplicates() const { return detectDuplicates; }
+int Config::getNearDuplicateDistance() const { return nearDuplicateDistance; }
+bool Config::getDetectUrlTraps() const { return detectUrlTraps; }
+int Config::getUrlPatternSoftLimit() const { return urlPatternSoftLimit; }
+int Config::getUrlPatternHardLimit() const { return urlPatternHardLimit; }
+int Config::getMaxRepeatedSegments() const { return maxRepeatedSegments; }
+std::string Config::getReplayArchive() const { return replayArchive; }
+std::string Config::getRecordArchive() const { return recordArchive; }
+std::string Config::getFetcher() const { return fetcher; }
+
+int Config::getSyntheticPageCount() const { return syntheticPageCount; }
+int Config::getSyntheticFanout() const { return syntheticFanout; }
+int Config::getSyntheticPageKB() const { return syntheticPageKB; }
+double Config::getSyntheticLatencyMs() const { return syntheticLatencyMs; }
+double Config::getSyntheticLatencyP99Ms() const { return syntheticLatencyP99Ms; }
+double Config::getSyntheticErrorRate() const { return syntheticErrorRate; }
+double Config::getSyntheticRedirectRate() const { return syntheticRedirectRate; }
+int Config::getSyntheticSeed() const { return syntheticSeed; }
+int Config::getSyntheticHostCount() const { return syntheticHostCount; }
+
+std::string Config::getClusterNode() const { return clusterNode; }
+const std::vector<std::string>& Config::getClusterPeers() const { return clusterPeers; }
+int Config::getClusterVirtualNodes() const { return clusterVirtualNodes; }
+int Config::getClusterBatchSize() const { return clusterBatchSize; }
+int Config::getClusterFlushIntervalMs() const { return clusterFlushIntervalMs; }
+int Config::getClusterRecentUrls() const { return clusterRecentUrls; }
+int Config::getClusterHeartbeatIntervalMs() const { return clusterHeartbeatIntervalMs; }
+int Config::getClusterFailureTimeoutMs() const { return clusterFailureTimeoutMs; }
+
+bool Config::getLinkGraphEnabled() const { return linkGraphEnabled; }
+std::string Config::getLinkRankAlgorithm() const { return linkRankAlgorithm; }
+int Config::getLinkRankIntervalSeconds() const { return linkRankIntervalSeconds; }
+int Config::getLinkRankIterations() const { return linkRankIterations; }
+double Config::getLinkRankDamping() const { return linkRankDamping; }
+int Config::getLinkRankThreads() const { return linkRankThreads; }
+double Config::getLinkRankWeight() const { return linkRankWeight; }
+std::string Config::getFocusTopic() const { return focusTopic; }
+double Config::getFocusAnchorWeight() const { return focusAnchorWeight; }
+double Config::getFocusMinRelevance() const { return focusMinRelevance; }
+std::string Config::getInferenceBackend() const { return inferenceBackend; }
+std::string Config::getPageModel() const { return pageModel; }
+std::string Config::getImageModel() const { return imageModel; }
+int Config::getInferenceBatchSize() const { return inferenceBatchSize; }
+int Config::getInferenceMaxLatencyMs() const { return inferenceMaxLatencyMs; }
+int Config::getInferenceThreads() const { return inferenceThreads; }
+int Config::getInferenceQueueLimit() const { return inferenceQueueLimit; } 
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "content_analyzer.hpp"
+#include "topic_scorer.hpp"
 #include <stdexcept>
 #include <algorithm>
-#include <regex>
 #include <fstream>
 #include <sstream>
 #include <limits>
@@ -19,6 +19,12 @@ ContentAnalyzer::ContentAnalyzer() {
     topicModel = std::make_unique<TorchModule>();
     spamModel = std::make_unique<TorchModule>();
     entityModel = std::make_unique<TorchModule>();
+    
+    spamTerms = std::make_unique<KeywordMatcher>();
+    for (const char* term : {"viagra", "lottery", "prize", "million dollars", "free money", "casino"}) {
+        spamTerms->add(term);
+    }
+    spamTerms->build();
 }
 
 ContentAnalyzer::~ContentAnalyzer() {
@@ -29,10 +35,10 @@ ContentAnalyzer::ContentFeatures ContentAnalyzer::analyzeContent(const std::stri
     ContentFeatures features;
     
     // Preprocess content
-    std::string processed = preprocessText(content);
+    preprocessText(content);
     
     // Run analysis - stub implementation
-    features.language = "en";
+    features.language = detectLanguage(content);
     features.topics = {"news", "technology"};
     features.relevance = 0.75;
     features.isSpam = false;
@@ -42,60 +48,44 @@ ContentAnalyzer::ContentFeatures ContentAnalyzer::analyzeContent(const std::stri
 }
 
 std::vector<std::string> ContentAnalyzer::extractKeywords(const std::string& content) {
-    std::string processed = preprocessText(content);
+    preprocessText(content);
     
     // Stub implementation
     return {"keyword1", "keyword2", "keyword3"};
 }
 
 double ContentAnalyzer::calculateRelevance(const std::string& content, const std::string& query) {
-    std::string processedContent = preprocessText(content);
-    std::string processedQuery = preprocessText(query);
-    
-    // Stub implementation - basic relevance calculation
-    double relevance = 0.0;
-    std::istringstream queryStream(processedQuery);
-    std::string queryWord;
-    while (queryStream >> queryWord) {
-        if (processedContent.find(queryWord) != std::string::npos) {
-            relevance += 0.2;  // Add 0.2 for each matched word
-        }
-    }
-    
-    return std::min(relevance, 1.0);  // Cap at 1.0
+    // Callers scoring many pages against one query should keep a TopicScorer
+    return TopicScorer(query).scoreHtml(content);
 }
 
 bool ContentAnalyzer::isSpam(const std::string& content) {
-    std::string processed = preprocessText(content);
-    
-    // Basic spam detection
-    static const std::vector<std::string> spamWords = {
-        "viagra", "lottery", "prize", "million dollars", "free money", "casino"
-    };
-    
-    for (const auto& word : spamWords) {
-        if (processed.find(word) != std::string::npos) {
-            return true;
-        }
-    }
-    
-    return false;
+    // Every spam term is looked for in one scan of the page; weighted hits
+    // adding up to 1 make it spam
+    return spamTerms->score(content) >= 1.0;
 }
 
 std::vector<std::string> ContentAnalyzer::extractEntities(const std::string& content) {
-    std::string processed = preprocessText(content);
+    // Names need their case, so this text is not lowercased
+    const std::string& processed = preprocessText(content, TextNormalizer::Case::PRESERVE);
     
     // Simple stub implementation for entity extraction
     std::vector<std::string> entities;
     
-    // Extract capitalized words (very simplified entity extraction)
-    std::regex entityRegex("\\b[A-Z][a-z]+\\b");
-    std::smatch matches;
-    std::string::const_iterator searchStart(processed.cbegin());
-    
-    while (std::regex_search(searchStart, processed.cend(), matches, entityRegex)) {
-        entities.push_back(matches[0]);
-        searchStart = matches.suffix().first;
+    // Extract capitalized words (very simplified entity extraction): an
+    // uppercase letter followed only by lowercase ones
+    size_t start = 0;
+    while (start < processed.size()) {
+        size_t end = processed.find(' ', start);
+        if (end == std::string::npos) {
+            end = processed.size();
+        }
+        if (end - start >= 2 && processed[start] >= 'A' && processed[start] <= 'Z' &&
+            std::all_of(processed.begin() + start + 1, processed.begin() + end,
+                        [](char c) { return c >= 'a' && c <= 'z'; })) {
+            entities.emplace_back(processed, start, end - start);
+        }
+        start = end + 1;
     }
     
     return entities;
@@ -104,54 +94,34 @@ std::vector<std::string> ContentAnalyzer::extractEntities(const std::string& con
 void ContentAnalyzer::loadModels(const std::string& modelDir) {
     // Stub implementation
     // In a real implementation, this would load models from files
+    auto terms = std::make_unique<KeywordMatcher>();
+    if (terms->load(modelDir + "/spam_terms.txt") && !terms->empty()) {
+        terms->build();
+        spamTerms = std::move(terms);
+    }
 }
 
 void ContentAnalyzer::saveModels(const std::string& modelDir) {
+    (void)modelDir;
     // Stub implementation
     // In a real implementation, this would save models to files
 }
 
-std::string ContentAnalyzer::preprocessText(const std::string& text) {
-    // Convert to lowercase
-    std::string processed = text;
-    std::transform(processed.begin(), processed.end(), processed.begin(), ::tolower);
-    
-    // Remove HTML tags
-    std::regex htmlRegex("<[^>]*>");
-    processed = std::regex_replace(processed, htmlRegex, "");
-    
-    // Remove special characters
-    std::regex specialRegex("[^a-z0-9\\s]");
-    processed = std::regex_replace(processed, specialRegex, " ");
-    
-    // Remove extra whitespace
-    std::regex whitespaceRegex("\\s+");
-    processed = std::regex_replace(processed, whitespaceRegex, " ");
-    
+const std::string& ContentAnalyzer::preprocessText(std::string_view text, TextNormalizer::Case letterCase) {
+    // Tags, punctuation and whitespace runs go in one pass, into a buffer
+    // that keeps its capacity from page to page
+    thread_local std::string processed;
+    TextNormalizer::normalize(text, processed, letterCase);
     return processed;
 }
 
-std::vector<float> ContentAnalyzer::tokenize(const std::string& text) {
-    // Simple word-based tokenization
-    std::vector<float> tokens;
-    std::istringstream iss(text);
-    std::string word;
-    
-    while (iss >> word) {
-        // Simple hash-based tokenization
-        size_t hash = std::hash<std::string>{}(word);
-        tokens.push_back(static_cast<float>(hash) / std::numeric_limits<size_t>::max());
-    }
-    
-    return tokens;
-}
-
 std::string ContentAnalyzer::detectLanguage(const std::string& content) {
-    // Stub implementation - always returns English
-    return "en";
+    // Decided from the first few KB of text
+    return LanguageIdentifier::identify(content).language;
 }
 
 std::vector<std::string> ContentAnalyzer::classifyTopics(const std::string& content) {
+    (void)content;
     // Stub implementation
     return {"news", "technology"};
 }
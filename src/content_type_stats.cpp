@@ -0,0 +1,100 @@
+#include "../include/content_type_stats.hpp"
+#include <algorithm>
+#include <cctype>
+
+const std::unordered_set<std::string> ContentTypeStats::NON_HTML_EXTENSIONS = {
+    "pdf", "zip", "gz", "tgz", "bz2", "xz", "7z", "rar", "tar",
+    "exe", "msi", "dmg", "iso", "apk", "bin",
+    "mp3", "wav", "ogg", "flac", "m4a",
+    "mp4", "m4v", "mkv", "avi", "mov", "wmv", "webm", "flv",
+    "doc", "docx", "xls", "xlsx", "ppt", "pptx", "odt",
+    "woff", "woff2", "ttf", "otf", "eot",
+    "css", "js", "json", "xml", "rss", "csv", "txt", "ico"
+};
+
+ContentTypeStats::ContentTypeStats(size_t minSamples, double rejectRatio)
+    : minSamples(minSamples)
+    , rejectRatio(rejectRatio) {
+}
+
+void ContentTypeStats::record(const std::string& url, bool isHtml) {
+    std::string extension = getExtension(url);
+    std::string host = getHost(url);
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+
+    if (!extension.empty()) {
+        Counts& counts = byExtension[extension];
+        isHtml ? counts.html++ : counts.other++;
+    }
+    if (!host.empty()) {
+        Counts& counts = byHost[host];
+        isHtml ? counts.html++ : counts.other++;
+    }
+}
+
+bool ContentTypeStats::isLikelyNonHtml(const std::string& url) const {
+    std::string extension = getExtension(url);
+    if (!extension.empty() && NON_HTML_EXTENSIONS.count(extension)) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+
+    if (!extension.empty()) {
+        auto it = byExtension.find(extension);
+        return it != byExtension.end() && isRejected(it->second);
+    }
+
+    // Without an extension, fall back to what this host usually serves
+    auto it = byHost.find(getHost(url));
+    return it != byHost.end() && isRejected(it->second);
+}
+
+bool ContentTypeStats::isRejected(const Counts& counts) const {
+    size_t total = counts.html + counts.other;
+    return total >= minSamples &&
+           static_cast<double>(counts.other) >= rejectRatio * static_cast<double>(total);
+}
+
+bool ContentTypeStats::isHtmlContentType(const std::string& contentType) {
+    std::string lower = contentType;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return lower.find("text/html") != std::string::npos ||
+           lower.find("application/xhtml+xml") != std::string::npos;
+}
+
+std::string ContentTypeStats::getExtension(const std::string& url) {
+    size_t schemeEnd = url.find("://");
+    size_t pathStart = url.find('/', schemeEnd == std::string::npos ? 0 : schemeEnd + 3);
+    if (pathStart == std::string::npos) {
+        return "";
+    }
+
+    size_t pathEnd = url.find_first_of("?#", pathStart);
+    if (pathEnd == std::string::npos) {
+        pathEnd = url.size();
+    }
+
+    size_t segmentStart = url.rfind('/', pathEnd - 1);
+    size_t dot = url.rfind('.', pathEnd - 1);
+    if (dot == std::string::npos || dot < segmentStart || pathEnd - dot - 1 == 0 || pathEnd - dot - 1 > 8) {
+        return "";
+    }
+
+    std::string extension = url.substr(dot + 1, pathEnd - dot - 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+std::string ContentTypeStats::getHost(const std::string& url) {
+    size_t schemeEnd = url.find("://");
+    size_t start = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+    size_t end = url.find_first_of("/?#", start);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+    return url.substr(start, end - start);
+}
@@ -7,6 +7,8 @@
 
 #include "../include/crawler.hpp"
 #include "../include/compat_fixes.hpp"
+#include "../include/compression.hpp"
+#include "../include/allocation_stats.hpp"
 #include <stdexcept>
 #include <chrono>
 #include <sstream>
@@ -14,9 +16,14 @@
 #include <regex>
 #include <thread>
 #include <mutex>
+#include <deque>
+#include <tuple>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
 
 #ifdef STUB_IMPLEMENTATION
 #include "curl_stubs.hpp"
@@ -45,7 +52,7 @@ public:
     bool addPage(const std::string&, const std::string&) { return true; }
     bool addPage(const std::string&, const std::string&, const std::string&, const std::string&) { return true; }
     size_t getQueueSize() const { return 0; }
-    bool addContentFeatures(const std::string&, const std::string&) { return true; }
+    bool addContentFeatures(const std::string&, const std::map<std::string, double>&) { return true; }
     bool addImage(const std::string&, const std::string&, const std::string&, const std::string&) { return true; }
 };
 
@@ -60,6 +67,7 @@ public:
         // Save image logic here
         return true;
     }
+    bool saveImage(const std::string&, const uint8_t*, size_t, const std::string&) { return true; }
 };
 
 class ResourceManager {
@@ -82,6 +90,7 @@ public:
     
     Monitoring(const std::string& logFile = "crawler.log", 
                const std::string& metricsFile = "metrics.csv") {}
+    Monitoring(const std::string& logFile, LogLevel level) {}
     
     void log(LogLevel level, const std::string& message) {
         // In a stub implementation, we could just print to console
@@ -98,6 +107,12 @@ public:
     
     void startProfiling(const std::string& operation) {}
     void stopProfiling(const std::string& operation) {}
+    void recordLatency(const std::string& name, std::chrono::duration<double> latency) {}
+    double getLatencyPercentile(const std::string& name, double percentile) const { return 0.0; }
+    void addCounter(const std::string& name, long long delta) {}
+    long long getCounter(const std::string& name) const { return 0; }
+    void setConsoleOutput(bool enabled) {}
+    static LogLevel parseLogLevel(const std::string& name) { return LogLevel::INFO; }
     
     std::string logLevelToString(LogLevel level) const {
         switch (level) {
@@ -134,6 +149,7 @@ public:
     };
     
     ImageFeatures analyzeImageData(const std::vector<uint8_t>&) const { return {}; }
+    ImageFeatures analyzeImageData(const uint8_t*, size_t) const { return {}; }
 };
 
 #else
@@ -144,12 +160,23 @@ public:
 
 WebCrawler::WebCrawler(const Config& config)
     : config(config)
+    , allowedHosts(config.getAllowedDomains())
+    , pathFilter(config.getAllowedPaths(), config.getExcludedPaths(), config.getAllowedExtensions())
     , state(CrawlerState::IDLE)
     , activeThreads(0)
     , failedRequests(0)
+    , sitemapLoading(false)
+    , replaying(false)
     , totalPages(0)
     , totalBytes(0)
-    , imagesProcessed(0) {
+    , wireBytes(0)
+    , imagesProcessed(0)
+    , nearDuplicates(0)
+    , trappedUrls(0)
+    , pageAllocations(0)
+    , arenaOverflows(0)
+    , scoredPages(0)
+    , relevanceSum(0) {
     
     // Initialize components
     threadPool = std::make_unique<ThreadPool>(config.getThreadCount());
@@ -158,7 +185,126 @@ WebCrawler::WebCrawler(const Config& config)
     fileIndexer = std::make_unique<FileIndexer>(config.getContentDirectory());
     imageAnalyzer = std::make_unique<ImageAnalyzer>();
     contentAnalyzer = std::make_unique<ContentAnalyzer>();
-    monitoring = std::make_unique<Monitoring>(config.getLogFilePath());
+    monitoring = std::make_unique<Monitoring>(config.getLogFilePath(),
+                                              Monitoring::parseLogLevel(config.getLogLevel()));
+    monitoring->setConsoleOutput(config.getEnableConsoleOutput());
+    bufferPool = std::make_unique<BufferPool>();
+    contentTypeStats = std::make_unique<ContentTypeStats>();
+    if (config.getDnsResolverThreads() > 0) {
+        dnsCache = std::make_unique<DnsCache>(
+            static_cast<size_t>(config.getDnsResolverThreads()),
+            std::chrono::seconds(config.getDnsCacheTtlSeconds()),
+            std::chrono::seconds(config.getDnsNegativeTtlSeconds()));
+    }
+    std::string fetcherError;
+    fetcher = Fetcher::create(config, dnsCache.get(), fetcherError);
+    replaying = std::strcmp(fetcher->getName(), "replay") == 0;
+    if (!fetcherError.empty()) {
+        monitoring->log(Monitoring::LogLevel::LOG_ERROR, fetcherError);
+    }
+    if (std::strcmp(fetcher->getName(), "curl") != 0) {
+        // Only the network fetcher resolves hosts
+        dnsCache.reset();
+    }
+    monitoring->log(Monitoring::LogLevel::INFO, std::string("Fetching with the ") + fetcher->getName() + " fetcher");
+    if (config.getRespectRobotsTxt()) {
+        robotsCache = std::make_unique<RobotsCache>(
+            config.getUserAgent(),
+            [this](const std::string& url, long& status, std::string& body) {
+                return fetchRobotsTxt(url, status, body);
+            },
+            static_cast<size_t>(config.getRobotsFetchThreads()),
+            static_cast<size_t>(config.getRobotsCacheSize()));
+    }
+    if (config.getDetectDuplicates()) {
+        duplicateDetector = std::make_unique<NearDuplicateDetector>(config.getNearDuplicateDistance());
+    }
+    if (config.getDetectUrlTraps()) {
+        trapDetector = std::make_unique<UrlTrapDetector>(
+            static_cast<size_t>(config.getUrlPatternSoftLimit()),
+            static_cast<size_t>(config.getUrlPatternHardLimit()),
+            static_cast<size_t>(config.getMaxRepeatedSegments()));
+    }
+    if (!config.getRecordArchive().empty()) {
+        if (replaying) {
+            monitoring->log(Monitoring::LogLevel::WARNING, "Not recording while replaying an archive");
+        } else {
+            recordArchive = std::make_unique<ResponseArchiveWriter>(config.getRecordArchive());
+            if (!recordArchive->isOpen()) {
+                monitoring->log(Monitoring::LogLevel::LOG_ERROR,
+                    "Failed to open record archive: " + config.getRecordArchive());
+                recordArchive.reset();
+            }
+        }
+    }
+    if (!config.getResultsFile().empty()) {
+        resultsWriter = std::make_unique<ColumnarWriter>(config.getResultsFile());
+        if (!resultsWriter->isOpen()) {
+            monitoring->log(Monitoring::LogLevel::LOG_ERROR,
+                "Failed to open results file: " + config.getResultsFile());
+            resultsWriter.reset();
+        }
+    }
+    if (config.getLinkGraphEnabled()) {
+        linkGraph = std::make_unique<LinkGraph>();
+    }
+    if (!config.getFocusTopic().empty()) {
+        topicScorer = std::make_unique<TopicScorer>(config.getFocusTopic());
+        if (topicScorer->empty()) {
+            monitoring->log(Monitoring::LogLevel::WARNING, "Focus topic has no terms: " + config.getFocusTopic());
+            topicScorer.reset();
+        }
+    }
+    if (!config.getInferenceBackend().empty()) {
+        auto loadModel = [this](const std::string& path) -> std::unique_ptr<InferenceBackend> {
+            if (path.empty()) {
+                return nullptr;
+            }
+            std::string error;
+            auto model = InferenceBackend::create(this->config.getInferenceBackend(), path, error);
+            if (!model) {
+                monitoring->log(Monitoring::LogLevel::LOG_ERROR, error);
+                return nullptr;
+            }
+            monitoring->log(Monitoring::LogLevel::INFO, std::string("Loaded ") + model->getName() + " model " + path +
+                " with " + std::to_string(model->getLabels().size()) + " labels");
+            return model;
+        };
+        auto pageModel = loadModel(config.getPageModel());
+        auto imageModel = loadModel(config.getImageModel());
+        if (pageModel || imageModel) {
+            InferenceStage::Options inferenceOptions;
+            inferenceOptions.batchSize = static_cast<size_t>(std::max(1, config.getInferenceBatchSize()));
+            inferenceOptions.maxLatency = std::chrono::milliseconds(std::max(0, config.getInferenceMaxLatencyMs()));
+            inferenceOptions.threads = static_cast<size_t>(std::max(1, config.getInferenceThreads()));
+            inferenceOptions.queueLimit = static_cast<size_t>(std::max(1, config.getInferenceQueueLimit()));
+            inferenceStage = std::make_unique<InferenceStage>(inferenceOptions, std::move(pageModel),
+                                                              std::move(imageModel));
+        }
+    }
+    
+    if (!config.getClusterNode().empty()) {
+        ClusterNode::Options clusterOptions;
+        clusterOptions.self = config.getClusterNode();
+        clusterOptions.seeds = config.getClusterPeers();
+        clusterOptions.virtualNodes = static_cast<size_t>(std::max(1, config.getClusterVirtualNodes()));
+        clusterOptions.batchSize = static_cast<size_t>(std::max(1, config.getClusterBatchSize()));
+        clusterOptions.flushInterval = std::chrono::milliseconds(config.getClusterFlushIntervalMs());
+        clusterOptions.recentCapacity = static_cast<size_t>(std::max(1, config.getClusterRecentUrls()));
+        clusterOptions.heartbeatInterval = std::chrono::milliseconds(config.getClusterHeartbeatIntervalMs());
+        clusterOptions.failureTimeout = std::chrono::milliseconds(config.getClusterFailureTimeoutMs());
+        cluster = std::make_unique<ClusterNode>(clusterOptions,
+            [this](std::string url, int depth) {
+                enqueueUrl(std::move(url), depth);
+            },
+            [this](const std::string& node, bool joined) {
+                rebalance(node, joined);
+            },
+            [this] {
+                return isLocallyIdle();
+            },
+            monitoring.get());
+    }
     
     // Log initialization
     monitoring->log(Monitoring::LogLevel::INFO, "WebCrawler initialized");
@@ -169,6 +315,26 @@ WebCrawler::~WebCrawler() {
     if (state == CrawlerState::RUNNING || state == CrawlerState::PAUSED) {
         stop();
     }
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    if (sitemapWorker.joinable()) {
+        sitemapWorker.join();
+    }
+    if (rankWorker.joinable()) {
+        rankWorker.join();
+    }
+    if (cluster) {
+        cluster->stop();
+    }
+    
+    // Store what is still being scored before the results file is finished
+    inferenceStage.reset();
+    if (resultsWriter && !resultsWriter->close()) {
+        monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to write results file: " + config.getResultsFile());
+    }
     
     // Log shutdown
     monitoring->log(Monitoring::LogLevel::INFO, "WebCrawler destroyed");
@@ -189,22 +355,64 @@ bool WebCrawler::start(const std::string& startUrl) {
     // Reset state and counters
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        urlQueue = std::queue<UrlEntry>();
+        urlQueue.clear();
         visitedUrls.clear();
         pendingUrls.clear();
+        deferredUrls.clear();
         activeThreads = 0;
         failedRequests = 0;
         totalPages = 0;
         totalBytes = 0;
+        wireBytes = 0;
         imagesProcessed = 0;
+        nearDuplicates = 0;
+        trappedUrls = 0;
+        pageAllocations = 0;
+        arenaOverflows = 0;
+        scoredPages = 0;
+        relevanceSum = 0;
+        if (trapDetector) {
+            trapDetector->clear();
+        }
+        if (linkGraph) {
+            linkGraph->clear();
+        }
     }
     
-    // Add start URL to queue
+    // Join the cluster before any URL is routed through it
+    if (cluster) {
+        std::string error;
+        if (!cluster->start(error)) {
+            monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to join cluster: " + error);
+            return false;
+        }
+        monitoring->log(Monitoring::LogLevel::INFO, "Joined cluster as " + cluster->getSelf() + " with " +
+            std::to_string(cluster->getMembers().size() - 1) + " other members");
+    }
+    
+    // Add start URL to queue; in a cluster only its owner crawls it
     scheduleUrl(urlToStart, 0);
     
     // Update state
     state = CrawlerState::RUNNING;
     
+    // Stream sitemap URLs into the queue alongside the crawl
+    if (sitemapWorker.joinable()) {
+        sitemapWorker.join();
+    }
+    if (config.getSeedFromSitemaps()) {
+        sitemapLoading = true;
+        sitemapWorker = std::thread(&WebCrawler::sitemapThread, this, urlToStart);
+    }
+    
+    // Periodically re-rank the queue by the links found so far
+    if (rankWorker.joinable()) {
+        rankWorker.join();
+    }
+    if (linkGraph) {
+        rankWorker = std::thread(&WebCrawler::rankThread, this);
+    }
+    
     // Start worker threads
     int numThreads = config.getThreadCount();
     for (int i = 0; i < numThreads; i++) {
@@ -236,6 +444,18 @@ void WebCrawler::stop() {
     
     // Clear threads vector
     threads.clear();
+    if (sitemapWorker.joinable()) {
+        sitemapWorker.join();
+    }
+    if (rankWorker.joinable()) {
+        rankWorker.join();
+    }
+    if (cluster) {
+        cluster->stop();
+    }
+    if (inferenceStage) {
+        inferenceStage->drain();
+    }
     
     // Update state
     state = CrawlerState::STOPPED;
@@ -279,10 +499,11 @@ bool WebCrawler::waitForCompletion(int timeoutMs) {
         // Check if queue is empty and no active threads
         {
             std::lock_guard<std::mutex> lock(queueMutex);
-            if (urlQueue.empty() && activeThreads == 0) {
+            if (urlQueue.empty() && deferredUrls.empty() && !sitemapLoading && activeThreads == 0 &&
+                (!cluster || cluster->isQuiescent())) {
                 // Crawler finished
                 state = CrawlerState::STOPPED;
-                return true;
+                break;
             }
         }
         
@@ -290,6 +511,10 @@ bool WebCrawler::waitForCompletion(int timeoutMs) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
+    // Pages still being scored are stored before the crawl counts as done
+    if (state == CrawlerState::STOPPED && inferenceStage) {
+        inferenceStage->drain();
+    }
     return state == CrawlerState::STOPPED;
 }
 
@@ -301,7 +526,38 @@ WebCrawler::CrawlerStats WebCrawler::getStats() const {
     stats.failedUrls = failedRequests;
     stats.pendingUrls = static_cast<int>(pendingUrls.size());
     stats.totalBytes = totalBytes;
+    stats.wireBytes = wireBytes;
     stats.imagesProcessed = imagesProcessed;
+    stats.nearDuplicates = nearDuplicates;
+    stats.trappedUrls = trappedUrls;
+    stats.pageAllocations = pageAllocations;
+    stats.arenaOverflows = arenaOverflows;
+    stats.fetchLatencyP50Ms = monitoring->getLatencyPercentile("fetch", 50.0) * 1000.0;
+    stats.fetchLatencyP99Ms = monitoring->getLatencyPercentile("fetch", 99.0) * 1000.0;
+    if (cluster) {
+        ClusterNode::Stats clusterStats = cluster->getStats();
+        stats.forwardedUrls = clusterStats.urlsSent;
+        stats.receivedUrls = clusterStats.urlsReceived;
+        stats.exchangeBytes = clusterStats.batchBytesSent;
+        stats.clusterMembers = static_cast<int>(clusterStats.members);
+    } else {
+        stats.forwardedUrls = 0;
+        stats.receivedUrls = 0;
+        stats.exchangeBytes = 0;
+        stats.clusterMembers = 0;
+    }
+    stats.linkEdges = linkGraph ? static_cast<long long>(linkGraph->getStats().edges) : 0;
+    long long scored = scoredPages;
+    stats.harvestRate = scored > 0 ? static_cast<double>(relevanceSum) / 1e6 / static_cast<double>(scored) : 0.0;
+    if (inferenceStage) {
+        InferenceStage::Stats inferenceStats = inferenceStage->getStats();
+        stats.inferredItems = inferenceStats.items;
+        stats.meanInferenceBatch = inferenceStats.batches > 0 ?
+            static_cast<double>(inferenceStats.items) / static_cast<double>(inferenceStats.batches) : 0.0;
+    } else {
+        stats.inferredItems = 0;
+        stats.meanInferenceBatch = 0.0;
+    }
     stats.activeThreads = activeThreads;
     return stats;
 }
@@ -316,9 +572,29 @@ int WebCrawler::getProgressPercentage() const {
     return percentage > 100 ? 100 : percentage;
 }
 
+void WebCrawler::addUrl(const std::string& url, int depth) {
+    scheduleUrl(url, depth);
+}
+
+size_t WebCrawler::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return urlQueue.size();
+}
+
+void WebCrawler::clearUrls() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    urlQueue.clear();
+    visitedUrls.clear();
+    pendingUrls.clear();
+    deferredUrls.clear();
+}
+
 void WebCrawler::crawlerThread() {
     activeThreads++;
     
+    // Scratch memory for one page at a time, rewound after each
+    PageArena arena;
+    
     while (state == CrawlerState::RUNNING || state == CrawlerState::PAUSED) {
         // Wait if paused
         if (state == CrawlerState::PAUSED) {
@@ -343,9 +619,10 @@ void WebCrawler::crawlerThread() {
                 
                 if (urlQueue.empty()) {
                     // Still no URLs after waiting, check if we should exit
-                    if (pendingUrls.empty() && state == CrawlerState::RUNNING) {
+                    if (pendingUrls.empty() && deferredUrls.empty() && !sitemapLoading && state == CrawlerState::RUNNING &&
+                        (!cluster || cluster->isQuiescent())) {
                         // No URLs in queue or pending, and crawler is running
-                        // This indicates that crawling is done
+                        // This indicates that crawling is done (on every node, in a cluster)
                         state = CrawlerState::STOPPED;
                     }
                     continue;
@@ -353,8 +630,7 @@ void WebCrawler::crawlerThread() {
             }
             
             // Get URL from queue
-            entry = urlQueue.front();
-            urlQueue.pop();
+            urlQueue.pop(entry);
             
             // Mark as pending
             pendingUrls.insert(entry.url);
@@ -363,7 +639,12 @@ void WebCrawler::crawlerThread() {
         
         if (hasUrl) {
             // Process URL
-            processUrl(entry.url, entry.depth);
+            size_t allocationsBefore = AllocationStats::getThreadAllocations();
+            size_t overflowsBefore = arena.getOverflowAllocations();
+            processUrl(entry.url, entry.depth, arena);
+            arena.reset();
+            pageAllocations += static_cast<long long>(AllocationStats::getThreadAllocations() - allocationsBefore);
+            arenaOverflows += static_cast<long long>(arena.getOverflowAllocations() - overflowsBefore);
             
             // Mark as visited and remove from pending
             {
@@ -377,202 +658,825 @@ void WebCrawler::crawlerThread() {
     activeThreads--;
 }
 
-void WebCrawler::scheduleUrl(const std::string& url, int depth) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    
-    // Skip if URL has already been visited or is pending
-    if (visitedUrls.find(url) != visitedUrls.end() || pendingUrls.find(url) != pendingUrls.end()) {
+void WebCrawler::scheduleUrl(std::string url, int depth, float priority) {
+    // Hosts owned by another cluster member are crawled there
+    if (cluster && !cluster->owns(url)) {
+        cluster->forward(std::move(url), depth);
         return;
     }
+    enqueueUrl(std::move(url), depth, priority);
+}
+
+void WebCrawler::enqueueUrl(std::string url, int depth, float priority) {
+    UrlEntry entry;
+    entry.url = std::move(url);
+    entry.depth = depth;
+    entry.priority = priority;
+    
+    Admission admission;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        admission = admitUrlLocked(entry);
+        if (admission == Admission::QUEUE) {
+            urlQueue.push(entry);
+            
+            // Notify waiting thread
+            queueCondition.notify_one();
+        }
+    }
+    
+    // Resolve the host while the URL waits in the queue
+    std::string host;
+    int port;
+    if (admission != Admission::REJECTED && dnsCache && DnsCache::splitHostPort(entry.url, host, port)) {
+        dnsCache->prefetch(host);
+    }
+}
+
+bool WebCrawler::scheduleUrls(std::vector<UrlEntry>& entries) {
+    if (cluster) {
+        auto foreign = std::stable_partition(entries.begin(), entries.end(),
+            [this](const UrlEntry& entry) { return cluster->owns(entry.url); });
+        for (auto it = foreign; it != entries.end(); ++it) {
+            cluster->forward(std::move(it->url), it->depth);
+        }
+        entries.erase(foreign, entries.end());
+    }
+    
+    std::vector<UrlEntry> accepted;
+    accepted.reserve(entries.size());
+    std::set<std::string> hosts;
+    std::set<std::string_view> batchUrls;   // Repeats within the batch are not queued yet, so not caught by admission
+    bool full;
+    
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (auto& entry : entries) {
+            if (!batchUrls.insert(entry.url).second) {
+                continue;
+            }
+            Admission admission = admitUrlLocked(entry);
+            if (admission == Admission::QUEUE) {
+                accepted.push_back(entry);
+            }
+            
+            std::string host;
+            int port;
+            if (admission != Admission::REJECTED && dnsCache && DnsCache::splitHostPort(entry.url, host, port)) {
+                hosts.insert(host);
+            }
+        }
+        
+        urlQueue.pushBatch(accepted);
+        queueCondition.notify_all();
+        
+        int maxPages = config.getMaxPages();
+        size_t total = visitedUrls.size() + pendingUrls.size() + deferredUrls.size() + urlQueue.size();
+        full = urlQueue.size() >= static_cast<size_t>(config.getQueueSizeLimit()) ||
+               (maxPages > 0 && total >= static_cast<size_t>(maxPages));
+    }
+    entries.clear();
+    
+    for (const auto& host : hosts) {
+        dnsCache->prefetch(host);
+    }
+    return !full;
+}
+
+WebCrawler::Admission WebCrawler::admitUrlLocked(UrlEntry& entry) {
+    const std::string& url = entry.url;
+    
+    // Skip if URL has already been visited, is pending or is queued, so
+    // each URL reaches the trap detector below only once
+    if (visitedUrls.find(url) != visitedUrls.end() || pendingUrls.find(url) != pendingUrls.end() ||
+        deferredUrls.find(url) != deferredUrls.end() || urlQueue.contains(url)) {
+        return Admission::REJECTED;
+    }
     
     // Skip if depth exceeds max depth
-    if (depth > config.getMaxDepth()) {
-        return;
+    if (entry.depth > config.getMaxDepth()) {
+        return Admission::REJECTED;
     }
     
     // Skip if reached max pages
     int maxPages = config.getMaxPages();
-    if (maxPages > 0 && (static_cast<int>(visitedUrls.size()) + static_cast<int>(pendingUrls.size())) >= maxPages) {
-        return;
+    if (maxPages > 0 && visitedUrls.size() + pendingUrls.size() + deferredUrls.size() + urlQueue.size() >=
+                        static_cast<size_t>(maxPages)) {
+        return Admission::REJECTED;
     }
     
-    // Add URL to queue
-    UrlEntry entry;
-    entry.url = url;
-    entry.depth = depth;
-    urlQueue.push(entry);
+    // URLs from patterns that keep growing on one host sink in the queue,
+    // and are dropped once the pattern is clearly unbounded
+    if (trapDetector) {
+        float priorityScale;
+        if (trapDetector->check(url, priorityScale) == UrlTrapDetector::Verdict::DROP) {
+            trappedUrls++;
+            monitoring->log(Monitoring::LogLevel::DEBUG, "Dropped URL from unbounded pattern: " + url);
+            return Admission::REJECTED;
+        }
+        entry.priority *= priorityScale;
+    }
+    
+    // URLs the last link analysis rated highly are served sooner
+    if (linkGraph) {
+        entry.rank = static_cast<float>(config.getLinkRankWeight()) * linkGraph->getRank(url);
+    }
+    
+    // Disallowed URLs never enter the queue. URLs of a host whose
+    // robots.txt is still being fetched wait aside until it arrives.
+    if (robotsCache) {
+        RobotsCache::Verdict verdict = robotsCache->check(url,
+            [this, entry](const std::string&, bool allowed) {
+                releaseDeferredUrl(entry, allowed);
+            });
+        if (verdict == RobotsCache::Verdict::DISALLOWED) {
+            monitoring->log(Monitoring::LogLevel::DEBUG, "Disallowed by robots.txt: " + url);
+            return Admission::REJECTED;
+        }
+        if (verdict == RobotsCache::Verdict::PENDING) {
+            deferredUrls.insert(url);
+            return Admission::DEFERRED;
+        }
+    }
+    
+    return Admission::QUEUE;
+}
+
+void WebCrawler::releaseDeferredUrl(const UrlEntry& entry, bool allowed) {
+    // The host may have moved to another cluster member while its
+    // robots.txt was being fetched; rebalance() only sees the queue
+    bool owned = !cluster || cluster->owns(entry.url);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (deferredUrls.erase(entry.url) == 0) {
+            // Crawl was restarted while robots.txt was being fetched
+            return;
+        }
+        
+        if (allowed && owned) {
+            urlQueue.push(entry);
+            queueCondition.notify_one();
+        }
+    }
+    
+    if (!allowed) {
+        monitoring->log(Monitoring::LogLevel::DEBUG, "Disallowed by robots.txt: " + entry.url);
+    } else if (!owned) {
+        cluster->forward(entry.url, entry.depth);
+    }
+}
+
+// What an image model's scores say about an image: the labels it gives at
+// least even odds, and whether one of them is "nsfw"
+static ImageAnalyzer::ImageFeatures ImageFeaturesFromScores(const std::string& url,
+                                                            const InferenceStage::Result& result,
+                                                            Monitoring& monitoring) {
+    ImageAnalyzer::ImageFeatures features{};
+    if (!result.scored) {
+        monitoring.log(Monitoring::LogLevel::WARNING, "Failed to score image " + url + ": " + result.error);
+        return features;
+    }
     
-    // Notify waiting thread
-    queueCondition.notify_one();
+    for (size_t i = 0; i < result.scores.size(); ++i) {
+        const std::string& label = (*result.labels)[i];
+        if (result.scores[i] < 0.5f) {
+            continue;
+        }
+        if (label == "nsfw") {
+            features.isNSFW = true;
+        } else {
+            features.labels.push_back(label);
+        }
+    }
+    return features;
 }
 
-bool WebCrawler::processUrl(const std::string& url, int depth) {
+bool WebCrawler::processUrl(const std::string& url, int depth, PageArena& arena) {
     monitoring->log(Monitoring::LogLevel::INFO, "Processing URL: " + url + " (depth: " + std::to_string(depth) + ")");
     
-    // Download page content
-    std::string content;
-    if (!downloadPage(url, content)) {
+    bool isImage = isImageUrl(url);
+    
+    // Links are extracted as their tag streams in, while the rest of the
+    // body is still downloading, and held until the fetch has succeeded, so
+    // an aborted or failed transfer schedules nothing. With duplicate
+    // detection on, they are held until the page is known not to be a
+    // near-copy; in a focused crawl, until the page's relevance is known.
+    // Each held link keeps the score of its anchor text.
+    std::pmr::vector<std::tuple<std::pmr::string, HtmlLinkScanner::RefKind, float>> heldRefs(arena.resource());
+    const TopicScorer* scorer = topicScorer.get();
+    
+    // In-scope links, added to the link graph once the page is stored
+    std::pmr::vector<std::pmr::string> pageLinks(arena.resource());
+    std::pmr::vector<std::pmr::string>* links = linkGraph ? &pageLinks : nullptr;
+    HtmlLinkScanner scanner([&heldRefs, scorer](const std::string& ref, HtmlLinkScanner::RefKind kind,
+                                                const std::string& anchorText) {
+        float anchorScore = scorer ? static_cast<float>(scorer->scoreText(anchorText)) : 0.0f;
+        heldRefs.emplace_back(ref, kind, anchorScore);
+    }, scorer != nullptr);
+    
+    // The page is scored against the topic as it streams in, like the scanner
+    std::unique_ptr<TopicScorer::Counter> relevance;
+    if (scorer && !isImage) {
+        relevance = std::make_unique<TopicScorer::Counter>(*scorer);
+    }
+    
+    // Download page content into a recycled buffer
+    std::string content = bufferPool->acquire();
+    CrawlRecord record;
+    bool downloaded = downloadPage(url, content, isImage ? nullptr : &scanner, resultsWriter ? &record : nullptr,
+                                   relevance.get());
+    auto downloadEnd = std::chrono::steady_clock::now();
+    if (!downloaded) {
+        exportResult(record, url, depth, std::string_view(), downloadEnd);
+        bufferPool->release(std::move(content));
         failedRequests++;
         monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to download: " + url);
         return false;
     }
     
     // Update total bytes downloaded
-    totalBytes += content.size();
+    totalBytes += static_cast<long long>(content.size());
     
     // Check if it's an image
-    if (isImageUrl(url)) {
+    if (isImage) {
+        // With an image model, the image is scored and stored on the
+        // inference stage while this thread goes on fetching
+        if (inferenceStage && inferenceStage->accepts(InferenceStage::Kind::IMAGE)) {
+            inferenceStage->submit(InferenceStage::Kind::IMAGE, std::move(content),
+                [this, url, depth, record, downloadEnd](std::string body,
+                                                        const InferenceStage::Result& result) mutable {
+                    storeImage(url, body, ImageFeaturesFromScores(url, result, *monitoring));
+                    exportResult(record, url, depth, body, downloadEnd);
+                    bufferPool->release(std::move(body));
+                });
+            return true;
+        }
+        
         // Process as image
-        std::vector<uint8_t> imageData(content.begin(), content.end());
-        processImage(url, imageData);
+        processImage(url, content);
+        exportResult(record, url, depth, content, downloadEnd);
+        bufferPool->release(std::move(content));
         return true;
     }
     
     // Process as HTML page
     monitoring->startProfiling("process_page");
+    scanner.finish();
+    if (resultsWriter) {
+        record.language = LanguageIdentifier::identify(content).language;
+    }
     
-    // Extract links from content
-    std::vector<std::string> links = urlParser->extractLinks(content, url);
+    // Mirrors and templated copies are neither stored nor expanded
+    if (duplicateDetector) {
+        uint64_t fingerprint = NearDuplicateDetector::fingerprint(content);
+        std::string original;
+        if (fingerprint != 0 && duplicateDetector->checkAndInsert(fingerprint, url, original)) {
+            nearDuplicates++;
+            monitoring->log(Monitoring::LogLevel::INFO, "Skipping near-duplicate of " + original + ": " + url);
+            exportResult(record, url, depth, content, downloadEnd);
+            bufferPool->release(std::move(content));
+            monitoring->stopProfiling("process_page");
+            return true;
+        }
+        
+    }
     
-    // Add links to queue
-    for (const auto& link : links) {
-        // Check if domain is allowed
-        std::string domain = urlParser->getDomain(link);
-        std::vector<std::string> allowedDomains = config.getAllowedDomains();
+    // Links are prioritized by how relevant both the page and their anchor
+    // text are, and pages too far off topic are not expanded
+    if (relevance) {
+        double pageScore = relevance->finish();
+        scoredPages++;
+        relevanceSum += static_cast<long long>(pageScore * 1e6);
+        if (pageScore < config.getFocusMinRelevance()) {
+            monitoring->log(Monitoring::LogLevel::DEBUG, "Not following links of off-topic page: " + url);
+            heldRefs.clear();
+        }
         
-        if (allowedDomains.empty() || 
-            std::find(allowedDomains.begin(), allowedDomains.end(), domain) != allowedDomains.end()) {
-            scheduleUrl(link, depth + 1);
+        float anchorWeight = static_cast<float>(config.getFocusAnchorWeight());
+        for (const auto& ref : heldRefs) {
+            float priority = (1.0f - anchorWeight) * static_cast<float>(pageScore) + anchorWeight * std::get<2>(ref);
+            scheduleDiscoveredRef(url, std::get<0>(ref), std::get<1>(ref), depth + 1, links, priority);
+        }
+    } else {
+        for (const auto& ref : heldRefs) {
+            scheduleDiscoveredRef(url, std::get<0>(ref), std::get<1>(ref), depth + 1, links);
         }
     }
     
-    // Extract and process images
-    std::vector<std::string> imageUrls = urlParser->extractImages(content, url);
-    for (const auto& imageUrl : imageUrls) {
-        scheduleUrl(imageUrl, depth + 1);
+    if (linkGraph) {
+        linkGraph->addPage(url, pageLinks);
+    }
+    
+    // With a page model, the page is scored and stored on the inference
+    // stage while this thread goes on fetching
+    if (inferenceStage && inferenceStage->accepts(InferenceStage::Kind::PAGE)) {
+        inferenceStage->submit(InferenceStage::Kind::PAGE, std::move(content),
+            [this, url, depth, record, downloadEnd](std::string body, const InferenceStage::Result& result) mutable {
+                storePage(url, depth, std::move(body), record, downloadEnd, &result);
+            });
+    } else {
+        storePage(url, depth, std::move(content), record, downloadEnd, nullptr);
     }
     
+    monitoring->stopProfiling("process_page");
+    return true;
+}
+
+void WebCrawler::storePage(const std::string& url, int depth, std::string content, CrawlRecord& record,
+                           std::chrono::steady_clock::time_point downloaded, const InferenceStage::Result* scores) {
     // Save page content to database and file system
     std::string filePath = fileIndexer->getPagePath(url);
     fileIndexer->savePage(url, content);
     database->addPage(url, "Page " + url, content, filePath);
     
-    monitoring->stopProfiling("process_page");
+    // The model's scores are stored as the page's content features
+    if (scores && scores->scored) {
+        std::map<std::string, double> features;
+        for (size_t i = 0; i < scores->scores.size(); ++i) {
+            features[(*scores->labels)[i]] = scores->scores[i];
+        }
+        database->addContentFeatures(url, features);
+    } else if (scores) {
+        monitoring->log(Monitoring::LogLevel::WARNING, "Failed to score page " + url + ": " + scores->error);
+    }
+    
+    exportResult(record, url, depth, content, downloaded);
+    bufferPool->release(std::move(content));
     totalPages++;
+}
+
+void WebCrawler::exportResult(CrawlRecord& record, const std::string& url, int depth, std::string_view body,
+                              std::chrono::steady_clock::time_point downloaded) {
+    if (!resultsWriter) {
+        return;
+    }
     
-    return true;
+    record.url = url;
+    record.host = std::string(HostFilter::hostOf(url));
+    record.depth = depth;
+    record.bytes = static_cast<long long>(body.size());
+    record.contentHash = ColumnarWriter::hashContent(body);
+    record.processMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - downloaded).count();
+    resultsWriter->append(record);
 }
 
-// Static callback for CURL
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t realSize = size * nmemb;
-    std::string* str = static_cast<std::string*>(userp);
-    str->append(static_cast<char*>(contents), realSize);
-    return realSize;
+// Resolve a link against the page it was found on. Unlike URLParser::join
+// this keeps no state, so workers need not share a parser, and it builds
+// the result with a single allocation.
+static std::string ResolveUrl(const std::string& baseUrl, std::string_view ref) {
+    if (ref.compare(0, 7, "http://") == 0 || ref.compare(0, 8, "https://") == 0) {
+        return std::string(ref);
+    }
+    
+    size_t schemeEnd = baseUrl.find("://");
+    if (schemeEnd == std::string::npos) {
+        return std::string(ref);
+    }
+    
+    size_t prefixLength;
+    if (ref.compare(0, 2, "//") == 0) {
+        // Protocol-relative: keep only the scheme
+        prefixLength = schemeEnd + 1;
+    } else {
+        size_t pathStart = baseUrl.find_first_of("/?#", schemeEnd + 3);
+        if (pathStart == std::string::npos) {
+            pathStart = baseUrl.size();
+        }
+        size_t pathEnd = baseUrl.find_first_of("?#", pathStart);
+        if (pathEnd == std::string::npos) {
+            pathEnd = baseUrl.size();
+        }
+        if (!ref.empty() && ref[0] == '/') {
+            prefixLength = pathStart;
+        } else if (!ref.empty() && ref[0] == '?') {
+            // Same path, new query
+            prefixLength = pathEnd;
+        } else if (!ref.empty() && ref[0] == '#') {
+            prefixLength = std::min(baseUrl.find('#', pathStart), baseUrl.size());
+        } else {
+            // Directory of the base path, up to and including its last slash
+            size_t lastSlash = baseUrl.rfind('/', pathEnd - 1);
+            prefixLength = (lastSlash != std::string::npos && lastSlash >= pathStart) ? lastSlash + 1 : pathStart;
+        }
+    }
+    
+    std::string resolved;
+    resolved.reserve(prefixLength + 1 + ref.size());
+    resolved.append(baseUrl, 0, prefixLength);
+    if (baseUrl[prefixLength - 1] != '/') {
+        if (ref.empty() || (ref[0] != '/' && ref[0] != '?' && ref[0] != '#')) {
+            resolved += '/';
+        }
+    }
+    resolved.append(ref);
+    return resolved;
 }
 
-bool WebCrawler::downloadPage(const std::string& url, std::string& content) {
-    monitoring->startProfiling("download_page");
+void WebCrawler::scheduleDiscoveredRef(const std::string& baseUrl, std::string_view ref,
+                                       HtmlLinkScanner::RefKind kind, int depth,
+                                       std::pmr::vector<std::pmr::string>* links, float priority) {
+    std::string absoluteUrl = ResolveUrl(baseUrl, ref);
     
-    content.clear();
+    // Images are scheduled regardless of domain, unless their path is excluded
+    if (kind == HtmlLinkScanner::RefKind::IMAGE) {
+        if (!pathFilter.isExcluded(absoluteUrl)) {
+            scheduleUrl(std::move(absoluteUrl), depth, priority);
+        }
+        return;
+    }
     
-    // Create CURL handle
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to initialize CURL");
-        return false;
+    // Skip links whose extension or host has so far only served non-HTML
+    if (!isImageUrl(absoluteUrl) && contentTypeStats->isLikelyNonHtml(absoluteUrl)) {
+        monitoring->log(Monitoring::LogLevel::DEBUG, "Skipping likely non-HTML URL: " + absoluteUrl);
+        return;
     }
     
-    // Set up CURL options
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &content);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, config.getUserAgent().c_str());
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, config.getTimeoutSeconds());
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, config.getFollowRedirects() ? 1L : 0L);
+    // Check domain and path filters before the URL takes up queue space
+    if (isDomainAllowed(absoluteUrl) && pathFilter.isAllowed(absoluteUrl)) {
+        if (links) {
+            links->emplace_back(absoluteUrl);
+        }
+        scheduleUrl(std::move(absoluteUrl), depth, priority);
+    }
+}
+
+bool WebCrawler::isDomainAllowed(std::string_view url) {
+    return allowedHosts.matchesUrl(url);
+}
+
+bool WebCrawler::isLocallyIdle() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return urlQueue.empty() && pendingUrls.empty() && deferredUrls.empty() && !sitemapLoading;
+}
+
+void WebCrawler::rebalance(const std::string& node, bool joined) {
+    // Queued URLs whose host now belongs to another member move there, as
+    // do deferred ones once their robots.txt arrives. URLs already visited
+    // here are not handed over, so a host that changes owner mid-crawl may
+    // see a few pages fetched twice.
+    std::vector<UrlEntry> moved;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        std::vector<UrlEntry> kept;
+        UrlEntry entry;
+        while (urlQueue.pop(entry)) {
+            if (cluster->owns(entry.url)) {
+                kept.push_back(std::move(entry));
+            } else {
+                moved.push_back(std::move(entry));
+            }
+        }
+        urlQueue.pushBatch(kept);
+    }
     
-    // Perform the request
-    CURLcode res = curl_easy_perform(curl);
+    for (auto& entry : moved) {
+        cluster->forward(std::move(entry.url), entry.depth);
+    }
     
-    // Check for errors
-    bool success = (res == CURLE_OK);
-    if (success) {
-        // Check HTTP status code
-        long httpCode = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    monitoring->log(Monitoring::LogLevel::INFO, "Cluster member " + node + (joined ? " joined" : " left") +
+        "; handed over " + std::to_string(moved.size()) + " queued URLs");
+}
+
+bool WebCrawler::downloadPage(const std::string& url, std::string& content, HtmlLinkScanner* scanner,
+                              CrawlRecord* record, TopicScorer::Counter* relevance) {
+    monitoring->startProfiling("download_page");
+    
+    content.clear();
+    
+    Fetcher::Request request;
+    request.url = url;
+    request.followRedirects = config.getFollowRedirects();
+    request.timeoutSeconds = config.getTimeoutSeconds();
+    request.compressed = config.getCompressedTransfer();
+    
+    size_t maxBytes = static_cast<size_t>(config.getMaxFileSizeMB()) * 1024 * 1024;
+    bool expectImage = isImageUrl(url);
+    std::string abortReason;
+    
+    // Accept or reject the response from its headers, before any body bytes are kept
+    auto onHeaders = [&](long status, const std::string& contentType, long long contentLength) {
+        if (status != 200) {
+            abortReason = "HTTP error " + std::to_string(status);
+            return false;
+        }
         
-        if (httpCode != 200) {
-            monitoring->log(Monitoring::LogLevel::WARNING, 
-                "HTTP error " + std::to_string(httpCode) + " for URL: " + url);
-            success = false;
+        if (!expectImage && !contentType.empty()) {
+            bool isHtml = ContentTypeStats::isHtmlContentType(contentType);
+            contentTypeStats->record(url, isHtml);
+            if (!isHtml) {
+                abortReason = "Skipping non-HTML content type: " + contentType;
+                return false;
+            }
+        }
+        
+        if (contentLength > 0) {
+            if (maxBytes > 0 && static_cast<size_t>(contentLength) > maxBytes) {
+                abortReason = "Content-Length " + std::to_string(contentLength) + " exceeds size limit";
+                return false;
+            }
+            content.reserve(static_cast<size_t>(contentLength));
         }
         
-        // Check content type
-        char* contentType = nullptr;
-        curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &contentType);
+        return true;
+    };
+    
+    auto onBody = [&](const char* data, size_t size) {
+        // Decoded size can exceed Content-Length when the transfer is compressed
+        if (maxBytes > 0 && content.size() + size > maxBytes) {
+            abortReason = "Body exceeds size limit of " + std::to_string(maxBytes) + " bytes";
+            return false;
+        }
         
-        if (contentType && 
-            !isImageUrl(url) && 
-            std::string(contentType).find("text/html") == std::string::npos) {
-            monitoring->log(Monitoring::LogLevel::WARNING, 
-                "Skipping non-HTML content type: " + std::string(contentType ? contentType : "unknown") + " for URL: " + url);
-            success = false;
+        content.append(data, size);
+        if (scanner) {
+            scanner->feed(data, size);
+        }
+        if (relevance) {
+            relevance->feed(data, size);
+        }
+        return true;
+    };
+    
+    // Perform the request
+    auto fetchStart = std::chrono::steady_clock::now();
+    Fetcher::Result result = fetcher->fetch(request, onHeaders, onBody);
+    auto fetchTime = std::chrono::steady_clock::now() - fetchStart;
+    monitoring->recordLatency("fetch", fetchTime);
+    
+    if (record) {
+        record->status = static_cast<int>(result.status);
+        record->contentType = result.contentType;
+        record->wireBytes = result.wireBytes > 0 ? result.wireBytes : 0;
+        record->fetchMicros = std::chrono::duration_cast<std::chrono::microseconds>(fetchTime).count();
+        record->fetchedAt = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    // Check for errors
+    bool success = result.completed;
+    if (!abortReason.empty()) {
+        monitoring->log(Monitoring::LogLevel::WARNING, abortReason + " for URL: " + url);
+        success = false;
+    } else if (success) {
+        // Bytes received on the wire, before content decoding
+        if (result.wireBytes > 0) {
+            wireBytes += result.wireBytes;
+            if (static_cast<size_t>(result.wireBytes) < content.size()) {
+                monitoring->log(Monitoring::LogLevel::DEBUG,
+                    "Compressed transfer: " + std::to_string(result.wireBytes) + " -> " +
+                    std::to_string(content.size()) + " bytes for URL: " + url);
+            }
         }
     } else {
         monitoring->log(Monitoring::LogLevel::LOG_ERROR, 
-            "CURL error for URL: " + url + " - " + curl_easy_strerror(res));
+            "Fetch error for URL: " + url + " - " + result.error);
     }
     
-    // Clean up
-    curl_easy_cleanup(curl);
+    // Responses rejected on their headers are recorded without a body, so
+    // replay rejects them the same way. Transfers cut off midway are not.
+    if (recordArchive && result.status > 0 && (success || (!abortReason.empty() && content.empty()))) {
+        recordArchive->record(url, result.status, result.contentType,
+                              success ? -1 : result.contentLength, content);
+    }
     
     monitoring->stopProfiling("download_page");
     return success;
 }
 
-void WebCrawler::processImage(const std::string& url, const std::vector<uint8_t>& imageData) {
-    monitoring->startProfiling("process_image");
+// robots.txt bodies beyond 500 KiB are truncated (RFC 9309 section 2.5)
+static const size_t MAX_ROBOTS_TXT_BYTES = 500 * 1024;
+
+bool WebCrawler::fetchRobotsTxt(const std::string& url, long& status, std::string& body) {
+    Fetcher::Request request;
+    request.url = url;
+    request.timeoutSeconds = config.getTimeoutSeconds();
+    request.compressed = config.getCompressedTransfer();
     
-    try {
-        // Analyze image
-        auto features = imageAnalyzer->analyzeImageData(imageData);
-        
-        // Skip NSFW images
-        if (features.isNSFW) {
-            monitoring->log(Monitoring::LogLevel::WARNING, "Skipping NSFW image: " + url);
-            return;
+    Fetcher::Result result = fetcher->fetch(request,
+        [](long, const std::string&, long long) { return true; },
+        [&body](const char* data, size_t size) {
+            if (body.size() < MAX_ROBOTS_TXT_BYTES) {
+                body.append(data, std::min(size, MAX_ROBOTS_TXT_BYTES - body.size()));
+            }
+            return true;
+        });
+    
+    if (!result.completed) {
+        if (replaying) {
+            // Never recorded: crawl as if the site had no robots.txt
+            status = 404;
+            return true;
+        }
+        monitoring->log(Monitoring::LogLevel::WARNING, "Failed to fetch " + url + " - " + result.error);
+        return false;
+    }
+    
+    status = result.status;
+    monitoring->log(Monitoring::LogLevel::DEBUG,
+        "Fetched " + url + " (HTTP " + std::to_string(status) + ")");
+    if (recordArchive) {
+        recordArchive->record(url, status, result.contentType, -1, body);
+    }
+    return true;
+}
+
+void WebCrawler::rankThread() {
+    auto interval = std::chrono::seconds(std::max(1, config.getLinkRankIntervalSeconds()));
+    auto nextRank = std::chrono::steady_clock::now() + interval;
+    size_t rankedEdges = 0;
+    
+    while (state == CrawlerState::RUNNING || state == CrawlerState::PAUSED) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextRank) {
+            continue;
         }
         
-        // Save image data
-        std::string extension = getImageExtension(url);
+        // Skip a round if no page has been added since the last one
+        size_t edges = linkGraph->getStats().edges;
+        if (edges != rankedEdges) {
+            rankLinks();
+            rankedEdges = edges;
+        }
+        nextRank = std::chrono::steady_clock::now() + interval;
+    }
+}
+
+void WebCrawler::rankLinks() {
+    LinkGraph::RankOptions options;
+    options.algorithm = config.getLinkRankAlgorithm() == "hits" ? LinkGraph::Algorithm::HITS
+                                                                : LinkGraph::Algorithm::PAGERANK;
+    options.threads = static_cast<size_t>(std::max(0, config.getLinkRankThreads()));
+    options.maxIterations = std::max(1, config.getLinkRankIterations());
+    options.damping = config.getLinkRankDamping();
+    
+    auto started = std::chrono::steady_clock::now();
+    LinkGraph::RankResult result = linkGraph->rank(options);
+    
+    // Queued URLs move up or down with their new scores
+    float weight = static_cast<float>(config.getLinkRankWeight());
+    size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        urlQueue.reprioritize([this, weight](UrlEntry& entry) {
+            entry.rank = weight * linkGraph->getRank(entry.url);
+        });
+        queued = urlQueue.size();
+    }
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    monitoring->recordLatency("link_rank", elapsed);
+    monitoring->log(Monitoring::LogLevel::INFO, "Ranked " + std::to_string(result.urls) + " URLs over " +
+        std::to_string(result.edges) + " links in " + std::to_string(result.iterations) + " iterations (" +
+        std::to_string(static_cast<int>(elapsed.count() * 1000.0)) + " ms), reordered " +
+        std::to_string(queued) + " queued URLs");
+}
+
+// Sitemaps are capped at 50,000 URLs and 50 MiB uncompressed by the protocol
+static const size_t MAX_SITEMAP_BYTES = 50 * 1024 * 1024;
+static const size_t MAX_SITEMAP_FILES = 1000;
+
+void WebCrawler::sitemapThread(const std::string& startUrl) {
+    std::deque<std::string> sitemaps(config.getSitemapUrls().begin(), config.getSitemapUrls().end());
+    
+    // Without configured sitemaps, use the ones the start site advertises
+    std::string origin = RobotsCache::getOrigin(startUrl);
+    if (sitemaps.empty() && !origin.empty()) {
+        long status = 0;
+        std::string body;
+        if (fetchRobotsTxt(origin + "/robots.txt", status, body) && status >= 200 && status < 300) {
+            const std::vector<std::string>& advertised =
+                RobotsRules::parse(body, config.getUserAgent())->getSitemaps();
+            sitemaps.insert(sitemaps.end(), advertised.begin(), advertised.end());
+        }
+        if (sitemaps.empty()) {
+            sitemaps.push_back(origin + "/sitemap.xml");
+        }
+    }
+    
+    std::set<std::string> seen;
+    while (!sitemaps.empty() && seen.size() < MAX_SITEMAP_FILES &&
+           (state == CrawlerState::RUNNING || state == CrawlerState::PAUSED)) {
+        std::string sitemapUrl = sitemaps.front();
+        sitemaps.pop_front();
+        if (!seen.insert(sitemapUrl).second) {
+            continue;
+        }
         
-        // Use try/catch to handle potential errors in saveImage
-        try {
-            // Save the image using FileIndexer
-            if (fileIndexer->saveImage(url, imageData, extension)) {
-                // Save metadata to database
-                std::string description = features.description.empty() ? "No description" : features.description;
-                // Convert vectors to a single string for the database
-                std::string labelsStr = vectorToString(features.labels);
-                std::string objectsStr = vectorToString(features.objects);
-                
-                // Add image metadata to database
-                try {
-                    database->addImage(url, description, labelsStr, objectsStr);
-                    monitoring->log(Monitoring::LogLevel::INFO, "Processed image: " + url);
-                    imagesProcessed++;
-                } catch (...) {
-                    monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to add image metadata to database: " + url);
-                    failedRequests++;
-                }
-            } else {
-                monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to save image: " + url);
-                failedRequests++;
+        std::vector<std::string> children;
+        bool keepGoing = ingestSitemap(sitemapUrl, children);
+        sitemaps.insert(sitemaps.end(), children.begin(), children.end());
+        if (!keepGoing) {
+            break;
+        }
+    }
+    
+    sitemapLoading = false;
+    queueCondition.notify_all();
+}
+
+bool WebCrawler::ingestSitemap(const std::string& sitemapUrl, std::vector<std::string>& childSitemaps) {
+    monitoring->log(Monitoring::LogLevel::INFO, "Reading sitemap: " + sitemapUrl);
+    
+    size_t batchSize = static_cast<size_t>(std::max(config.getBatchSize(), 1));
+    std::vector<UrlEntry> batch;
+    batch.reserve(batchSize);
+    bool frontierFull = false;
+    size_t decodedBytes = 0;
+    
+    SitemapParser parser(
+        [this, &batch, batchSize, &frontierFull](const SitemapParser::Entry& item) {
+            if (frontierFull || !isDomainAllowed(item.loc) || !pathFilter.isAllowed(item.loc)) {
+                return;
             }
-        } catch (...) {
-            monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Exception occurred while saving image: " + url);
-            failedRequests++;
+            UrlEntry entry;
+            entry.url = item.loc;
+            entry.depth = 0;
+            entry.priority = item.priority;
+            entry.lastModified = item.lastModified;
+            batch.push_back(std::move(entry));
+            if (batch.size() >= batchSize) {
+                frontierFull = !scheduleUrls(batch);
+            }
+        },
+        [&childSitemaps](const SitemapParser::Entry& item) {
+            childSitemaps.push_back(item.loc);
+        });
+    
+    // Decoded XML goes straight into the parser; nothing is buffered
+    GzipInflater inflater([this, &parser, &frontierFull, &decodedBytes](const char* data, size_t size) {
+        decodedBytes += size;
+        if (frontierFull || decodedBytes > MAX_SITEMAP_BYTES ||
+            (state != CrawlerState::RUNNING && state != CrawlerState::PAUSED)) {
+            return false;
+        }
+        parser.feed(data, size);
+        return true;
+    });
+    
+    // Raw sitemap bytes go to the inflater, and to the record archive if one is open
+    std::string raw;
+    Fetcher::Request request;
+    request.url = sitemapUrl;
+    // Large sitemaps stream for a while; allow more than a page fetch
+    request.timeoutSeconds = config.getTimeoutSeconds() * 10;
+    
+    Fetcher::Result result = fetcher->fetch(request,
+        [](long, const std::string&, long long) { return true; },
+        [this, &inflater, &raw](const char* data, size_t size) {
+            if (recordArchive) {
+                raw.append(data, size);
+            }
+            return inflater.feed(data, size);
+        });
+    long status = result.status;
+    
+    // Only complete sitemaps are worth replaying
+    if (recordArchive && result.completed) {
+        recordArchive->record(sitemapUrl, status, "application/xml", -1, raw);
+    }
+    
+    if (result.completed && status == 200) {
+        if (inflater.finish()) {
+            parser.finish();
+        } else {
+            monitoring->log(Monitoring::LogLevel::WARNING,
+                "Bad sitemap " + sitemapUrl + ": " + inflater.getError());
         }
+    } else if (frontierFull) {
+        monitoring->log(Monitoring::LogLevel::INFO, "URL queue is full; stopped reading sitemap " + sitemapUrl);
+    } else if (decodedBytes > MAX_SITEMAP_BYTES) {
+        monitoring->log(Monitoring::LogLevel::WARNING, "Sitemap exceeds 50 MiB: " + sitemapUrl);
+    } else if (!result.completed) {
+        monitoring->log(Monitoring::LogLevel::WARNING, "Failed to fetch sitemap " + sitemapUrl + " - " +
+            (result.error.empty() ? std::string("transfer aborted") : result.error));
+    } else {
+        monitoring->log(Monitoring::LogLevel::WARNING,
+            "Failed to fetch sitemap " + sitemapUrl + " (HTTP " + std::to_string(status) + ")");
+    }
+    
+    // Whatever was parsed before the transfer ended is still worth queueing
+    if (!frontierFull && !batch.empty()) {
+        frontierFull = !scheduleUrls(batch);
+    }
+    
+    monitoring->log(Monitoring::LogLevel::INFO,
+        "Sitemap " + sitemapUrl + ": " + std::to_string(parser.getUrlCount()) + " URLs, " +
+        std::to_string(parser.getSitemapCount()) + " child sitemaps");
+    return !frontierFull;
+}
+
+void WebCrawler::processImage(const std::string& url, const std::string& imageData) {
+    monitoring->startProfiling("process_image");
+    
+    // View the downloaded body as bytes instead of copying it
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(imageData.data());
+    
+    try {
+        // Analyze image
+        auto features = imageAnalyzer->analyzeImageData(data, imageData.size());
+        storeImage(url, imageData, features);
     } catch (const std::exception& e) {
         monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to process image: " + url + " - " + e.what());
         failedRequests++;
@@ -581,18 +1485,63 @@ void WebCrawler::processImage(const std::string& url, const std::vector<uint8_t>
     monitoring->stopProfiling("process_image");
 }
 
-bool WebCrawler::isImageUrl(const std::string& url) {
+void WebCrawler::storeImage(const std::string& url, const std::string& imageData,
+                            const ImageAnalyzer::ImageFeatures& features) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(imageData.data());
+    
+    // Skip NSFW images
+    if (features.isNSFW) {
+        monitoring->log(Monitoring::LogLevel::WARNING, "Skipping NSFW image: " + url);
+        return;
+    }
+    
+    // Save image data
+    std::string extension = getImageExtension(url);
+    
+    // Use try/catch to handle potential errors in saveImage
+    try {
+        // Save the image using FileIndexer
+        if (fileIndexer->saveImage(url, data, imageData.size(), extension)) {
+            // Save metadata to database
+            std::string description = features.description.empty() ? "No description" : features.description;
+            // Convert vectors to a single string for the database
+            std::string labelsStr = vectorToString(features.labels);
+            std::string objectsStr = vectorToString(features.objects);
+            
+            // Add image metadata to database
+            try {
+                database->addImage(url, description, labelsStr, objectsStr);
+                monitoring->log(Monitoring::LogLevel::INFO, "Processed image: " + url);
+                imagesProcessed++;
+            } catch (...) {
+                monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to add image metadata to database: " + url);
+                failedRequests++;
+            }
+        } else {
+            monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Failed to save image: " + url);
+            failedRequests++;
+        }
+    } catch (...) {
+        monitoring->log(Monitoring::LogLevel::LOG_ERROR, "Exception occurred while saving image: " + url);
+        failedRequests++;
+    }
+}
+
+bool WebCrawler::isImageUrl(std::string_view url) {
     // Check file extension
-    static const std::vector<std::string> imageExtensions = {
+    static const char* const imageExtensions[] = {
         ".jpg", ".jpeg", ".png", ".gif", ".bmp", ".webp", ".svg"
     };
     
-    std::string lowerUrl = url;
-    std::transform(lowerUrl.begin(), lowerUrl.end(), lowerUrl.begin(), ::tolower);
-    
-    for (const auto& ext : imageExtensions) {
-        if (lowerUrl.size() >= ext.size() && 
-            lowerUrl.substr(lowerUrl.size() - ext.size()) == ext) {
+    for (const char* ext : imageExtensions) {
+        size_t length = std::strlen(ext);
+        if (url.size() < length) {
+            continue;
+        }
+        std::string_view suffix = url.substr(url.size() - length);
+        if (std::equal(suffix.begin(), suffix.end(), ext, [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == b;
+            })) {
             return true;
         }
     }
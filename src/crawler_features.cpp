@@ -1,32 +1,15 @@
 #include "crawler_features.hpp"
+#include "compression.hpp"
+#include "sitemap_parser.hpp"
 #include <stdexcept>
 #include <regex>
 #include <algorithm>
 #include <iomanip> // For std::get_time
 #include <sstream>
+#include <cstring>
+#include <cctype>
 
 #ifdef STUB_IMPLEMENTATION
-// Define a stub implementation for tinyxml2
-namespace tinyxml2 {
-    class XMLElement {
-    public:
-        XMLElement* FirstChildElement(const char*) { return nullptr; }
-        XMLElement* NextSiblingElement(const char*) { return nullptr; }
-        const char* GetText() { return "stub_text"; }
-    };
-    
-    class XMLDocument {
-    public:
-        XMLDocument() {}
-        int Parse(const char*) { return 0; }
-        XMLElement* RootElement() { return nullptr; }
-    };
-    
-    enum XMLError {
-        XML_SUCCESS = 0
-    };
-}
-
 // Define a stub implementation for curl
 struct CURL_stub { int dummy; }; // Make it a complete type with a dummy field
 typedef CURL_stub CURL;
@@ -37,6 +20,8 @@ typedef int CURLcode;
 #define CURLOPT_WRITEDATA 10001
 #define CURLOPT_HEADER 10002
 #define CURLOPT_NOBODY 10003
+#define CURLOPT_HEADERFUNCTION 20079
+#define CURLOPT_HEADERDATA 10029
 
 // Use inline functions with unique names to avoid conflicts
 inline CURL* curl_easy_init_stub() { return new CURL(); }
@@ -65,7 +50,6 @@ namespace std {
 }
 
 #else
-#include <tinyxml2.h>
 #include <curl/curl.h>
 #endif
 
@@ -120,52 +104,74 @@ bool CrawlerFeatures::isAllowed(const std::string& url, const std::string& userA
         return true; // Default allow if no rules found
     }
 
-    for (const auto& rule : it->second) {
-        if (rule.userAgent == "*" || rule.userAgent == userAgent) {
-            for (const auto& disallow : rule.disallow) {
-                if (url.find(disallow) != std::string::npos) {
-                    return false;
-                }
-            }
-            for (const auto& allow : rule.allow) {
-                if (url.find(allow) != std::string::npos) {
-                    return true;
-                }
-            }
+    // Rules are precompiled for our own agent, and for others once asked about
+    if (userAgent == "*" || userAgent == this->userAgent) {
+        return it->second->isUrlAllowed(url);
+    }
+    std::shared_ptr<RobotsRules> rules;
+    {
+        std::lock_guard<std::mutex> lock(agentRulesMutex);
+        auto& cached = agentRules[domain][userAgent];
+        if (!cached) {
+            cached = RobotsRules::parse(robotsText.at(domain), userAgent);
         }
+        rules = cached;
     }
-
-    return true;
+    return rules->isUrlAllowed(url);
 }
 
 int CrawlerFeatures::getCrawlDelay(const std::string& domain) const {
     auto it = robotsRules.find(domain);
     if (it != robotsRules.end()) {
-        for (const auto& rule : it->second) {
-            if (rule.userAgent == "*") {
-                return rule.crawlDelay;
-            }
-        }
+        return it->second->getCrawlDelay();
     }
     return 0; // Default no delay
 }
 
+static size_t SitemapWriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realSize = size * nmemb;
+    GzipInflater* inflater = static_cast<GzipInflater*>(userp);
+    return inflater->feed(static_cast<const char*>(contents), realSize) ? realSize : 0;
+}
+
 bool CrawlerFeatures::loadSitemap(const std::string& url) {
-    std::string content;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, 
-        [](void* contents, size_t size, size_t nmemb, std::string* userp) {
-            userp->append((char*)contents, size * nmemb);
-            return size * nmemb;
+    std::vector<SitemapEntry> entries;
+    std::vector<std::string> children;
+    SitemapParser parser(
+        [&entries](const SitemapParser::Entry& item) {
+            entries.push_back(toSitemapEntry(item));
+        },
+        [&children](const SitemapParser::Entry& item) {
+            children.push_back(item.loc);
         });
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &content);
+
+    // Stream the (possibly gzipped) body through the parser
+    GzipInflater inflater([&parser](const char* data, size_t size) {
+        parser.feed(data, size);
+        return true;
+    });
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, SitemapWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &inflater);
 
     CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
+    if (res != CURLE_OK || !inflater.finish()) {
         return false;
     }
+    parser.finish();
+
+    sitemaps[url] = std::move(entries);
 
-    return parseSitemap(content);
+    // Sitemap indexes cannot nest, so children are plain sitemaps
+    if (parser.isIndex()) {
+        for (const auto& child : children) {
+            if (sitemaps.find(child) == sitemaps.end()) {
+                loadSitemap(child);
+            }
+        }
+    }
+    return true;
 }
 
 std::vector<std::string> CrawlerFeatures::getSitemapUrls() const {
@@ -192,29 +198,58 @@ bool CrawlerFeatures::isSupportedContentType(const std::string& contentType) con
                     contentType) != SUPPORTED_CONTENT_TYPES.end();
 }
 
-std::string CrawlerFeatures::getContentType(const std::string& url) const {
-    std::string content;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HEADER, 1L);
-    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, 
-        [](void* contents, size_t size, size_t nmemb, std::string* userp) {
-            userp->append((char*)contents, size * nmemb);
-            return size * nmemb;
-        });
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &content);
+// Collects the Content-Type of the final response from a HEAD request
+static size_t ContentTypeHeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    size_t realSize = size * nitems;
+    std::string* contentType = static_cast<std::string*>(userdata);
+    
+    // Every redirect hop starts with a new status line
+    if (realSize > 5 && std::strncmp(buffer, "HTTP/", 5) == 0) {
+        contentType->clear();
+        return realSize;
+    }
+    
+    static const char name[] = "content-type:";
+    const size_t nameLength = sizeof(name) - 1;
+    if (realSize > nameLength) {
+        for (size_t i = 0; i < nameLength; ++i) {
+            if (std::tolower(static_cast<unsigned char>(buffer[i])) != name[i]) {
+                return realSize;
+            }
+        }
+        size_t start = nameLength;
+        size_t end = realSize;
+        while (start < end && (buffer[start] == ' ' || buffer[start] == '\t')) {
+            start++;
+        }
+        while (end > start && (buffer[end - 1] == '\r' || buffer[end - 1] == '\n')) {
+            end--;
+        }
+        contentType->assign(buffer + start, end - start);
+    }
+    return realSize;
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
+std::string CrawlerFeatures::getContentType(const std::string& url) const {
+    // A dedicated handle per call keeps this safe to use from several threads
+    CURL* handle = curl_easy_init();
+    if (!handle) {
         return "";
     }
-
-    std::regex contentTypeRegex("Content-Type:\\s*([^\\r\\n]+)");
-    std::smatch match;
-    if (std::regex_search(content, match, contentTypeRegex)) {
-        return match[1].str();
+    
+    std::string contentType;
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, ContentTypeHeaderCallback);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &contentType);
+    
+    CURLcode res = curl_easy_perform(handle);
+    curl_easy_cleanup(handle);
+    
+    if (res != CURLE_OK) {
+        return "";
     }
-    return "";
+    return contentType;
 }
 
 bool CrawlerFeatures::isBinaryContent(const std::string& contentType) const {
@@ -263,66 +298,40 @@ bool CrawlerFeatures::fetchRobotsTxt(const std::string& domain) {
 }
 
 bool CrawlerFeatures::parseRobotsTxt(const std::string& content, const std::string& domain) {
-    std::vector<RobotsRule> rules;
-    RobotsRule currentRule;
-    currentRule.userAgent = "*";
-    currentRule.crawlDelay = 0;
-
-    std::istringstream stream(content);
-    std::string line;
-    while (std::getline(stream, line)) {
-        std::istringstream lineStream(line);
-        std::string directive;
-        lineStream >> directive;
-
-        if (directive == "User-agent:") {
-            if (!currentRule.allow.empty() || !currentRule.disallow.empty()) {
-                rules.push_back(currentRule);
-                currentRule = RobotsRule();
-            }
-            lineStream >> currentRule.userAgent;
-        }
-        else if (directive == "Allow:") {
-            std::string path;
-            lineStream >> path;
-            currentRule.allow.push_back(path);
-        }
-        else if (directive == "Disallow:") {
-            std::string path;
-            lineStream >> path;
-            currentRule.disallow.push_back(path);
-        }
-        else if (directive == "Crawl-delay:") {
-            lineStream >> currentRule.crawlDelay;
-        }
+    robotsRules[domain] = RobotsRules::parse(content, userAgent);
+    robotsText[domain] = content;
+    {
+        std::lock_guard<std::mutex> lock(agentRulesMutex);
+        agentRules.erase(domain);
     }
-
-    if (!currentRule.allow.empty() || !currentRule.disallow.empty()) {
-        rules.push_back(currentRule);
-    }
-
-    robotsRules[domain] = rules;
     return true;
 }
 
-bool CrawlerFeatures::parseSitemap(const std::string& content) {
-    // Stub implementation
-    tinyxml2::XMLDocument doc;
-    doc.Parse(content.c_str());
-    
-    // Create a dummy sitemap entry
+bool CrawlerFeatures::parseSitemap(const std::string& content, const std::string& sitemapUrl) {
     std::vector<SitemapEntry> entries;
-    SitemapEntry entry;
-    entry.url = "https://example.com";
-    entry.priority = 0.5f;
-    entry.changeFrequency = "daily";
-    entry.lastModified = std::chrono::system_clock::now();
-    
-    entries.push_back(entry);
-    sitemaps["example.com"] = entries;
+    SitemapParser parser(
+        [&entries](const SitemapParser::Entry& item) {
+            entries.push_back(toSitemapEntry(item));
+        },
+        nullptr);
+    parser.feed(content.data(), content.size());
+    parser.finish();
+
+    sitemaps[sitemapUrl] = std::move(entries);
     return true;
 }
 
+CrawlerFeatures::SitemapEntry CrawlerFeatures::toSitemapEntry(const SitemapParser::Entry& item) {
+    SitemapEntry entry;
+    entry.url = item.loc;
+    entry.priority = item.priority;
+    entry.changeFrequency = item.changeFrequency;
+    if (item.lastModified > 0) {
+        entry.lastModified = std::chrono::system_clock::from_time_t(item.lastModified);
+    }
+    return entry;
+}
+
 std::string CrawlerFeatures::extractDomain(const std::string& url) const {
     std::regex domainRegex("https?://([^/]+)");
     std::smatch match;
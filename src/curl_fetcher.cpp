@@ -0,0 +1,250 @@
+#include "../include/curl_fetcher.hpp"
+#include "../include/build_config.hpp"
+#include "../include/compat_fixes.hpp"
+#include "../include/dns_cache.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef STUB_IMPLEMENTATION
+#include "curl_stubs.hpp"
+#endif
+
+namespace {
+
+// Per-transfer state shared with the CURL header and write callbacks
+struct CurlTransfer {
+    const Fetcher::HeaderHandler* onHeaders;
+    const Fetcher::BodyHandler* onBody;
+    bool followRedirects;
+
+    // Headers of the response currently being received
+    long status = 0;
+    std::string contentType;
+    long long contentLength = -1;
+
+    bool decided = false;
+    bool aborted = false;
+};
+
+bool HeaderNameEquals(const char* name, size_t length, const char* expected) {
+    size_t i = 0;
+    for (; i < length && expected[i]; ++i) {
+        if (std::tolower(static_cast<unsigned char>(name[i])) != expected[i]) {
+            return false;
+        }
+    }
+    return i == length && expected[i] == '\0';
+}
+
+// Hand the final response's headers to the caller, once
+bool Decide(CurlTransfer* transfer) {
+    transfer->decided = true;
+    if (!(*transfer->onHeaders)(transfer->status, transfer->contentType, transfer->contentLength)) {
+        transfer->aborted = true;
+        return false;
+    }
+    return true;
+}
+
+// Invoked once per header line
+size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    size_t realSize = size * nitems;
+    CurlTransfer* transfer = static_cast<CurlTransfer*>(userdata);
+
+    size_t length = realSize;
+    while (length > 0 && (buffer[length - 1] == '\r' || buffer[length - 1] == '\n')) {
+        length--;
+    }
+
+    // A status line starts a new response (redirects and 1xx send several)
+    if (length > 5 && std::strncmp(buffer, "HTTP/", 5) == 0) {
+        const char* space = static_cast<const char*>(std::memchr(buffer, ' ', length));
+        transfer->status = space ? std::strtol(space + 1, nullptr, 10) : 0;
+        transfer->contentType.clear();
+        transfer->contentLength = -1;
+        return realSize;
+    }
+
+    // Blank line: headers of this response are complete
+    if (length == 0) {
+        bool interim = transfer->status >= 100 && transfer->status < 200;
+        bool redirect = transfer->followRedirects && transfer->status >= 300 && transfer->status < 400;
+        if (!interim && !redirect && !transfer->decided && !Decide(transfer)) {
+            return 0;
+        }
+        return realSize;
+    }
+
+    const char* colon = static_cast<const char*>(std::memchr(buffer, ':', length));
+    if (!colon) {
+        return realSize;
+    }
+
+    const char* value = colon + 1;
+    const char* valueEnd = buffer + length;
+    while (value < valueEnd && (*value == ' ' || *value == '\t')) {
+        value++;
+    }
+
+    size_t nameLength = colon - buffer;
+    if (HeaderNameEquals(buffer, nameLength, "content-type")) {
+        transfer->contentType.assign(value, valueEnd);
+    } else if (HeaderNameEquals(buffer, nameLength, "content-length")) {
+        transfer->contentLength = std::strtoll(value, nullptr, 10);
+    }
+
+    return realSize;
+}
+
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realSize = size * nmemb;
+    CurlTransfer* transfer = static_cast<CurlTransfer*>(userp);
+
+    // Redirects that were not followed deliver a body without a decision
+    if (!transfer->decided && !Decide(transfer)) {
+        return 0;
+    }
+
+    if (!(*transfer->onBody)(static_cast<const char*>(contents), realSize)) {
+        transfer->aborted = true;
+        return 0;
+    }
+    return realSize;
+}
+
+} // namespace
+
+CurlFetcher::CurlFetcher(const std::string& userAgent, DnsCache* dnsCache, size_t asyncThreads)
+    : userAgent(userAgent)
+    , dnsCache(dnsCache)
+    , asyncThreads(asyncThreads > 0 ? asyncThreads : 1)
+    , stopping(false) {
+}
+
+CurlFetcher::~CurlFetcher() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        stopping = true;
+    }
+    pendingCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Fetches still queued are not started, but their owners hear of it
+    for (auto& task : pending) {
+        Result result;
+        result.error = "Fetcher shut down before the transfer started";
+        task.onComplete(result);
+    }
+}
+
+const char* CurlFetcher::getName() const {
+    return "curl";
+}
+
+Fetcher::Result CurlFetcher::fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) {
+    Result result;
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        result.error = "Failed to initialize CURL";
+        return result;
+    }
+
+    CurlTransfer transfer;
+    transfer.onHeaders = &onHeaders;
+    transfer.onBody = &onBody;
+    transfer.followRedirects = request.followRedirects;
+
+    // Pin the host to the shared DNS cache so this handle skips resolution
+    struct curl_slist* resolveList = nullptr;
+    std::string host;
+    int port;
+    if (dnsCache && DnsCache::splitHostPort(request.url, host, port)) {
+        std::vector<std::string> addresses;
+        if (dnsCache->lookup(host, addresses, request.timeoutSeconds * 1000)) {
+            resolveList = curl_slist_append(resolveList,
+                DnsCache::formatResolveEntry(host, port, addresses).c_str());
+        } else if (dnsCache->isNegative(host)) {
+            curl_easy_cleanup(curl);
+            result.error = "DNS resolution failed for host: " + host;
+            return result;
+        }
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    if (resolveList) {
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, resolveList);
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, userAgent.c_str());
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, request.timeoutSeconds);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, request.followRedirects ? 1L : 0L);
+
+    // Advertise every content encoding libcurl was built with (gzip, deflate,
+    // br, zstd). libcurl decodes each received chunk before it reaches
+    // WriteCallback, so the body handler only ever sees decoded bytes.
+    if (request.compressed) {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
+
+    CURLcode res = curl_easy_perform(curl);
+
+    // An unfollowed redirect with an empty body never reached a decision
+    if (res == CURLE_OK && !transfer.decided) {
+        Decide(&transfer);
+    }
+
+    result.completed = res == CURLE_OK && !transfer.aborted;
+    result.status = transfer.status;
+    result.contentType = transfer.contentType;
+    result.contentLength = transfer.contentLength;
+    if (res == CURLE_OK) {
+        curl_off_t downloaded = 0;
+        if (curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded) == CURLE_OK) {
+            result.wireBytes = static_cast<long long>(downloaded);
+        }
+    } else if (!transfer.aborted) {
+        result.error = curl_easy_strerror(res);
+    }
+
+    curl_easy_cleanup(curl);
+    if (resolveList) {
+        curl_slist_free_all(resolveList);
+    }
+    return result;
+}
+
+void CurlFetcher::fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                             CompletionHandler onComplete) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (workers.empty()) {
+        for (size_t i = 0; i < asyncThreads; ++i) {
+            workers.emplace_back(&CurlFetcher::asyncWorker, this);
+        }
+    }
+    pending.push_back(AsyncFetch{request, std::move(onHeaders), std::move(onBody), std::move(onComplete)});
+    pendingCondition.notify_one();
+}
+
+void CurlFetcher::asyncWorker() {
+    while (true) {
+        AsyncFetch task;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingCondition.wait(lock, [this] { return stopping || !pending.empty(); });
+            // Fetches still queued at shutdown are failed by the destructor
+            if (stopping) {
+                return;
+            }
+            task = std::move(pending.front());
+            pending.pop_front();
+        }
+        task.onComplete(fetch(task.request, task.onHeaders, task.onBody));
+    }
+}
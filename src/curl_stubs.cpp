@@ -26,6 +26,14 @@ const char* curl_easy_strerror(CURLcode code) {
     return "Stub error";
 }
 
+struct curl_slist* curl_slist_append(struct curl_slist* list, const char* string) {
+    return list;
+}
+
+void curl_slist_free_all(struct curl_slist* list) {
+    // Do nothing
+}
+
 char* curl_easy_escape(void* handle, const char* string, int length) {
     return nullptr;
 }
@@ -0,0 +1,282 @@
+#include "../include/dns_cache.hpp"
+#include <cstring>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#endif
+
+DnsCache::DnsCache(size_t resolverThreads, std::chrono::seconds positiveTtl,
+                   std::chrono::seconds negativeTtl, size_t maxEntries)
+    : positiveTtl(positiveTtl)
+    , negativeTtl(negativeTtl)
+    , maxEntries(maxEntries)
+    , stopping(false)
+    , hits(0)
+    , misses(0)
+    , negativeHits(0) {
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    for (size_t i = 0; i < resolverThreads; ++i) {
+        resolvers.emplace_back(&DnsCache::resolverThread, this);
+    }
+}
+
+DnsCache::~DnsCache() {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        stopping = true;
+    }
+    pendingCondition.notify_all();
+    resolvedCondition.notify_all();
+
+    for (auto& thread : resolvers) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void DnsCache::prefetch(const std::string& host) {
+    if (host.empty()) {
+        return;
+    }
+
+    bool queued;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        queued = enqueueLocked(host);
+    }
+    if (queued) {
+        pendingCondition.notify_one();
+    }
+}
+
+bool DnsCache::lookup(const std::string& host, std::vector<std::string>& addresses, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(cacheMutex);
+    auto now = std::chrono::steady_clock::now();
+
+    auto it = entries.find(host);
+    if (it != entries.end() && it->second.expires > now) {
+        if (it->second.negative) {
+            negativeHits++;
+            return false;
+        }
+        hits++;
+        addresses = it->second.addresses;
+        return true;
+    }
+
+    misses++;
+    if (enqueueLocked(host)) {
+        pendingCondition.notify_one();
+    }
+
+    // Wait for a resolver thread to publish a fresh entry
+    auto deadline = now + std::chrono::milliseconds(timeoutMs);
+    bool resolved = resolvedCondition.wait_until(lock, deadline, [this, &host] {
+        if (stopping) {
+            return true;
+        }
+        auto found = entries.find(host);
+        return found != entries.end() && found->second.expires > std::chrono::steady_clock::now();
+    });
+
+    if (!resolved || stopping) {
+        return false;
+    }
+
+    const Entry& entry = entries[host];
+    if (entry.negative) {
+        return false;
+    }
+    addresses = entry.addresses;
+    return true;
+}
+
+bool DnsCache::isNegative(const std::string& host) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = entries.find(host);
+    return it != entries.end() && it->second.negative &&
+           it->second.expires > std::chrono::steady_clock::now();
+}
+
+bool DnsCache::enqueueLocked(const std::string& host) {
+    auto it = entries.find(host);
+    if (it != entries.end() && it->second.expires > std::chrono::steady_clock::now()) {
+        return false;
+    }
+    if (!inFlight.insert(host).second) {
+        return false;
+    }
+    pending.push_back(host);
+    return true;
+}
+
+void DnsCache::resolverThread() {
+    while (true) {
+        std::string host;
+        {
+            std::unique_lock<std::mutex> lock(cacheMutex);
+            pendingCondition.wait(lock, [this] {
+                return stopping || !pending.empty();
+            });
+            if (stopping) {
+                return;
+            }
+            host = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        resolve(host);
+    }
+}
+
+void DnsCache::resolve(const std::string& host) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    Entry entry;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) == 0) {
+        for (addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
+            char buffer[INET6_ADDRSTRLEN] = {0};
+            const void* addr = nullptr;
+            if (ai->ai_family == AF_INET) {
+                addr = &reinterpret_cast<sockaddr_in*>(ai->ai_addr)->sin_addr;
+            } else if (ai->ai_family == AF_INET6) {
+                addr = &reinterpret_cast<sockaddr_in6*>(ai->ai_addr)->sin6_addr;
+            }
+            if (addr && inet_ntop(ai->ai_family, addr, buffer, sizeof(buffer))) {
+                std::string address = ai->ai_family == AF_INET6 ? "[" + std::string(buffer) + "]" : buffer;
+                bool duplicate = false;
+                for (const auto& existing : entry.addresses) {
+                    duplicate = duplicate || existing == address;
+                }
+                if (!duplicate) {
+                    entry.addresses.push_back(address);
+                }
+            }
+        }
+        freeaddrinfo(result);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    entry.negative = entry.addresses.empty();
+    entry.expires = now + (entry.negative ? negativeTtl : positiveTtl);
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (entries.size() >= maxEntries) {
+            evictLocked(now);
+        }
+        entries[host] = std::move(entry);
+        inFlight.erase(host);
+    }
+    resolvedCondition.notify_all();
+}
+
+void DnsCache::evictLocked(std::chrono::steady_clock::time_point now) {
+    // Drop expired entries first
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expires <= now) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Still full: drop the entry closest to expiry
+    if (entries.size() >= maxEntries) {
+        auto oldest = entries.begin();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second.expires < oldest->second.expires) {
+                oldest = it;
+            }
+        }
+        if (oldest != entries.end()) {
+            entries.erase(oldest);
+        }
+    }
+}
+
+std::string DnsCache::formatResolveEntry(const std::string& host, int port,
+                                         const std::vector<std::string>& addresses) {
+    std::string entry = host + ":" + std::to_string(port) + ":";
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        if (i > 0) {
+            entry += ",";
+        }
+        entry += addresses[i];
+    }
+    return entry;
+}
+
+bool DnsCache::splitHostPort(const std::string& url, std::string& host, int& port) {
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string::npos) {
+        return false;
+    }
+
+    std::string scheme = url.substr(0, schemeEnd);
+    size_t start = schemeEnd + 3;
+    size_t end = url.find_first_of("/?#", start);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+
+    // Strip credentials
+    size_t at = url.rfind('@', end);
+    if (at != std::string::npos && at >= start) {
+        start = at + 1;
+    }
+
+    std::string authority = url.substr(start, end - start);
+    port = (scheme == "https") ? 443 : 80;
+
+    if (!authority.empty() && authority[0] == '[') {
+        // IPv6 literals never need resolving
+        return false;
+    }
+
+    size_t colon = authority.find(':');
+    if (colon != std::string::npos) {
+        port = std::atoi(authority.c_str() + colon + 1);
+        authority.resize(colon);
+    }
+
+    host = authority;
+    return !host.empty();
+}
+
+size_t DnsCache::getHits() const {
+    return hits;
+}
+
+size_t DnsCache::getMisses() const {
+    return misses;
+}
+
+size_t DnsCache::getNegativeHits() const {
+    return negativeHits;
+}
+
+size_t DnsCache::getSize() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
@@ -0,0 +1,51 @@
+#include "../include/fetcher.hpp"
+#include "../include/config.hpp"
+#include "../include/curl_fetcher.hpp"
+#include "../include/replay_fetcher.hpp"
+#include "../include/synthetic_fetcher.hpp"
+#include <algorithm>
+
+void Fetcher::fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                         CompletionHandler onComplete) {
+    onComplete(fetch(request, onHeaders, onBody));
+}
+
+std::unique_ptr<Fetcher> Fetcher::create(const Config& config, DnsCache* dnsCache, std::string& error) {
+    error.clear();
+
+    std::string name = config.getFetcher();
+    if (name.empty()) {
+        name = config.getReplayArchive().empty() ? "curl" : "replay";
+    }
+
+    if (name == "replay") {
+        // Kept even if the archive cannot be opened, so every fetch fails
+        // instead of silently going to the network
+        auto replay = std::make_unique<ReplayFetcher>(config.getReplayArchive());
+        if (!replay->isOpen()) {
+            error = "Failed to open replay archive: " + replay->getError();
+        }
+        return replay;
+    }
+
+    if (name == "synthetic") {
+        SyntheticWeb::Options options;
+        options.pageCount = static_cast<size_t>(std::max(1, config.getSyntheticPageCount()));
+        options.fanout = static_cast<size_t>(std::max(0, config.getSyntheticFanout()));
+        options.pageBytes = static_cast<size_t>(std::max(0, config.getSyntheticPageKB())) * 1024;
+        options.latencyMedianMs = config.getSyntheticLatencyMs();
+        options.latencyP99Ms = config.getSyntheticLatencyP99Ms();
+        options.errorRate = config.getSyntheticErrorRate();
+        options.redirectRate = config.getSyntheticRedirectRate();
+        options.gzip = false;
+        options.hostCount = static_cast<size_t>(std::max(1, config.getSyntheticHostCount()));
+        options.seed = static_cast<uint64_t>(config.getSyntheticSeed());
+        return std::make_unique<SyntheticFetcher>(options);
+    }
+
+    if (name != "curl") {
+        error = "Unknown fetcher '" + name + "', using curl";
+    }
+    return std::make_unique<CurlFetcher>(config.getUserAgent(), dnsCache,
+                                         static_cast<size_t>(std::max(1, config.getThreadCount())));
+}
@@ -322,6 +322,10 @@ void FileIndexer::optimizeIndex() {
 }
 
 bool FileIndexer::saveImage(const std::string& url, const std::vector<uint8_t>& imageData, const std::string& extension) {
+    return saveImage(url, imageData.data(), imageData.size(), extension);
+}
+
+bool FileIndexer::saveImage(const std::string& url, const uint8_t* data, size_t size, const std::string& extension) {
     std::unique_lock<std::shared_mutex> lock(index_mutex);
     
     try {
@@ -341,7 +345,7 @@ bool FileIndexer::saveImage(const std::string& url, const std::vector<uint8_t>&
             return false;
         }
         
-        file.write(reinterpret_cast<const char*>(imageData.data()), imageData.size());
+        file.write(reinterpret_cast<const char*>(data), size);
         file.close();
         
         // Store the mapping from URL to file path
@@ -0,0 +1,95 @@
+#include "../include/hash_ring.hpp"
+#include "../include/fnv_hash.hpp"
+#include <algorithm>
+
+namespace {
+
+const std::string NO_NODE;
+
+char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+} // namespace
+
+HashRing::HashRing(size_t virtualNodes)
+    : virtualNodes(std::max<size_t>(1, virtualNodes)) {
+}
+
+uint64_t HashRing::hashKey(std::string_view key) {
+    // FNV-1a, then a finalizer so that similar keys land far apart
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (char c : key) {
+        hash = fnvStep(hash, static_cast<unsigned char>(lower(c)));
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool HashRing::addNode(const std::string& node) {
+    if (hasNode(node)) {
+        return false;
+    }
+    nodes.push_back(node);
+    rebuild();
+    return true;
+}
+
+bool HashRing::removeNode(const std::string& node) {
+    auto it = std::find(nodes.begin(), nodes.end(), node);
+    if (it == nodes.end()) {
+        return false;
+    }
+    nodes.erase(it);
+    rebuild();
+    return true;
+}
+
+bool HashRing::hasNode(const std::string& node) const {
+    return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+}
+
+void HashRing::rebuild() {
+    // Points depend only on the node names, so every member that knows the
+    // same set of nodes builds the same ring
+    points.clear();
+    points.reserve(nodes.size() * virtualNodes);
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        for (size_t v = 0; v < virtualNodes; ++v) {
+            points.push_back({hashKey(nodes[n] + "#" + std::to_string(v)), n});
+        }
+    }
+    std::sort(points.begin(), points.end(), [this](const Point& a, const Point& b) {
+        // Ties are broken by name so the order does not depend on insertion order
+        return a.hash != b.hash ? a.hash < b.hash : nodes[a.node] < nodes[b.node];
+    });
+}
+
+const std::string& HashRing::ownerOf(std::string_view key) const {
+    if (points.empty()) {
+        return NO_NODE;
+    }
+    uint64_t hash = hashKey(key);
+    auto it = std::lower_bound(points.begin(), points.end(), hash,
+                               [](const Point& point, uint64_t value) { return point.hash < value; });
+    if (it == points.end()) {
+        it = points.begin();
+    }
+    return nodes[it->node];
+}
+
+const std::vector<std::string>& HashRing::getNodes() const {
+    return nodes;
+}
+
+size_t HashRing::size() const {
+    return nodes.size();
+}
+
+bool HashRing::empty() const {
+    return nodes.empty();
+}
@@ -0,0 +1,265 @@
+#include "../include/host_filter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace {
+
+const uint32_t ROOT = 0;
+const uint32_t NONE = UINT32_MAX;
+
+// Multi-label public suffixes: the common second-level registries and the
+// hosting platforms that hand out subdomains to unrelated owners. Every
+// single-label TLD is a public suffix implicitly.
+const std::unordered_set<std::string> PUBLIC_SUFFIXES = {
+    "co.uk", "org.uk", "ac.uk", "gov.uk", "ltd.uk", "plc.uk", "me.uk", "net.uk", "sch.uk", "nhs.uk",
+    "com.au", "net.au", "org.au", "edu.au", "gov.au", "id.au", "asn.au",
+    "co.nz", "org.nz", "net.nz", "ac.nz", "govt.nz", "geek.nz",
+    "co.jp", "ne.jp", "or.jp", "ac.jp", "go.jp", "ad.jp", "ed.jp", "gr.jp", "lg.jp",
+    "co.kr", "or.kr", "ne.kr", "ac.kr", "go.kr", "re.kr",
+    "com.cn", "net.cn", "org.cn", "gov.cn", "edu.cn", "ac.cn",
+    "com.hk", "org.hk", "net.hk", "edu.hk", "gov.hk",
+    "com.tw", "org.tw", "net.tw", "edu.tw", "gov.tw",
+    "com.sg", "org.sg", "net.sg", "edu.sg", "gov.sg",
+    "co.in", "net.in", "org.in", "firm.in", "gen.in", "ind.in", "ac.in", "edu.in", "gov.in", "res.in",
+    "com.br", "net.br", "org.br", "gov.br", "edu.br", "art.br", "blog.br",
+    "com.ar", "net.ar", "org.ar", "gob.ar", "edu.ar",
+    "com.mx", "net.mx", "org.mx", "gob.mx", "edu.mx",
+    "co.za", "org.za", "net.za", "gov.za", "ac.za", "web.za",
+    "com.tr", "net.tr", "org.tr", "gov.tr", "edu.tr", "k12.tr",
+    "com.ru", "net.ru", "org.ru", "msk.ru", "spb.ru",
+    "com.ua", "net.ua", "org.ua", "kiev.ua", "gov.ua", "edu.ua",
+    "co.il", "org.il", "net.il", "ac.il", "gov.il", "muni.il",
+    "com.pl", "net.pl", "org.pl", "gov.pl", "edu.pl",
+    "co.id", "or.id", "ac.id", "go.id", "web.id", "my.id",
+    "com.my", "net.my", "org.my", "gov.my", "edu.my",
+    "com.ph", "net.ph", "org.ph", "gov.ph", "edu.ph",
+    "com.vn", "net.vn", "org.vn", "gov.vn", "edu.vn",
+    "co.th", "in.th", "or.th", "ac.th", "go.th",
+    "com.eg", "com.sa", "com.pk", "com.ng", "co.ke", "com.co", "com.pe", "com.ve", "com.uy",
+    "gv.at", "co.at", "or.at", "ac.at",
+    "github.io", "gitlab.io", "githubusercontent.com", "blogspot.com", "wordpress.com",
+    "herokuapp.com", "appspot.com", "firebaseapp.com", "web.app", "pages.dev", "workers.dev",
+    "netlify.app", "vercel.app", "azurewebsites.net", "cloudapp.net", "cloudfront.net",
+    "s3.amazonaws.com", "elasticbeanstalk.com", "fly.dev", "onrender.com", "glitch.me",
+    "readthedocs.io", "substack.com", "tumblr.com", "neocities.org", "sourceforge.io"
+};
+
+char lower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return lower(x) == lower(y); });
+}
+
+// Strip the port and any trailing dot: "Example.COM.:8080" -> "Example.COM"
+std::string_view normalizeHost(std::string_view host) {
+    if (!host.empty() && host[0] == '[') {
+        // IPv6 literal
+        size_t close = host.find(']');
+        return close == std::string_view::npos ? host : host.substr(0, close + 1);
+    }
+    size_t colon = host.rfind(':');
+    if (colon != std::string_view::npos) {
+        host = host.substr(0, colon);
+    }
+    while (!host.empty() && host.back() == '.') {
+        host.remove_suffix(1);
+    }
+    return host;
+}
+
+} // namespace
+
+HostFilter::HostFilter()
+    : entries(0) {
+    nodes.emplace_back();
+}
+
+HostFilter::HostFilter(const std::vector<std::string>& domains)
+    : HostFilter() {
+    for (const auto& domain : domains) {
+        add(domain);
+    }
+}
+
+void HostFilter::add(const std::string& domain) {
+    std::string_view name = domain;
+    while (!name.empty() && std::isspace(static_cast<unsigned char>(name.front()))) {
+        name.remove_prefix(1);
+    }
+    while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back()))) {
+        name.remove_suffix(1);
+    }
+
+    bool wildcard = name.compare(0, 2, "*.") == 0;
+    if (wildcard) {
+        name.remove_prefix(2);
+    }
+    while (!name.empty() && name.front() == '.') {
+        name.remove_prefix(1);
+    }
+    name = normalizeHost(name);
+    if (name.empty()) {
+        return;
+    }
+
+    uint32_t node = ROOT;
+    size_t end = name.size();
+    while (true) {
+        size_t dot = name.rfind('.', end - 1);
+        size_t start = dot == std::string_view::npos ? 0 : dot + 1;
+        if (end > start) {
+            node = addChild(node, name.substr(start, end - start));
+        }
+        if (dot == std::string_view::npos || dot == 0) {
+            break;
+        }
+        end = dot;
+    }
+
+    if (wildcard || !isPublicSuffix(name)) {
+        nodes[node].subdomains = true;
+    } else {
+        nodes[node].exact = true;
+    }
+    entries++;
+}
+
+bool HostFilter::matches(std::string_view host) const {
+    if (entries == 0) {
+        return true;
+    }
+
+    host = normalizeHost(host);
+    if (host.empty()) {
+        return false;
+    }
+
+    uint32_t node = ROOT;
+    size_t end = host.size();
+    while (true) {
+        size_t dot = host.rfind('.', end - 1);
+        size_t start = dot == std::string_view::npos ? 0 : dot + 1;
+        node = findChild(node, host.substr(start, end - start));
+        if (node == NONE) {
+            return false;
+        }
+        if (nodes[node].subdomains) {
+            return true;
+        }
+        if (dot == std::string_view::npos || dot == 0) {
+            break;
+        }
+        end = dot;
+    }
+    return nodes[node].exact;
+}
+
+bool HostFilter::matchesUrl(std::string_view url) const {
+    return entries == 0 || matches(hostOf(url));
+}
+
+bool HostFilter::empty() const {
+    return entries == 0;
+}
+
+size_t HostFilter::size() const {
+    return entries;
+}
+
+bool HostFilter::isPublicSuffix(std::string_view domain) {
+    if (domain.find('.') == std::string_view::npos) {
+        return !domain.empty();
+    }
+    std::string lowered(domain);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), lower);
+    return PUBLIC_SUFFIXES.count(lowered) > 0;
+}
+
+std::string_view HostFilter::registrableDomain(std::string_view host) {
+    host = normalizeHost(host);
+
+    // Longest public suffix first: try "a.b.co.uk", then "b.co.uk", ...
+    size_t labelStart = 0;
+    size_t previousStart = std::string_view::npos;
+    while (labelStart < host.size()) {
+        if (isPublicSuffix(host.substr(labelStart))) {
+            return previousStart == std::string_view::npos ? host : host.substr(previousStart);
+        }
+        size_t dot = host.find('.', labelStart);
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        previousStart = labelStart;
+        labelStart = dot + 1;
+    }
+    return host;
+}
+
+std::string_view HostFilter::hostOf(std::string_view url) {
+    size_t schemeEnd = url.find("://");
+    size_t start = schemeEnd == std::string_view::npos ? 0 : schemeEnd + 3;
+    size_t end = url.find_first_of("/?#", start);
+    std::string_view authority = url.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+
+    // Drop any user info
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+    return normalizeHost(authority);
+}
+
+uint64_t HostFilter::edgeKey(uint32_t parent, std::string_view label) {
+    // FNV-1a over the lower-cased label, then mixed with the parent index
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : label) {
+        hash = (hash ^ static_cast<unsigned char>(lower(c))) * 0x100000001b3ULL;
+    }
+    hash ^= (static_cast<uint64_t>(parent) + 1) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+uint32_t HostFilter::findChild(uint32_t parent, std::string_view label) const {
+    uint64_t key = edgeKey(parent, label);
+    while (true) {
+        auto it = edges.find(key);
+        if (it == edges.end()) {
+            return NONE;
+        }
+        const Node& child = nodes[it->second];
+        if (child.parent == parent && equalsIgnoreCase(child.label, label)) {
+            return it->second;
+        }
+        key++;
+    }
+}
+
+uint32_t HostFilter::addChild(uint32_t parent, std::string_view label) {
+    uint64_t key = edgeKey(parent, label);
+    while (true) {
+        auto it = edges.find(key);
+        if (it == edges.end()) {
+            break;
+        }
+        const Node& child = nodes[it->second];
+        if (child.parent == parent && equalsIgnoreCase(child.label, label)) {
+            return it->second;
+        }
+        key++;
+    }
+
+    Node node;
+    node.label.assign(label.begin(), label.end());
+    std::transform(node.label.begin(), node.label.end(), node.label.begin(), lower);
+    node.parent = parent;
+
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(std::move(node));
+    edges.emplace(key, index);
+    return index;
+}
@@ -0,0 +1,276 @@
+#include "../include/html_link_scanner.hpp"
+#include <cstring>
+#include <cctype>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+bool equalsIgnoreCase(const char* a, size_t aLen, const char* b) {
+    size_t bLen = std::strlen(b);
+    if (aLen != bLen) {
+        return false;
+    }
+    for (size_t i = 0; i < aLen; ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasPrefixIgnoreCase(const std::string& value, const char* prefix) {
+    size_t len = std::strlen(prefix);
+    return value.size() >= len && equalsIgnoreCase(value.data(), len, prefix);
+}
+
+// References that can never be crawled
+bool isIgnorableRef(const std::string& ref) {
+    return ref[0] == '#' ||
+           hasPrefixIgnoreCase(ref, "javascript:") ||
+           hasPrefixIgnoreCase(ref, "mailto:") ||
+           hasPrefixIgnoreCase(ref, "tel:") ||
+           hasPrefixIgnoreCase(ref, "data:");
+}
+
+} // namespace
+
+HtmlLinkScanner::HtmlLinkScanner(RefCallback callback, bool collectAnchorText)
+    : callback(std::move(callback))
+    , collectAnchorText(collectAnchorText)
+    , anchorOpen(false)
+    , inTag(false)
+    , quote(0)
+    , overflow(false)
+    , refCount(0) {
+    tagBuffer.reserve(256);
+}
+
+void HtmlLinkScanner::feed(const char* data, size_t size) {
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end) {
+        if (!inTag) {
+            // Skip text content in bulk
+            const char* lt = static_cast<const char*>(std::memchr(p, '<', end - p));
+            if (anchorOpen) {
+                appendAnchorText(p, (lt ? lt : end) - p);
+            }
+            if (!lt) {
+                return;
+            }
+            p = lt + 1;
+            inTag = true;
+            quote = 0;
+            overflow = false;
+            tagBuffer.clear();
+            continue;
+        }
+
+        char c = *p++;
+
+        // Comments end only at "-->", regardless of quotes or '>' inside them
+        bool inComment = tagBuffer.size() >= 3 && tagBuffer.compare(0, 3, "!--") == 0;
+
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (!inComment && (c == '"' || c == '\'') && !tagBuffer.empty() &&
+                   std::isalpha(static_cast<unsigned char>(tagBuffer[0]))) {
+            quote = c;
+        } else if (c == '>') {
+            bool commentDone = !inComment ||
+                (tagBuffer.size() >= 5 && tagBuffer.compare(tagBuffer.size() - 2, 2, "--") == 0);
+            if (commentDone) {
+                if (!overflow && !inComment && !tagBuffer.empty()) {
+                    processTag();
+                }
+                inTag = false;
+                continue;
+            }
+        }
+
+        if (!overflow && tagBuffer.size() < MAX_TAG_LENGTH) {
+            tagBuffer.push_back(c);
+        } else if (inComment) {
+            // Oversized comment: keep "!--" plus the last two characters so
+            // the closing "--" can still be recognised
+            char last = tagBuffer.back();
+            tagBuffer.resize(5);
+            tagBuffer[3] = last;
+            tagBuffer[4] = c;
+            overflow = true;
+        } else {
+            overflow = true;
+        }
+    }
+}
+
+void HtmlLinkScanner::finish() {
+    if (anchorOpen) {
+        reportAnchor();
+    }
+    inTag = false;
+    quote = 0;
+    overflow = false;
+    tagBuffer.clear();
+}
+
+void HtmlLinkScanner::reset() {
+    anchorOpen = false;
+    finish();
+    refCount = 0;
+}
+
+size_t HtmlLinkScanner::getRefCount() const {
+    return refCount;
+}
+
+void HtmlLinkScanner::processTag() {
+    if (anchorOpen && tagBuffer[0] == '/') {
+        if (tagBuffer.size() >= 2 && std::tolower(static_cast<unsigned char>(tagBuffer[1])) == 'a' &&
+            (tagBuffer.size() == 2 || isSpace(tagBuffer[2]))) {
+            reportAnchor();
+        }
+        return;
+    }
+    
+    // Tag name runs up to the first whitespace or '/'
+    size_t nameEnd = 0;
+    while (nameEnd < tagBuffer.size() && !isSpace(tagBuffer[nameEnd]) && tagBuffer[nameEnd] != '/') {
+        nameEnd++;
+    }
+
+    RefKind kind;
+    const char* attribute;
+    if (equalsIgnoreCase(tagBuffer.data(), nameEnd, "a")) {
+        kind = RefKind::LINK;
+        attribute = "href";
+    } else if (equalsIgnoreCase(tagBuffer.data(), nameEnd, "img")) {
+        kind = RefKind::IMAGE;
+        attribute = "src";
+    } else {
+        return;
+    }
+
+    // A link left open ends where the next one starts
+    if (kind == RefKind::LINK && anchorOpen) {
+        reportAnchor();
+    }
+
+    // Images inside a link lend it their alt text
+    if (kind == RefKind::IMAGE && anchorOpen && extractAttribute("alt", attrValue)) {
+        appendAnchorText(" ", 1);
+        appendAnchorText(attrValue.data(), attrValue.size());
+    }
+
+    if (extractAttribute(attribute, attrValue) && !isIgnorableRef(attrValue)) {
+        if (kind == RefKind::LINK && collectAnchorText) {
+            anchorOpen = true;
+            anchorRef = attrValue;
+            anchorText.clear();
+            return;
+        }
+        static const std::string noText;
+        refCount++;
+        callback(attrValue, kind, noText);
+    }
+}
+
+void HtmlLinkScanner::appendAnchorText(const char* data, size_t size) {
+    // Whitespace runs collapse to one space
+    for (size_t i = 0; i < size && anchorText.size() < MAX_ANCHOR_TEXT_LENGTH; ++i) {
+        if (!isSpace(data[i])) {
+            anchorText.push_back(data[i]);
+        } else if (!anchorText.empty() && anchorText.back() != ' ') {
+            anchorText.push_back(' ');
+        }
+    }
+}
+
+void HtmlLinkScanner::reportAnchor() {
+    anchorOpen = false;
+    if (!anchorText.empty() && anchorText.back() == ' ') {
+        anchorText.pop_back();
+    }
+    refCount++;
+    callback(anchorRef, RefKind::LINK, anchorText);
+}
+
+bool HtmlLinkScanner::extractAttribute(const char* name, std::string& value) const {
+    const char* p = tagBuffer.data();
+    const char* end = p + tagBuffer.size();
+
+    // Skip the tag name
+    while (p < end && !isSpace(*p)) {
+        p++;
+    }
+
+    while (p < end) {
+        while (p < end && (isSpace(*p) || *p == '/')) {
+            p++;
+        }
+
+        const char* attrStart = p;
+        while (p < end && !isSpace(*p) && *p != '=') {
+            p++;
+        }
+        size_t attrLen = p - attrStart;
+
+        while (p < end && isSpace(*p)) {
+            p++;
+        }
+
+        const char* valueStart = p;
+        const char* valueEnd = p;
+        if (p < end && *p == '=') {
+            p++;
+            while (p < end && isSpace(*p)) {
+                p++;
+            }
+            if (p < end && (*p == '"' || *p == '\'')) {
+                char q = *p++;
+                valueStart = p;
+                while (p < end && *p != q) {
+                    p++;
+                }
+                valueEnd = p;
+                if (p < end) {
+                    p++;
+                }
+            } else {
+                valueStart = p;
+                while (p < end && !isSpace(*p)) {
+                    p++;
+                }
+                valueEnd = p;
+            }
+        }
+
+        if (attrLen > 0 && equalsIgnoreCase(attrStart, attrLen, name)) {
+            // Trim surrounding whitespace from the value
+            while (valueStart < valueEnd && isSpace(*valueStart)) {
+                valueStart++;
+            }
+            while (valueEnd > valueStart && isSpace(*(valueEnd - 1))) {
+                valueEnd--;
+            }
+            if (valueStart == valueEnd) {
+                return false;
+            }
+            value.assign(valueStart, valueEnd);
+            return true;
+        }
+
+        if (attrLen == 0 && valueStart == valueEnd) {
+            // Nothing consumed; avoid spinning on stray characters
+            p++;
+        }
+    }
+
+    return false;
+}
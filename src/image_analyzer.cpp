@@ -62,6 +62,7 @@ ImageAnalyzer::~ImageAnalyzer() {
 }
 
 ImageAnalyzer::ImageFeatures ImageAnalyzer::analyzeImage(const std::string& imagePath) {
+    (void)imagePath;
     ImageFeatures features;
     
     // Stub implementation
@@ -77,6 +78,12 @@ ImageAnalyzer::ImageFeatures ImageAnalyzer::analyzeImage(const std::string& imag
 }
 
 ImageAnalyzer::ImageFeatures ImageAnalyzer::analyzeImageData(const std::vector<uint8_t>& imageData) {
+    return analyzeImageData(imageData.data(), imageData.size());
+}
+
+ImageAnalyzer::ImageFeatures ImageAnalyzer::analyzeImageData(const uint8_t* data, size_t size) {
+    (void)data;
+    (void)size;
     // Use the same stub implementation as analyzeImage
     return analyzeImage("");
 }
@@ -109,59 +116,71 @@ std::string ImageAnalyzer::generateDescription(const ImageFeatures& features) {
 }
 
 bool ImageAnalyzer::isNSFW(const std::string& imagePath) {
+    (void)imagePath;
     // Stub implementation
     return false;
 }
 
 std::vector<std::string> ImageAnalyzer::detectObjects(const std::string& imagePath) {
+    (void)imagePath;
     // Stub implementation
     return {"object1", "object2"};
 }
 
 std::string ImageAnalyzer::extractText(const std::string& imagePath) {
+    (void)imagePath;
     // Stub implementation
     return "Stub OCR text from file";
 }
 
 std::string ImageAnalyzer::extractTextFromData(const std::vector<uint8_t>& imageData) {
+    (void)imageData;
     // Stub implementation
     return "Stub OCR text from data";
 }
 
 void ImageAnalyzer::loadModels(const std::string& modelDir) {
+    (void)modelDir;
     // Stub implementation
 }
 
 void ImageAnalyzer::saveModels(const std::string& modelDir) {
+    (void)modelDir;
     // Stub implementation
 }
 
 cv::Mat ImageAnalyzer::preprocessImage(const std::string& imagePath) {
+    (void)imagePath;
     // Stub implementation
     return cv::Mat();
 }
 
 cv::Mat ImageAnalyzer::preprocessImageData(const std::vector<uint8_t>& imageData) {
+    (void)imageData;
     // Stub implementation
     return cv::Mat();
 }
 
 std::vector<std::string> ImageAnalyzer::classifyImage(const cv::Mat& image) {
+    (void)image;
     // Stub implementation
     return {"category1", "category2"};
 }
 
 std::vector<std::pair<std::string, float>> ImageAnalyzer::detectObjects(const cv::Mat& image) {
+    (void)image;
     // Stub implementation
     return {{"object1", 0.9f}, {"object2", 0.8f}};
 }
 
 bool ImageAnalyzer::detectNSFW(const cv::Mat& image) {
+    (void)image;
     // Stub implementation
     return false;
 }
 
 std::string ImageAnalyzer::generateCaption(const cv::Mat& image, const std::vector<std::string>& objects) {
+    (void)image;
     // Stub implementation
     return "An image containing " + (objects.empty() ? "various objects" : objects[0]);
 }
@@ -185,16 +204,20 @@ std::vector<float> ImageAnalyzer::softmax(const std::vector<float>& tensor) {
 }
 
 std::vector<std::string> ImageAnalyzer::loadLabels(const std::string& labelFile) {
+    (void)labelFile;
     // Stub implementation
     return {"label1", "label2", "label3"};
 }
 
 cv::Mat ImageAnalyzer::resizeImage(const cv::Mat& image, int targetSize) {
+    (void)image;
+    (void)targetSize;
     // Stub implementation
     return cv::Mat();
 }
 
 cv::Mat ImageAnalyzer::normalizeImage(const cv::Mat& image) {
+    (void)image;
     // Stub implementation
     return cv::Mat();
 }
@@ -0,0 +1,185 @@
+#include "../include/inference_backend.hpp"
+#ifdef HAVE_ONNXRUNTIME
+#include "../include/onnx_backend.hpp"
+#endif
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace {
+
+// Partial sums of a dot product, which the compiler can keep in vector
+// registers without reordering any one addition
+const size_t LANES = 8;
+
+float dot(const float* a, const float* b, size_t size) {
+    float sums[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= size; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            sums[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+    float sum = 0.0f;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        sum += sums[lane];
+    }
+    for (; i < size; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+std::unique_ptr<InferenceBackend> InferenceBackend::create(const std::string& name, const std::string& modelPath,
+                                                           std::string& error) {
+    error.clear();
+
+    if (name == "linear") {
+        auto linear = std::make_unique<LinearBackend>(modelPath);
+        if (!linear->isLoaded()) {
+            error = "Failed to load linear model " + modelPath + ": " + linear->getError();
+            return nullptr;
+        }
+        return linear;
+    }
+
+    if (name == "onnx") {
+#ifdef HAVE_ONNXRUNTIME
+        auto onnx = std::make_unique<OnnxBackend>(modelPath);
+        if (!onnx->isLoaded()) {
+            error = "Failed to load ONNX model " + modelPath + ": " + onnx->getError();
+            return nullptr;
+        }
+        return onnx;
+#else
+        error = "Not built with ONNX Runtime (WITH_ONNXRUNTIME), cannot load " + modelPath;
+        return nullptr;
+#endif
+    }
+
+    error = "Unknown inference backend '" + name + "'";
+    return nullptr;
+}
+
+LinearBackend::LinearBackend(const std::string& modelPath)
+    : inputSize(0) {
+    if (!load(modelPath)) {
+        labels.clear();
+        weights.clear();
+        biases.clear();
+    }
+}
+
+LinearBackend::LinearBackend(size_t inputSize, std::vector<std::string> labels, std::vector<float> weights,
+                             std::vector<float> biases)
+    : inputSize(inputSize)
+    , labels(std::move(labels))
+    , weights(std::move(weights))
+    , biases(std::move(biases)) {
+    if (this->weights.size() != this->labels.size() * inputSize || this->biases.size() != this->labels.size()) {
+        error = "weights do not match the labels and input size";
+        this->inputSize = 0;
+        this->labels.clear();
+    }
+}
+
+bool LinearBackend::load(const std::string& modelPath) {
+    std::ifstream file(modelPath);
+    if (!file.is_open()) {
+        error = "cannot open file";
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        if (inputSize == 0) {
+            long long size = 0;
+            if (!(fields >> size) || size <= 0) {
+                error = "line " + std::to_string(lineNumber) + ": expected the input size";
+                return false;
+            }
+            inputSize = static_cast<size_t>(size);
+            continue;
+        }
+
+        std::string label;
+        float bias;
+        if (!(fields >> label >> bias)) {
+            error = "line " + std::to_string(lineNumber) + ": expected a label and its bias";
+            return false;
+        }
+        size_t rowStart = weights.size();
+        float weight;
+        while (fields >> weight) {
+            weights.push_back(weight);
+        }
+        if (weights.size() - rowStart != inputSize) {
+            error = "line " + std::to_string(lineNumber) + ": " + std::to_string(weights.size() - rowStart) +
+                    " weights for " + std::to_string(inputSize) + " inputs";
+            return false;
+        }
+        labels.push_back(std::move(label));
+        biases.push_back(bias);
+    }
+
+    if (labels.empty()) {
+        error = "no labels";
+        return false;
+    }
+    return true;
+}
+
+bool LinearBackend::isLoaded() const {
+    return !labels.empty();
+}
+
+const std::string& LinearBackend::getError() const {
+    return error;
+}
+
+size_t LinearBackend::getInputSize() const {
+    return inputSize;
+}
+
+const std::vector<std::string>& LinearBackend::getLabels() const {
+    return labels;
+}
+
+bool LinearBackend::run(const float* inputs, size_t rows, float* outputs, std::string& error) const {
+    if (labels.empty()) {
+        error = "no model loaded";
+        return false;
+    }
+
+    const size_t labelCount = labels.size();
+    for (size_t label = 0; label < labelCount; ++label) {
+        const float* w = &weights[label * inputSize];
+
+        // Every item of the batch is scored while the label's weights are in cache
+        for (size_t row = 0; row < rows; ++row) {
+            outputs[row * labelCount + label] = dot(w, inputs + row * inputSize, inputSize);
+        }
+    }
+
+    for (size_t row = 0; row < rows; ++row) {
+        float* scores = outputs + row * labelCount;
+        for (size_t label = 0; label < labelCount; ++label) {
+            scores[label] = 1.0f / (1.0f + std::exp(-(scores[label] + biases[label])));
+        }
+    }
+    return true;
+}
+
+const char* LinearBackend::getName() const {
+    return "linear";
+}
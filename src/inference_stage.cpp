@@ -0,0 +1,284 @@
+#include "../include/inference_stage.hpp"
+#include "../include/text_normalizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long microsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+void scaleToUnitLength(float* features, size_t size) {
+    double sum = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += static_cast<double>(features[i]) * features[i];
+    }
+    if (sum > 0.0) {
+        float scale = static_cast<float>(1.0 / std::sqrt(sum));
+        for (size_t i = 0; i < size; ++i) {
+            features[i] *= scale;
+        }
+    }
+}
+
+// Index of the image format among the first features
+size_t imageFormat(std::string_view data) {
+    auto startsWith = [&data](const char* magic, size_t length, size_t at = 0) {
+        return data.size() >= at + length && std::memcmp(data.data() + at, magic, length) == 0;
+    };
+    if (startsWith("\xFF\xD8\xFF", 3)) {
+        return 0;
+    }
+    if (startsWith("\x89PNG", 4)) {
+        return 1;
+    }
+    if (startsWith("GIF8", 4)) {
+        return 2;
+    }
+    if (startsWith("RIFF", 4) && startsWith("WEBP", 4, 8)) {
+        return 3;
+    }
+    if (startsWith("BM", 2)) {
+        return 4;
+    }
+    if (data.substr(0, 512).find("<svg") != std::string_view::npos) {
+        return 5;
+    }
+    return 6;
+}
+
+} // namespace
+
+InferenceStage::InferenceStage(const Options& options, std::unique_ptr<InferenceBackend> pageModel,
+                               std::unique_ptr<InferenceBackend> imageModel)
+    : options(options)
+    , queued(0)
+    , running(0)
+    , stopping(false) {
+    this->options.batchSize = std::max<size_t>(1, options.batchSize);
+    this->options.queueLimit = std::max<size_t>(1, options.queueLimit);
+    models[static_cast<int>(Kind::PAGE)] = std::move(pageModel);
+    models[static_cast<int>(Kind::IMAGE)] = std::move(imageModel);
+
+    size_t threads = std::max<size_t>(1, options.threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&InferenceStage::workerLoop, this);
+    }
+}
+
+InferenceStage::~InferenceStage() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool InferenceStage::accepts(Kind kind) const {
+    return models[static_cast<int>(kind)] != nullptr;
+}
+
+void InferenceStage::submit(Kind kind, std::string body, Completion done) {
+    std::unique_lock<std::mutex> lock(mutex);
+    spaceCondition.wait(lock, [this] { return queued < options.queueLimit; });
+
+    auto& queue = queues[static_cast<int>(kind)];
+    queue.push_back(Item{std::move(body), std::move(done), Clock::now()});
+    queued++;
+
+    // The first item needs a worker to time its batch, a full batch one to run it
+    bool wake = queue.size() == 1 || queue.size() == options.batchSize;
+    lock.unlock();
+    if (wake) {
+        workCondition.notify_one();
+    }
+}
+
+void InferenceStage::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [this] { return queued == 0 && running == 0; });
+}
+
+bool InferenceStage::isIdle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued == 0 && running == 0;
+}
+
+InferenceStage::Stats InferenceStage::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+int InferenceStage::nextBatchLocked(Clock::time_point now, Clock::time_point& wakeAt) const {
+    // Of the batches ready to run, the one whose oldest item has waited longest
+    int next = -1;
+    for (int kind = 0; kind < 2; ++kind) {
+        const auto& queue = queues[kind];
+        if (queue.empty()) {
+            continue;
+        }
+        Clock::time_point due = queue.front().submitted + options.maxLatency;
+        if (queue.size() >= options.batchSize || stopping || due <= now) {
+            if (next < 0 || queue.front().submitted < queues[next].front().submitted) {
+                next = kind;
+            }
+        } else {
+            wakeAt = std::min(wakeAt, due);
+        }
+    }
+    return next;
+}
+
+void InferenceStage::workerLoop() {
+    std::vector<Item> batch;
+    std::vector<float> inputs;
+    std::vector<float> outputs;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Clock::time_point now = Clock::now();
+        Clock::time_point wakeAt = Clock::time_point::max();
+        int kind = nextBatchLocked(now, wakeAt);
+        if (kind < 0) {
+            if (stopping && queued == 0) {
+                break;
+            }
+            if (wakeAt == Clock::time_point::max()) {
+                workCondition.wait(lock);
+            } else {
+                workCondition.wait_until(lock, wakeAt);
+            }
+            continue;
+        }
+
+        auto& queue = queues[kind];
+        size_t count = std::min(options.batchSize, queue.size());
+        batch.clear();
+        for (size_t i = 0; i < count; ++i) {
+            stats.queueMicros += microsBetween(queue.front().submitted, now);
+            batch.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        queued -= count;
+        running += count;
+        spaceCondition.notify_all();
+
+        // Items left over from a full batch may already be due
+        if (!queue.empty()) {
+            workCondition.notify_one();
+        }
+
+        lock.unlock();
+        bool scored = true;
+        Clock::time_point started = Clock::now();
+        runBatch(static_cast<Kind>(kind), batch, inputs, outputs, scored);
+        long long runMicros = microsBetween(started, Clock::now());
+        lock.lock();
+
+        running -= count;
+        stats.items += static_cast<long long>(count);
+        stats.batches++;
+        stats.failedBatches += scored ? 0 : 1;
+        stats.runMicros += runMicros;
+        if (queued == 0 && running == 0) {
+            idleCondition.notify_all();
+        }
+    }
+}
+
+void InferenceStage::runBatch(Kind kind, std::vector<Item>& batch, std::vector<float>& inputs,
+                              std::vector<float>& outputs, bool& scored) {
+    const InferenceBackend& model = *models[static_cast<int>(kind)];
+    const size_t inputSize = model.getInputSize();
+    const size_t labelCount = model.getLabels().size();
+
+    inputs.assign(batch.size() * inputSize, 0.0f);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        float* row = &inputs[i * inputSize];
+        if (kind == Kind::PAGE) {
+            pageFeatures(batch[i].body, row, inputSize);
+        } else {
+            imageFeatures(batch[i].body, row, inputSize);
+        }
+    }
+
+    Result result;
+    outputs.resize(batch.size() * labelCount);
+    scored = model.run(inputs.data(), batch.size(), outputs.data(), result.error);
+    result.scored = scored;
+    if (scored) {
+        result.labels = &model.getLabels();
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (scored) {
+            result.scores.assign(outputs.begin() + static_cast<std::ptrdiff_t>(i * labelCount),
+                                 outputs.begin() + static_cast<std::ptrdiff_t>((i + 1) * labelCount));
+        }
+        batch[i].done(std::move(batch[i].body), result);
+    }
+    batch.clear();
+}
+
+void InferenceStage::pageFeatures(std::string_view body, float* features, size_t size) {
+    std::fill(features, features + size, 0.0f);
+    if (size == 0) {
+        return;
+    }
+
+    thread_local std::string normalized;
+    TextNormalizer::normalize(body, normalized);
+
+    // Each word counts towards the input its FNV-1a hash selects
+    uint32_t hash = 2166136261u;
+    bool inWord = false;
+    for (char c : normalized) {
+        if (c == ' ') {
+            if (inWord) {
+                features[hash % size] += 1.0f;
+            }
+            hash = 2166136261u;
+            inWord = false;
+            continue;
+        }
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        inWord = true;
+    }
+    if (inWord) {
+        features[hash % size] += 1.0f;
+    }
+
+    // Damp repeated words, so a few do not outweigh the rest of the page
+    for (size_t i = 0; i < size; ++i) {
+        if (features[i] > 0.0f) {
+            features[i] = std::log1p(features[i]);
+        }
+    }
+    scaleToUnitLength(features, size);
+}
+
+void InferenceStage::imageFeatures(std::string_view data, float* features, size_t size) {
+    float all[IMAGE_FEATURES] = {};
+    all[imageFormat(data)] = 1.0f;
+    all[7] = static_cast<float>(std::log2(static_cast<double>(data.size()) + 1.0) / 32.0);
+
+    size_t counts[16] = {};
+    for (char c : data) {
+        counts[static_cast<unsigned char>(c) >> 4]++;
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        all[8 + i] = data.empty() ? 0.0f : static_cast<float>(counts[i]) / static_cast<float>(data.size());
+    }
+
+    scaleToUnitLength(all, IMAGE_FEATURES);
+    std::fill(features, features + size, 0.0f);
+    std::copy(all, all + std::min(size, IMAGE_FEATURES), features);
+}
@@ -0,0 +1,82 @@
+#include "../include/keyword_matcher.hpp"
+#include "../include/text_normalizer.hpp"
+#include <fstream>
+#include <cstdlib>
+
+void KeywordMatcher::add(std::string_view term, float weight) {
+    std::string text = TextNormalizer::normalize(term);
+
+    // Separators around a term would otherwise demand them in the page
+    size_t start = text.find_first_not_of(' ');
+    if (start == std::string::npos) {
+        return;
+    }
+    text = text.substr(start, text.find_last_not_of(' ') + 1 - start);
+
+    automaton.add(text, static_cast<uint32_t>(terms.size()));
+    terms.push_back(Term{std::move(text), weight});
+}
+
+bool KeywordMatcher::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        float weight = 1.0f;
+        size_t tab = line.rfind('\t');
+        if (tab != std::string::npos) {
+            weight = static_cast<float>(std::atof(line.c_str() + tab + 1));
+            line.resize(tab);
+        }
+        add(line, weight);
+    }
+    return true;
+}
+
+void KeywordMatcher::build() {
+    automaton.build();
+}
+
+void KeywordMatcher::match(std::string_view body, Matches& matches) const {
+    matches.counts.assign(terms.size(), 0);
+    matches.total = 0;
+    matches.score = 0.0;
+    if (terms.empty()) {
+        return;
+    }
+
+    // Reused across pages, so scanning does not allocate once it has grown
+    thread_local std::string normalized;
+    TextNormalizer::normalize(body, normalized);
+
+    automaton.scan(normalized, [this, &matches](uint32_t id, size_t) {
+        matches.counts[id]++;
+        matches.total++;
+        matches.score += terms[id].weight;
+        return true;
+    });
+}
+
+double KeywordMatcher::score(std::string_view body) const {
+    Matches matches;
+    match(body, matches);
+    return matches.score;
+}
+
+const std::vector<KeywordMatcher::Term>& KeywordMatcher::getTerms() const {
+    return terms;
+}
+
+bool KeywordMatcher::empty() const {
+    return terms.empty();
+}
@@ -0,0 +1,515 @@
+#include "../include/language_identifier.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Trigram profiles, most frequent first, of each language told apart by
+// trigrams. A space marks the start or end of a word.
+struct Profile {
+    const char* language;
+    const char* trigrams;       // Separated by '|'
+};
+
+const Profile PROFILES[] = {
+    {"en",
+        " th|the|he | an|nd |and|er |on | to|ed |ll | in| of|ion| co| we|all|ing|ld |of | or| wi|her|in |"
+        "ng |tio|to |ver| be| on| se|as |at |ave|or |our|th |ur | al| ha| ne| ri| sh| wh| yo|al |ery|es |"
+        "hat|ith|ne |re |tha|wit|you| a | li| re| sl| so| st| wa|an |ati|ead|eas|ers|est|for|igh|one|oth|"
+        "oul|rea|rig|rs |sti|ter|ty |uld|ve |we | ar| as| di| en| ev| fo| he| mo| ou| po| pr| sp| ta| wo|"
+        "ad |ake|be |con|en |ent|erv|et |eve|ght|hel|ind|is |lav|le |new|nt |old|ons|orn|ort|ou |pro|ree|"
+        "rit|ry |ser|sla|st |sta|tat|ts |ues|us |ut | ba| br| bu| ca| de| fa| fi| fr| go| ho| la| no| op|"
+        " ot| pl| qu| su| us|act"
+    },
+    {"de",
+        "en |er | un|nd |ie |der|die|ten|und| de| di|sch| ge| si|den|gen|in | an|ein|ste|te | ha|ch |ere|"
+        "nde|rei|ren|sie|ter| da| in| wi|ben|eit|hre|ich|it |ver| fr| we|cht|ei |ens|lei|nst|ser|ung|uns|"
+        "wir| al| be| ei| od| re| so| ve|abe|alt|an |das|end|hat|ist|nte|ode|sta|tte| am| au| ih| le| mi|"
+        " na| sc| zu|am |and|as |ass|auf|che|ech|es |fen|ft |gab|geb|hal|her|ien|ige|ind|ine|ir |lle|men|"
+        "ne |nen|ng |nge|re |sse|wei| br| er| he| me| ne| sk| st| wa|ach|all|at |att|ave|ber|cke|des|ede|"
+        "eis|erh|erk|ern|esc|est|eue|fra|fre|ges|he |hei|hne|ht |hte|ihr|ion|ite|kla|lav|len|mit|ns |nse|"
+        "on |ote|rde|rec|sen|sin"
+    },
+    {"fr",
+        "es | de|de | le|les|re |us | la| et| no|et |la |nt |ns |ous| à |ent|ion|le | qu|it |on |tre| au|"
+        " co| se| to|ait|nou|que|tio|tou| en| po| pr| so|lle|our|res|ser|te |ue |ver|és | av| dé| vo|ais|"
+        "ati|ave|cla|des|er |ir |ons|ont|out|ur | al| d | es| fa| in| ma| ou| pa| pl| un| vi|ans|ce |du |"
+        "ez |ien|in |mes|mme|ne |ouv|roi|son|ter|ts |un |ute|uve| a | da| du| l | li| on| pe| tr|ale|all|"
+        "dan|der|en |ert|erv|est|for|ie |is |its|lan|oir|omm|os |ou |plu|pou|rai|rs |sti|tes|té |ux |vou|"
+        " do| dr| il| na| ra| re|age|aie|ain|and|au |aut|aux|ava|con|cou|dro|déc|ell|ern|err|ers|esc|eur|"
+        "fai|ge |ide|ill|ini|ins"
+    },
+    {"es",
+        "os | de|as | la| es|de | co|est| y |la | a |el |en |con|que| el| en| lo|es |ien|sta|ón | qu|ión|"
+        "ue | pe| po| to|ció|ent|los|na |ía |nte|on |tod| di| no| pr| se| su| un|ar |das|ida|mos|res|ta |"
+        "te |tie|tra|tro| ti|aci|ado|an |ant|cla|der|do |dos|esc|ici|ier|las|nci|nos|nta|or |rta|str|tad|"
+        " al| na| nu| o | pa| re|cho|cia|ech|enc|ene|er |ere|ert|gun|men|no |nue|oda|otr|per|por|qui|rec|"
+        "ro |ser|tar|tas|to |ues|vid| an| cu| fr| ha| li| ll| ma| mi| ot| so| vi|ad |ade|al |ale|ará|ata|"
+        "ate|bre|ca |co |cua|da |eci|egu|equ|ero|ers|erv|hos|imo|ina|ist|lav|le |les|lib|mar|nac|ne |odo|"
+        "ona|ond|pre|pro|ra |ros"
+    },
+    {"it",
+        " di|di |re |la |no |to | al| e |ti | in|le |ne | de|il |ion|lla|te | co| il|li | ch| ha| se|con|"
+        "one| le| pe| pr|all|ann|are|che|chi|ent|gli|ni |per|ser|za |zio| an| la| no| tu|er |ere|gio|he |"
+        "in |ra |ri |ro |tro|tti|vit| do| gl| ma| ne| o | pa| pi| vi|and|ber|ell|ert|ess|hia|na |ndi|nno|"
+        "on |rit|ta |tto| es| li| po| qu| ra| ri| sc| sp| un|agi|ali|alt|ano|att|azi|ci |cia|col|del|era|"
+        "erv|ett|ha |iam|icc|ici|iri|ist|ita|ivi|izi|mo |nde|nza|olo|ono|ori|ost|ove|pro|rvi|spe|sta|str|"
+        "tar|tat|tut|tà |un |uo |utt|va |ver| a | ai| fa| na| si| so| st| tr|amo|anc|art|ate|ati|ato|avi|"
+        "cos|dir|div|duo|eva|gni"
+    },
+    {"pt",
+        "os |as |de | de|ão |em | e | es| no| a | co| se|ar |nos|que|to | em|ent| di| os| ou| pe| qu|ida|"
+        "ra |te | as| ma| o | po|da |do |es |men|nte|res|ser|sta| na| pr| to|ade|ais|com|dad|dos|er |est|"
+        "is |na |ou |tod|tos|ue | do| à |ara|ava|ia |ito|mos|om |oss| li| pa| re| su| um|am |ano|ber|cia|"
+        "con|dar|das|eit|esc|io |mai|man|odo|pro|ran|rei|scr|sto|tas|ter|tra|um |uma|ura|va |vid|ção| al|"
+        " ao| en| fe| fo| in| nã| ra| so| te| vi|ada|al |ant|açã|cra|dir|dis|equ|ere|ert|erv|esp|for|inh|"
+        "ire|iss|ist|mas|nco|nda|nha|no |nta|nto|não|ode|or |out|par|per|pod|qua|rav|ria|rio|rvi|ssa|sso|"
+        "tav|utr|ça | ab| aj| an"
+    },
+    {"nl",
+        "en |de | de| en| he|gen| ge|et |aar|der|ten|den|er |nde| on|te |ver| in| me| op|ens|ij |in | be|"
+        " ee| zi|an |at |een|ing|sch|ste|ze | aa| da| te| vr| wa|and|cht|eid|het|ond|op |van| al| di| ni|"
+        " of| re| va| ve|aat|al |ar |dat|die|ede|end|ers|hei|id |ie |men|met|nge|nie|of |oor|oud|rij|sta|"
+        "zij| kl| ma| na| u | we| wi| ze| zo|aan|as |ave|eef|eft|ege|el |ere|est|ft |hee|hte|ied|ijn|jn |"
+        "le |len|ng |nst|pen|rde|re |sla|ven|we | ho| ie| ko| sl| st| vi| vo|age|ant|ard|ati|ats|ech|eli|"
+        "ern|esl|euw|geb|gel|ges|gin|ien|ieu|ijk|ke |kle|lav|lij|lle|ls |maa|nd |nen|nne|ns |nze|oge|ons|"
+        "onz|or |ord|ote|rag|rec"
+    },
+    {"sv",
+        "de |en |er | oc|ch |och|tt | de|att|om | at|na | fö|ter|ade|ar |et |för|ill|rna| ti| vi|an |and|"
+        "lle|var| i | me| va|ell|ern|het|ing|la |ll |til|är | fr| ha| på| st|all|gen|kom|lla|nde|ng |på |"
+        "ra |ör | el| en| ko| so|ara|den|ete|gt |ler|med|mer|som|sta|stä| al| di| li| re| sa| sl| ut| är|"
+        "as |ati|dan|der|eri|est|ion|isk|lig|nad|omm|on |or |rät|sla|ss |ste|tig|vi |vår|äll|ätt| ba| be|"
+        " br| du| in| ny| os| po| rä| sk| så| vå|av |du |ed |eda|for|fri|har|igt|in |las|lav|lln|lt |mme|"
+        "nin|nna|oss|ran|re |rin|rt |ska|sko|ta |te |tio|tis|tti|täl|ver|ågo|år | an| av| bö| et| fl| fo|"
+        " få| ga| ge| gå| hj| ho"
+    },
+};
+
+const size_t LANGUAGE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+static_assert(LANGUAGE_COUNT <= 8, "scores hold eight languages");
+
+// Letters outside Latin-1 all become this symbol, which no profile contains
+const unsigned char OTHER_LETTER = 0x80;
+
+// Open addressing over packed trigrams; keys are kept apart from the
+// weights so that the many lookups that miss touch only the keys
+const size_t TABLE_BITS = 12;
+const size_t TABLE_SIZE = size_t(1) << TABLE_BITS;
+
+// A language must lead the next one by this much to stop early, which
+// takes some 15 to 30 words of clear text
+const uint32_t DECISIVE_LEAD = 1000;
+const size_t MIN_TRIGRAMS = 32;
+const size_t CHECK_INTERVAL = 64;       // Trigrams between checks for a decision
+
+// Letters in another script needed to decide by script alone
+const uint32_t DECISIVE_SCRIPT_LETTERS = 64;
+
+struct Model {
+    uint32_t keys[TABLE_SIZE];                  // 0 for empty slots
+    uint64_t weights[TABLE_SIZE];               // A byte per language, 0 if not in its profile
+};
+
+// Where a language's weight sits: even languages in the low bytes of the
+// 16-bit pairs, odd ones in the high bytes
+int weightShift(size_t language) {
+    return static_cast<int>(16 * (language / 2) + 8 * (language % 2));
+}
+
+const uint64_t EVEN_BYTES = 0x00FF00FF00FF00FFull;
+
+// Trigrams between flushes of the 16-bit lanes; 256 * 255 still fits
+const uint32_t LANE_FLUSH_HITS = 256;
+
+size_t slotOf(uint32_t key) {
+    return (key * 2654435761u) >> (32 - TABLE_BITS);
+}
+
+unsigned char foldAscii(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<unsigned char>(c + ('a' - 'A'));
+    }
+    return (c >= 'a' && c <= 'z') ? c : ' ';
+}
+
+// foldAscii() of plain text bytes; 0 for bytes that need the full state
+// machine: '<', '&' and everything outside ASCII
+struct TextFold {
+    unsigned char fold[256];
+
+    TextFold() : fold() {
+        for (int c = 0; c < 0x80; ++c) {
+            fold[c] = foldAscii(static_cast<unsigned char>(c));
+        }
+        fold[static_cast<unsigned char>('<')] = 0;
+        fold[static_cast<unsigned char>('&')] = 0;
+    }
+};
+
+const TextFold TEXT_FOLD;
+
+// Latin-1 letter from the second byte of a 0xC3 sequence, lowercased, or ' '
+unsigned char foldLatin1(unsigned char continuation) {
+    unsigned char c = static_cast<unsigned char>(0xC0 | (continuation & 0x3F));
+    if (c == 0xD7 || c == 0xF7) {
+        return ' ';     // Multiplication and division signs
+    }
+    return c <= 0xDE ? static_cast<unsigned char>(c + 0x20) : c;
+}
+
+const Model& model() {
+    static const Model built = [] {
+        Model table{};
+        for (size_t language = 0; language < LANGUAGE_COUNT; ++language) {
+            std::string_view profile(PROFILES[language].trigrams);
+            size_t count = static_cast<size_t>(std::count(profile.begin(), profile.end(), '|')) + 1;
+
+            size_t rank = 0;
+            size_t start = 0;
+            while (start <= profile.size()) {
+                size_t end = std::min(profile.find('|', start), profile.size());
+                uint32_t key = 0;
+                for (size_t i = start; i < end; ++i) {
+                    unsigned char c = static_cast<unsigned char>(profile[i]);
+                    if (c == 0xC3 && i + 1 < end) {
+                        c = foldLatin1(static_cast<unsigned char>(profile[++i]));
+                    } else {
+                        c = foldAscii(c);
+                    }
+                    key = (key << 8) | c;
+                }
+
+                // Ranks follow Zipf's law, so log-probabilities fall with
+                // log(rank); unlisted trigrams get half the last one's
+                double weight = 16.0 * std::log(2.0 * (count + 1) / (rank + 1));
+                size_t slot = slotOf(key);
+                while (table.keys[slot] != 0 && table.keys[slot] != key) {
+                    slot = (slot + 1) & (TABLE_SIZE - 1);
+                }
+                table.keys[slot] = key;
+                uint64_t quantized = static_cast<uint64_t>(std::min(255.0, std::max(1.0, std::round(weight))));
+                table.weights[slot] |= quantized << weightShift(language);
+
+                rank++;
+                start = end + 1;
+            }
+        }
+        return table;
+    }();
+    return built;
+}
+
+// Built during static initialization, so identifiers must not be used
+// by other static initializers
+const Model& MODEL = model();
+
+} // namespace
+
+LanguageIdentifier::LanguageIdentifier(size_t maxTextBytes)
+    : maxTextBytes(maxTextBytes) {
+    reset();
+}
+
+void LanguageIdentifier::reset() {
+    textBytes = 0;
+    done = false;
+    inTag = false;
+    inRawText = false;
+    tagLength = 0;
+    tagNameDone = false;
+    entityLength = -1;
+    lead = 0;
+    second = 0;
+    pending = 0;
+    history = (' ' << 8) | ' ';
+    trigrams = 0;
+    std::fill(std::begin(scores), std::end(scores), 0);
+    lanes[0] = lanes[1] = 0;
+    laneHits = 0;
+    std::fill(std::begin(scriptCounts), std::end(scriptCounts), 0);
+}
+
+void LanguageIdentifier::addChar(unsigned char c) {
+    uint32_t previous = history & 0xFF;
+    if (c == ' ' && previous == ' ') {
+        return;
+    }
+
+    uint32_t key = (history << 8) | c;
+    history = key & 0xFFFF;
+
+    // Trigrams spanning two words or holding other letters are in no profile
+    if (previous == ' ' || previous == OTHER_LETTER || c == OTHER_LETTER || (key >> 16) == OTHER_LETTER) {
+        return;
+    }
+
+    size_t slot = slotOf(key);
+    while (MODEL.keys[slot] != 0) {
+        if (MODEL.keys[slot] == key) {
+            // All eight weights are added at once, two bytes apart
+            uint64_t weights = MODEL.weights[slot];
+            lanes[0] += weights & EVEN_BYTES;
+            lanes[1] += (weights >> 8) & EVEN_BYTES;
+            if (++laneHits == LANE_FLUSH_HITS) {
+                getScores(scores);
+                lanes[0] = lanes[1] = 0;
+                laneHits = 0;
+            }
+            break;
+        }
+        slot = (slot + 1) & (TABLE_SIZE - 1);
+    }
+
+    trigrams++;
+    if (trigrams % CHECK_INTERVAL == 0 && decided()) {
+        done = true;
+    }
+}
+
+void LanguageIdentifier::endTag() {
+    if (tagLength > sizeof(tagName)) {
+        return;
+    }
+    std::string_view name(tagName, tagLength);
+    if (name == "script" || name == "style") {
+        inRawText = true;
+    } else if (name == "/script" || name == "/style") {
+        inRawText = false;
+    }
+}
+
+void LanguageIdentifier::getScores(uint32_t* totals) const {
+    for (size_t language = 0; language < 8; ++language) {
+        uint32_t lane = static_cast<uint32_t>(lanes[language % 2] >> (16 * (language / 2))) & 0xFFFF;
+        totals[language] = scores[language] + lane;
+    }
+}
+
+bool LanguageIdentifier::decided() const {
+    uint32_t otherScript = *std::max_element(scriptCounts + CYRILLIC, scriptCounts + SCRIPT_COUNT);
+    if (otherScript >= DECISIVE_SCRIPT_LETTERS && otherScript > scriptCounts[LATIN]) {
+        return true;
+    }
+    if (trigrams < MIN_TRIGRAMS) {
+        return false;
+    }
+
+    uint32_t totals[8];
+    getScores(totals);
+    uint32_t best = 0;
+    uint32_t second = 0;
+    for (size_t language = 0; language < LANGUAGE_COUNT; ++language) {
+        if (totals[language] > best) {
+            second = best;
+            best = totals[language];
+        } else if (totals[language] > second) {
+            second = totals[language];
+        }
+    }
+    return best - second >= DECISIVE_LEAD;
+}
+
+bool LanguageIdentifier::feed(const char* data, size_t size) {
+    for (size_t i = 0; i < size && !done; ++i) {
+        // Runs of plain ASCII text, the bulk of most pages, skip the state machine
+        if (!inTag && !inRawText && entityLength < 0 && textBytes < maxTextBytes) {
+            size_t end = std::min(size, i + (maxTextBytes - textBytes));
+            size_t start = i;
+            uint32_t letters = 0;
+            while (i < end && !done) {
+                unsigned char folded = TEXT_FOLD.fold[static_cast<unsigned char>(data[i])];
+                if (folded == 0) {
+                    break;
+                }
+                letters += folded != ' ';
+                addChar(folded);
+                ++i;
+            }
+            if (i > start) {
+                pending = 0;
+                textBytes += i - start;
+                scriptCounts[LATIN] += letters;
+            }
+            if (i == size || done) {
+                break;
+            }
+        }
+
+        unsigned char c = static_cast<unsigned char>(data[i]);
+
+        if (inTag) {
+            if (c == '>') {
+                endTag();
+                inTag = false;
+            } else if (!tagNameDone) {
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || (c == '/' && tagLength > 0)) {
+                    tagNameDone = true;
+                } else {
+                    if (tagLength < sizeof(tagName)) {
+                        tagName[tagLength] = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+                    }
+                    tagLength++;
+                }
+            }
+            continue;
+        }
+        if (c == '<') {
+            inTag = true;
+            tagLength = 0;
+            tagNameDone = false;
+            pending = 0;
+            addChar(' ');
+            continue;
+        }
+        if (inRawText) {
+            continue;
+        }
+
+        // Character references such as &eacute; are skipped
+        if (entityLength >= 0) {
+            if (c == ';') {
+                entityLength = -1;
+                continue;
+            }
+            if (entityLength < 10 && (foldAscii(c) != ' ' || (c >= '0' && c <= '9') || c == '#')) {
+                entityLength++;
+                continue;
+            }
+            entityLength = -1;
+        }
+        if (c == '&') {
+            entityLength = 0;
+            continue;
+        }
+
+        if (++textBytes > maxTextBytes) {
+            done = true;
+            break;
+        }
+
+        if (c < 0x80) {
+            pending = 0;
+            unsigned char folded = foldAscii(c);
+            if (folded != ' ') {
+                scriptCounts[LATIN]++;
+            }
+            addChar(folded);
+            continue;
+        }
+
+        if (c < 0xC0) {
+            // Continuation byte
+            if (pending == 0) {
+                continue;
+            }
+            if (lead >= 0xE0 && second == 0) {
+                second = c;
+            }
+            if (--pending > 0) {
+                continue;
+            }
+
+            if (lead == 0xC3) {
+                unsigned char folded = foldLatin1(c);
+                if (folded != ' ') {
+                    scriptCounts[LATIN]++;
+                }
+                addChar(folded);
+            } else if (lead == 0xC2 || lead == 0xE2 || (lead == 0xE3 && second == 0x80)) {
+                // Latin-1 symbols, general and CJK punctuation
+                addChar(' ');
+            } else if (lead == 0xCC || lead == 0xCD) {
+                // Combining marks belong to the letter before them
+            } else {
+                Script script = SCRIPT_COUNT;
+                if (lead >= 0xC4 && lead <= 0xC9) {
+                    script = LATIN;
+                } else if (lead == 0xCE || lead == 0xCF) {
+                    script = GREEK;
+                } else if (lead >= 0xD0 && lead <= 0xD3) {
+                    script = CYRILLIC;
+                } else if (lead == 0xD7) {
+                    script = HEBREW;
+                } else if (lead >= 0xD8 && lead <= 0xDB) {
+                    script = ARABIC;
+                } else if (lead == 0xE0 && (second == 0xA4 || second == 0xA5)) {
+                    script = DEVANAGARI;
+                } else if (lead == 0xE3 && second >= 0x81 && second <= 0x83) {
+                    script = KANA;
+                } else if (lead >= 0xE4 && lead <= 0xE9) {
+                    script = HAN;
+                } else if ((lead == 0xEA && second >= 0xB0) || lead == 0xEB || lead == 0xEC ||
+                           (lead == 0xED && second <= 0x9E)) {
+                    script = HANGUL;
+                }
+                if (script != SCRIPT_COUNT) {
+                    scriptCounts[script]++;
+                }
+                addChar(OTHER_LETTER);
+            }
+            continue;
+        }
+
+        // Lead byte
+        lead = c;
+        second = 0;
+        pending = c < 0xE0 ? 1 : c < 0xF0 ? 2 : c < 0xF8 ? 3 : 0;
+        if (pending == 0) {
+            addChar(' ');
+        }
+    }
+    return !done;
+}
+
+LanguageIdentifier::Result LanguageIdentifier::finish() const {
+    // Mostly another script: the language follows from the script
+    const uint32_t* other = std::max_element(scriptCounts + CYRILLIC, scriptCounts + SCRIPT_COUNT);
+    uint32_t cjk = scriptCounts[HAN] + scriptCounts[KANA];
+    uint32_t letters = 0;
+    for (uint32_t count : scriptCounts) {
+        letters += count;
+    }
+    if (letters > 0 && std::max(*other, cjk) > scriptCounts[LATIN]) {
+        if (cjk >= *other) {
+            // Japanese mixes kana into its kanji, Chinese has none
+            const char* language = scriptCounts[KANA] * 10 >= cjk ? "ja" : "zh";
+            return Result{language, static_cast<double>(cjk) / letters};
+        }
+        static const char* const SCRIPT_LANGUAGES[SCRIPT_COUNT] = {
+            "", "ru", "el", "he", "ar", "hi", "ko", "ja", "zh"
+        };
+        return Result{SCRIPT_LANGUAGES[other - scriptCounts], static_cast<double>(*other) / letters};
+    }
+
+    uint32_t totals[8];
+    getScores(totals);
+    size_t best = 0;
+    uint32_t second = 0;
+    for (size_t language = 1; language < LANGUAGE_COUNT; ++language) {
+        if (totals[language] > totals[best]) {
+            second = totals[best];
+            best = language;
+        } else if (totals[language] > second) {
+            second = totals[language];
+        }
+    }
+    if (totals[best] == second) {
+        return Result{UNKNOWN, 0.0};
+    }
+    return Result{PROFILES[best].language, static_cast<double>(totals[best] - second) / totals[best]};
+}
+
+LanguageIdentifier::Result LanguageIdentifier::identify(std::string_view text, size_t maxTextBytes) {
+    LanguageIdentifier identifier(maxTextBytes);
+    identifier.feed(text.data(), text.size());
+    return identifier.finish();
+}
+
+std::vector<std::string> LanguageIdentifier::getLanguages() {
+    std::vector<std::string> languages;
+    for (const auto& profile : PROFILES) {
+        languages.push_back(profile.language);
+    }
+    return languages;
+}
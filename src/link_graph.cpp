@@ -0,0 +1,390 @@
+#include "../include/link_graph.hpp"
+#include "../include/varint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+constexpr LinkGraph::UrlId LinkGraph::NO_ID;
+
+namespace {
+
+// Nodes per thread below which splitting a pass is not worth a thread
+const size_t MIN_NODES_PER_THREAD = 4096;
+
+// Run body(begin, end, part) over [0, count) split in contiguous parts, one
+// thread each; returns the number of parts
+size_t parallelFor(size_t threads, size_t count, const std::function<void(size_t, size_t, size_t)>& body) {
+    size_t parts = std::max<size_t>(1, std::min(threads, count / MIN_NODES_PER_THREAD));
+    if (parts == 1) {
+        body(0, count, 0);
+        return 1;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(parts);
+    for (size_t part = 0; part < parts; ++part) {
+        workers.emplace_back(body, count * part / parts, count * (part + 1) / parts, part);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return parts;
+}
+
+double sum(const std::vector<double>& values, size_t count) {
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+// Out-links and in-links of every node as compressed sparse rows
+struct Csr {
+    std::vector<size_t> outOffsets;
+    std::vector<LinkGraph::UrlId> outTargets;
+    std::vector<size_t> inOffsets;
+    std::vector<LinkGraph::UrlId> inSources;
+};
+
+} // namespace
+
+LinkGraph::LinkGraph()
+    : pageCount(0)
+    , edgeCount(0) {
+}
+
+void LinkGraph::encodeLinks(UrlId source, std::vector<UrlId>& targets, std::string& out) {
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (i == 0) {
+            int64_t offset = static_cast<int64_t>(targets[0]) - static_cast<int64_t>(source);
+            putVarint(out, zigzagEncode(offset));
+        } else {
+            putVarint(out, targets[i] - targets[i - 1] - 1);
+        }
+    }
+}
+
+bool LinkGraph::decodeLinks(UrlId source, std::string_view data, size_t count, std::vector<UrlId>& targets) {
+    size_t position = 0;
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value;
+        if (!getVarint(data, position, value)) {
+            return false;
+        }
+
+        int64_t target;
+        if (i == 0) {
+            target = static_cast<int64_t>(source) + zigzagDecode(value);
+        } else {
+            if (value >= NO_ID) {
+                return false;
+            }
+            target = previous + static_cast<int64_t>(value) + 1;
+        }
+        if (target < 0 || target >= static_cast<int64_t>(NO_ID)) {
+            return false;
+        }
+        targets.push_back(static_cast<UrlId>(target));
+        previous = target;
+    }
+    return position == data.size();
+}
+
+LinkGraph::UrlId LinkGraph::internLocked(std::string_view url) {
+    auto it = ids.find(url);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    if (urls.size() >= NO_ID) {
+        return NO_ID;
+    }
+
+    UrlId id = static_cast<UrlId>(urls.size());
+    urls.emplace_back(url);
+    ids.emplace(urls.back(), id);
+    return id;
+}
+
+LinkGraph::UrlId LinkGraph::intern(std::string_view url) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return internLocked(url);
+}
+
+LinkGraph::UrlId LinkGraph::find(std::string_view url) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(url);
+    return it != ids.end() ? it->second : NO_ID;
+}
+
+std::string LinkGraph::getUrl(UrlId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return id < urls.size() ? urls[id] : std::string();
+}
+
+void LinkGraph::addPage(std::string_view url, const std::pmr::vector<std::pmr::string>& links) {
+    std::vector<UrlId> targets;
+    targets.reserve(links.size());
+    std::string encoded;
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    UrlId source = internLocked(url);
+    if (source == NO_ID) {
+        return;
+    }
+    for (const auto& link : links) {
+        UrlId target = internLocked(link);
+        if (target != NO_ID && target != source) {
+            targets.push_back(target);
+        }
+    }
+    encodeLinks(source, targets, encoded);
+
+    if (spans.size() <= source) {
+        spans.resize(static_cast<size_t>(source) + 1);
+    }
+    Span& span = spans[source];
+    if (span.offset == UINT64_MAX) {
+        pageCount++;
+    }
+    edgeCount = edgeCount - span.count + targets.size();
+
+    // Replaced links are left behind; pages are rarely added twice
+    span.offset = adjacency.size();
+    span.size = static_cast<uint32_t>(encoded.size());
+    span.count = static_cast<uint32_t>(targets.size());
+    adjacency += encoded;
+}
+
+void LinkGraph::getLinks(UrlId page, std::vector<UrlId>& links) const {
+    links.clear();
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (page >= spans.size() || spans[page].count == 0) {
+        return;
+    }
+    const Span& span = spans[page];
+    decodeLinks(page, std::string_view(adjacency).substr(span.offset, span.size), span.count, links);
+}
+
+LinkGraph::RankResult LinkGraph::rank(const RankOptions& options) {
+    // Snapshot the graph so pages can keep arriving while it is ranked
+    std::vector<Span> spanCopy;
+    std::string data;
+    size_t n;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        n = urls.size();
+        spanCopy = spans;
+        data = adjacency;
+    }
+
+    RankResult result;
+    result.urls = n;
+    if (n == 0) {
+        return result;
+    }
+
+    size_t threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<double> partials(threads);
+
+    // Decode the out-links of every page in parallel, then invert them
+    Csr graph;
+    graph.outOffsets.assign(n + 1, 0);
+    for (size_t page = 0; page < spanCopy.size(); ++page) {
+        graph.outOffsets[page + 1] = spanCopy[page].count;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        graph.outOffsets[i + 1] += graph.outOffsets[i];
+    }
+    graph.outTargets.resize(graph.outOffsets[n]);
+    result.edges = graph.outTargets.size();
+
+    parallelFor(threads, spanCopy.size(), [&](size_t begin, size_t end, size_t) {
+        std::vector<UrlId> links;
+        std::string_view view(data);
+        for (size_t page = begin; page < end; ++page) {
+            const Span& span = spanCopy[page];
+            if (span.count == 0) {
+                continue;
+            }
+            links.clear();
+            if (!decodeLinks(static_cast<UrlId>(page), view.substr(span.offset, span.size), span.count, links)) {
+                // Only possible if the store is corrupt; keep the row its declared size
+                links.resize(span.count, static_cast<UrlId>(page));
+            }
+            std::copy(links.begin(), links.end(), graph.outTargets.begin() + graph.outOffsets[page]);
+        }
+    });
+
+    graph.inOffsets.assign(n + 1, 0);
+    for (UrlId target : graph.outTargets) {
+        graph.inOffsets[target + 1]++;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        graph.inOffsets[i + 1] += graph.inOffsets[i];
+    }
+    graph.inSources.resize(graph.outTargets.size());
+    {
+        std::vector<size_t> fill(graph.inOffsets.begin(), graph.inOffsets.end() - 1);
+        for (size_t source = 0; source < n; ++source) {
+            for (size_t i = graph.outOffsets[source]; i < graph.outOffsets[source + 1]; ++i) {
+                graph.inSources[fill[graph.outTargets[i]]++] = static_cast<UrlId>(source);
+            }
+        }
+    }
+
+    std::vector<double> score(n);
+    std::vector<double> next(n);
+
+    if (options.algorithm == Algorithm::PAGERANK) {
+        // Pull-based power iteration; dangling pages spread their score evenly
+        double damping = options.damping;
+        std::vector<double> share(n);
+        std::fill(score.begin(), score.end(), 1.0 / static_cast<double>(n));
+
+        for (result.iterations = 0; result.iterations < options.maxIterations; ) {
+            size_t parts = parallelFor(threads, n, [&](size_t begin, size_t end, size_t part) {
+                double dangling = 0.0;
+                for (size_t v = begin; v < end; ++v) {
+                    size_t degree = graph.outOffsets[v + 1] - graph.outOffsets[v];
+                    share[v] = degree > 0 ? score[v] / static_cast<double>(degree) : 0.0;
+                    if (degree == 0) {
+                        dangling += score[v];
+                    }
+                }
+                partials[part] = dangling;
+            });
+            double base = (1.0 - damping + damping * sum(partials, parts)) / static_cast<double>(n);
+
+            parts = parallelFor(threads, n, [&](size_t begin, size_t end, size_t part) {
+                double delta = 0.0;
+                for (size_t u = begin; u < end; ++u) {
+                    double incoming = 0.0;
+                    for (size_t i = graph.inOffsets[u]; i < graph.inOffsets[u + 1]; ++i) {
+                        incoming += share[graph.inSources[i]];
+                    }
+                    next[u] = base + damping * incoming;
+                    delta += std::fabs(next[u] - score[u]);
+                }
+                partials[part] = delta;
+            });
+            score.swap(next);
+            result.iterations++;
+            result.delta = sum(partials, parts);
+            if (result.delta < options.tolerance) {
+                break;
+            }
+        }
+    } else {
+        // Authorities collect their linkers' hub scores and hubs their
+        // targets' authority, each normalized to unit length
+        std::vector<double> hub(n, 1.0 / std::sqrt(static_cast<double>(n)));
+        std::fill(score.begin(), score.end(), 1.0 / std::sqrt(static_cast<double>(n)));
+
+        auto normalize = [&](std::vector<double>& values) {
+            size_t parts = parallelFor(threads, n, [&](size_t begin, size_t end, size_t part) {
+                double squares = 0.0;
+                for (size_t i = begin; i < end; ++i) {
+                    squares += values[i] * values[i];
+                }
+                partials[part] = squares;
+            });
+            double length = std::sqrt(sum(partials, parts));
+            if (length > 0.0) {
+                parallelFor(threads, n, [&](size_t begin, size_t end, size_t) {
+                    for (size_t i = begin; i < end; ++i) {
+                        values[i] /= length;
+                    }
+                });
+            }
+        };
+
+        for (result.iterations = 0; result.iterations < options.maxIterations; ) {
+            parallelFor(threads, n, [&](size_t begin, size_t end, size_t) {
+                for (size_t u = begin; u < end; ++u) {
+                    double total = 0.0;
+                    for (size_t i = graph.inOffsets[u]; i < graph.inOffsets[u + 1]; ++i) {
+                        total += hub[graph.inSources[i]];
+                    }
+                    next[u] = total;
+                }
+            });
+            normalize(next);
+
+            parallelFor(threads, n, [&](size_t begin, size_t end, size_t) {
+                for (size_t u = begin; u < end; ++u) {
+                    double total = 0.0;
+                    for (size_t i = graph.outOffsets[u]; i < graph.outOffsets[u + 1]; ++i) {
+                        total += next[graph.outTargets[i]];
+                    }
+                    hub[u] = total;
+                }
+            });
+            normalize(hub);
+
+            size_t parts = parallelFor(threads, n, [&](size_t begin, size_t end, size_t part) {
+                double delta = 0.0;
+                for (size_t u = begin; u < end; ++u) {
+                    delta += std::fabs(next[u] - score[u]);
+                }
+                partials[part] = delta;
+            });
+            score.swap(next);
+            result.iterations++;
+            result.delta = sum(partials, parts);
+            if (result.delta < options.tolerance) {
+                break;
+            }
+        }
+    }
+
+    // Scores are heavy-tailed: log-scale them so the frontier can still
+    // tell apart the many pages far below the top one. URLs nobody links
+    // to hold the minimum score and map to 0.
+    auto bounds = std::minmax_element(score.begin(), score.end());
+    double low = *bounds.first;
+    double scale = std::log1p(static_cast<double>(n) * (*bounds.second - low));
+    std::vector<float> scaled(n, 0.0f);
+    if (scale > 0.0) {
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = static_cast<float>(std::log1p(static_cast<double>(n) * (score[i] - low)) / scale);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    ranks = std::move(scaled);
+    return result;
+}
+
+float LinkGraph::getRank(std::string_view url) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(url);
+    return it != ids.end() && it->second < ranks.size() ? ranks[it->second] : 0.0f;
+}
+
+LinkGraph::Stats LinkGraph::getStats() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    Stats stats;
+    stats.urls = urls.size();
+    stats.pages = pageCount;
+    stats.edges = edgeCount;
+    stats.adjacencyBytes = adjacency.size();
+    return stats;
+}
+
+void LinkGraph::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    ids.clear();
+    urls.clear();
+    spans.clear();
+    adjacency.clear();
+    ranks.clear();
+    pageCount = 0;
+    edgeCount = 0;
+}
@@ -21,6 +21,7 @@ void printUsage(const char* programName) {
     std::cout << "  --allowed-domains <domains>  Comma-separated list of allowed domains (overrides config file)" << std::endl;
     std::cout << "  --verbose           Enable verbose logging" << std::endl;
     std::cout << "  --stats-only        Only display database statistics without crawling" << std::endl;
+    std::cout << "  --ndjson            Save pages and images as NDJSON instead of CSV" << std::endl;
     std::cout << "  --help              Display this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "If no config file is specified, default config.json will be used." << std::endl;
@@ -187,6 +188,7 @@ int main(int argc, char* argv[]) {
     std::vector<std::string> allowedDomains = {"example.com", "sub.example.com"};
     bool verbose = false;
     bool statsOnly = false;
+    bool ndjson = false;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -217,6 +219,8 @@ int main(int argc, char* argv[]) {
             verbose = true;
         } else if (arg == "--stats-only") {
             statsOnly = true;
+        } else if (arg == "--ndjson") {
+            ndjson = true;
         }
     }
     
@@ -232,6 +236,9 @@ int main(int argc, char* argv[]) {
     // Configure crawler
     crawler.setMaxThreads(maxThreads);
     crawler.setMaxDepth(maxDepth);
+    if (ndjson) {
+        crawler.setOutputFormat(RecordSink::Format::NDJSON);
+    }
     
     // Set allowed domains
     if (!allowedDomains.empty()) {
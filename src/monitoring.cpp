@@ -6,9 +6,12 @@
 #include <chrono>
 #include <cstdarg>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <cctype>
 
 Monitoring::Monitoring(const std::string& logFilePath, LogLevel level)
-    : currentLogLevel(level), logFilePath(logFilePath) {
+    : currentLogLevel(level), consoleOutput(true), logFilePath(logFilePath) {
     
     // Initialize metrics
     metrics.pagesCrawled = 0;
@@ -63,7 +66,9 @@ void Monitoring::log(LogLevel level, const std::string& message) {
     std::string logLine = timeStr.str() + " [" + logLevelToString(level) + "] " + message;
     
     // Output to console and file
-    std::cout << logLine << std::endl;
+    if (consoleOutput) {
+        std::cout << logLine << std::endl;
+    }
     
     if (logFile.is_open()) {
         logFile << logLine << std::endl;
@@ -122,6 +127,11 @@ std::string Monitoring::getCurrentStats() const {
           << ", URLs queued: " << current.urlsQueued
           << ", Active threads: " << current.activeThreads;
     
+    std::lock_guard<std::mutex> lock(counterMutex);
+    for (const auto& [name, value] : counters) {
+        stats << ", " << name << ": " << value;
+    }
+    
     return stats.str();
 }
 
@@ -171,6 +181,87 @@ double Monitoring::getAverageOperationTime(const std::string& operationName) con
     return 0.0;
 }
 
+// Latency histogram buckets per doubling of the latency
+static const double LATENCY_BUCKETS_PER_OCTAVE = 8.0;
+
+void Monitoring::recordLatency(const std::string& name, std::chrono::duration<double> latency) {
+    // Bucket by microseconds; everything under 1us shares bucket 0
+    double micros = std::max(1.0, latency.count() * 1e6);
+    size_t bucket = static_cast<size_t>(std::log2(micros) * LATENCY_BUCKETS_PER_OCTAVE);
+    
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    std::vector<uint64_t>& histogram = latencyHistograms[name];
+    if (histogram.size() <= bucket) {
+        histogram.resize(bucket + 1, 0);
+    }
+    histogram[bucket]++;
+}
+
+double Monitoring::getLatencyPercentile(const std::string& name, double percentile) const {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    
+    auto it = latencyHistograms.find(name);
+    if (it == latencyHistograms.end()) {
+        return 0.0;
+    }
+    
+    uint64_t total = 0;
+    for (uint64_t count : it->second) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+    
+    // Smallest bucket whose cumulative count reaches the requested rank
+    double rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * static_cast<double>(total);
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (; bucket < it->second.size(); ++bucket) {
+        cumulative += it->second[bucket];
+        if (cumulative > 0 && static_cast<double>(cumulative) >= rank) {
+            break;
+        }
+    }
+    
+    // Report the middle of the bucket
+    double micros = std::exp2((static_cast<double>(bucket) + 0.5) / LATENCY_BUCKETS_PER_OCTAVE);
+    return micros / 1e6;
+}
+
+void Monitoring::addCounter(const std::string& name, long long delta) {
+    std::lock_guard<std::mutex> lock(counterMutex);
+    counters[name] += delta;
+}
+
+long long Monitoring::getCounter(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(counterMutex);
+    auto it = counters.find(name);
+    return it != counters.end() ? it->second : 0;
+}
+
+void Monitoring::setConsoleOutput(bool enabled) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    consoleOutput = enabled;
+}
+
+Monitoring::LogLevel Monitoring::parseLogLevel(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    
+    if (upper == "DEBUG") {
+        return LogLevel::DEBUG;
+    } else if (upper == "WARNING" || upper == "WARN") {
+        return LogLevel::WARNING;
+    } else if (upper == "ERROR") {
+        return LogLevel::LOG_ERROR;
+    } else if (upper == "CRITICAL") {
+        return LogLevel::CRITICAL;
+    }
+    return LogLevel::INFO;
+}
+
 std::string Monitoring::logLevelToString(LogLevel level) const {
     switch (level) {
         case LogLevel::DEBUG:
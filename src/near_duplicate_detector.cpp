@@ -0,0 +1,187 @@
+#include "../include/near_duplicate_detector.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+// Words per shingle
+const size_t SHINGLE_SIZE = 3;
+
+// Pages with fewer shingles are too short to fingerprint reliably
+const size_t MIN_SHINGLES = 8;
+
+uint64_t mix(uint64_t value) {
+    // splitmix64 finalizer: spreads nearby inputs over all 64 bits
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+bool startsWithTag(const std::string& html, size_t pos, const char* name) {
+    size_t length = std::strlen(name);
+    if (pos + length >= html.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(html[pos + i])) != name[i]) {
+            return false;
+        }
+    }
+    char next = html[pos + length];
+    return next == '>' || next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == '/';
+}
+
+// Skip to just past the closing tag of a script or style element
+size_t skipElement(const std::string& html, size_t pos, const char* closing) {
+    size_t length = std::strlen(closing);
+    while (pos < html.size()) {
+        size_t lt = html.find("</", pos);
+        if (lt == std::string::npos) {
+            return html.size();
+        }
+        if (startsWithTag(html, lt + 2, closing)) {
+            size_t gt = html.find('>', lt + 2 + length);
+            return gt == std::string::npos ? html.size() : gt + 1;
+        }
+        pos = lt + 2;
+    }
+    return html.size();
+}
+
+} // namespace
+
+NearDuplicateDetector::NearDuplicateDetector(int maxDistance, size_t maxFingerprints)
+    : maxDistance(std::max(0, std::min(maxDistance, BLOCKS - 1)))
+    , maxFingerprints(maxFingerprints)
+    , duplicates(0) {
+}
+
+uint64_t NearDuplicateDetector::fingerprint(const std::string& html) {
+    int counts[64] = {0};
+    uint64_t window[SHINGLE_SIZE] = {0};
+    size_t words = 0;
+    size_t shingles = 0;
+
+    uint64_t wordHash = 0;
+    bool inWord = false;
+
+    auto endWord = [&]() {
+        window[words % SHINGLE_SIZE] = wordHash;
+        words++;
+        inWord = false;
+        if (words < SHINGLE_SIZE) {
+            return;
+        }
+
+        // Order-sensitive combination of the last SHINGLE_SIZE words
+        uint64_t shingle = 0;
+        for (size_t i = 0; i < SHINGLE_SIZE; ++i) {
+            shingle = mix(shingle ^ window[(words + i) % SHINGLE_SIZE]);
+        }
+        for (int bit = 0; bit < 64; ++bit) {
+            counts[bit] += ((shingle >> bit) & 1) ? 1 : -1;
+        }
+        shingles++;
+    };
+
+    size_t pos = 0;
+    while (pos < html.size()) {
+        char c = html[pos];
+
+        if (c == '<') {
+            if (inWord) {
+                endWord();
+            }
+            if (startsWithTag(html, pos + 1, "script")) {
+                pos = skipElement(html, pos + 1, "script");
+            } else if (startsWithTag(html, pos + 1, "style")) {
+                pos = skipElement(html, pos + 1, "style");
+            } else {
+                size_t gt = html.find('>', pos + 1);
+                pos = gt == std::string::npos ? html.size() : gt + 1;
+            }
+            continue;
+        }
+
+        unsigned char uc = static_cast<unsigned char>(c);
+        if (std::isalnum(uc) || uc >= 0x80) {
+            if (!inWord) {
+                wordHash = 0xcbf29ce484222325ULL;
+                inWord = true;
+            }
+            // FNV-1a over lower-cased bytes
+            wordHash = (wordHash ^ static_cast<unsigned char>(std::tolower(uc))) * 0x100000001b3ULL;
+        } else if (inWord) {
+            endWord();
+        }
+        pos++;
+    }
+    if (inWord) {
+        endWord();
+    }
+
+    if (shingles < MIN_SHINGLES) {
+        return 0;
+    }
+
+    uint64_t result = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (counts[bit] > 0) {
+            result |= 1ULL << bit;
+        }
+    }
+    return result;
+}
+
+bool NearDuplicateDetector::checkAndInsert(uint64_t fingerprint, const std::string& url, std::string& duplicateOf) {
+    std::lock_guard<std::mutex> lock(indexMutex);
+
+    for (int block = 0; block < BLOCKS; ++block) {
+        uint16_t key = static_cast<uint16_t>(fingerprint >> (block * 16));
+        auto it = tables[block].find(key);
+        if (it == tables[block].end()) {
+            continue;
+        }
+        for (uint32_t index : it->second) {
+            if (distance(fingerprints[index], fingerprint) <= maxDistance) {
+                duplicateOf = urls[index];
+                duplicates++;
+                return true;
+            }
+        }
+    }
+
+    if (fingerprints.size() < maxFingerprints) {
+        uint32_t index = static_cast<uint32_t>(fingerprints.size());
+        fingerprints.push_back(fingerprint);
+        urls.push_back(url);
+        for (int block = 0; block < BLOCKS; ++block) {
+            tables[block][static_cast<uint16_t>(fingerprint >> (block * 16))].push_back(index);
+        }
+    }
+    return false;
+}
+
+int NearDuplicateDetector::distance(uint64_t a, uint64_t b) {
+    uint64_t diff = a ^ b;
+    int bits = 0;
+    while (diff) {
+        diff &= diff - 1;
+        bits++;
+    }
+    return bits;
+}
+
+size_t NearDuplicateDetector::getSize() const {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return fingerprints.size();
+}
+
+size_t NearDuplicateDetector::getDuplicates() const {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return duplicates;
+}
@@ -0,0 +1,123 @@
+#include "../include/onnx_backend.hpp"
+#include <onnxruntime_cxx_api.h>
+#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+// Fixed size of the last dimension of a [batch, size] tensor, 0 otherwise
+size_t featureDimension(const Ort::TypeInfo& type) {
+    auto info = type.GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> shape = info.GetShape();
+    if (info.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT || shape.size() != 2 || shape[1] <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(shape[1]);
+}
+
+} // namespace
+
+OnnxBackend::OnnxBackend(const std::string& modelPath)
+    : inputSize(0) {
+    try {
+        env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "webcrawler");
+        Ort::SessionOptions options;
+        options.SetIntraOpNumThreads(1);
+        options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+#ifdef _WIN32
+        std::wstring path(modelPath.begin(), modelPath.end());
+        session = std::make_unique<Ort::Session>(*env, path.c_str(), options);
+#else
+        session = std::make_unique<Ort::Session>(*env, modelPath.c_str(), options);
+#endif
+
+        if (session->GetInputCount() != 1 || session->GetOutputCount() < 1) {
+            error = "expected one input and at least one output";
+            session.reset();
+            return;
+        }
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        inputName = session->GetInputNameAllocated(0, allocator).get();
+        outputName = session->GetOutputNameAllocated(0, allocator).get();
+        inputSize = featureDimension(session->GetInputTypeInfo(0));
+        size_t outputSize = featureDimension(session->GetOutputTypeInfo(0));
+        if (inputSize == 0 || outputSize == 0) {
+            error = "expected float tensors of shape [batch, size] with a fixed size";
+            session.reset();
+            return;
+        }
+
+        std::ifstream labelFile(modelPath + ".labels");
+        std::string label;
+        while (labels.size() < outputSize && std::getline(labelFile, label)) {
+            if (!label.empty() && label.back() == '\r') {
+                label.pop_back();
+            }
+            labels.push_back(label);
+        }
+        while (labels.size() < outputSize) {
+            labels.push_back(std::to_string(labels.size()));
+        }
+    } catch (const Ort::Exception& e) {
+        error = e.what();
+        session.reset();
+    }
+}
+
+OnnxBackend::~OnnxBackend() = default;
+
+bool OnnxBackend::isLoaded() const {
+    return session != nullptr;
+}
+
+const std::string& OnnxBackend::getError() const {
+    return error;
+}
+
+size_t OnnxBackend::getInputSize() const {
+    return inputSize;
+}
+
+const std::vector<std::string>& OnnxBackend::getLabels() const {
+    return labels;
+}
+
+bool OnnxBackend::run(const float* inputs, size_t rows, float* outputs, std::string& error) const {
+    if (!session) {
+        error = "no model loaded";
+        return false;
+    }
+
+    try {
+        // The input tensor wraps the caller's batch without copying it
+        Ort::MemoryInfo memory = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::array<int64_t, 2> shape{static_cast<int64_t>(rows), static_cast<int64_t>(inputSize)};
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory, const_cast<float*>(inputs), rows * inputSize,
+                                                           shape.data(), shape.size());
+
+        const char* inputNames[] = {inputName.c_str()};
+        const char* outputNames[] = {outputName.c_str()};
+        std::vector<Ort::Value> results = session->Run(Ort::RunOptions{nullptr}, inputNames, &input, 1,
+                                                       outputNames, 1);
+
+        auto info = results[0].GetTensorTypeAndShapeInfo();
+        size_t expected = rows * labels.size();
+        if (info.GetElementCount() != expected) {
+            error = "model gave " + std::to_string(info.GetElementCount()) + " scores for " +
+                    std::to_string(expected);
+            return false;
+        }
+        std::memcpy(outputs, results[0].GetTensorData<float>(), expected * sizeof(float));
+        return true;
+    } catch (const Ort::Exception& e) {
+        error = e.what();
+        return false;
+    }
+}
+
+const char* OnnxBackend::getName() const {
+    return "onnx";
+}
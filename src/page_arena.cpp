@@ -0,0 +1,54 @@
+#include "../include/page_arena.hpp"
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+    , allocations(0)
+    , bytes(0) {
+}
+
+size_t CountingResource::getAllocations() const {
+    return allocations;
+}
+
+size_t CountingResource::getBytes() const {
+    return bytes;
+}
+
+void* CountingResource::do_allocate(size_t size, size_t alignment) {
+    void* p = upstream->allocate(size, alignment);
+    allocations++;
+    bytes += size;
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t size, size_t alignment) {
+    upstream->deallocate(p, size, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+PageArena::PageArena(size_t blockSize)
+    : block(new std::byte[blockSize])
+    , blockSize(blockSize)
+    , overflow(std::pmr::new_delete_resource())
+    , arena(block.get(), blockSize, &overflow) {
+}
+
+std::pmr::memory_resource* PageArena::resource() {
+    return &arena;
+}
+
+void PageArena::reset() {
+    // Returns overflow chunks upstream and rewinds to the start of the block
+    arena.release();
+}
+
+size_t PageArena::getOverflowAllocations() const {
+    return overflow.getAllocations();
+}
+
+size_t PageArena::getOverflowBytes() const {
+    return overflow.getBytes();
+}
@@ -0,0 +1,334 @@
+#include "../include/path_filter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+namespace {
+
+// Larger glob sets are simulated instead of compiled
+const size_t MAX_DFA_STATES = 4096;
+
+std::string normalizeExtension(const std::string& extension) {
+    std::string normalized = extension;
+    if (!normalized.empty() && normalized[0] == '.') {
+        normalized.erase(0, 1);
+    }
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return normalized;
+}
+
+} // namespace
+
+GlobSet::GlobSet()
+    : built(false)
+    , useDfa(false)
+    , classCount(1) {
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+}
+
+bool GlobSet::isGlob(std::string_view pattern) {
+    // '?' is left literal, since it usually starts a query ("/search?q=")
+    return pattern.find('*') != std::string_view::npos;
+}
+
+void GlobSet::add(std::string_view glob, uint32_t mask) {
+    starts.push_back(static_cast<uint32_t>(program.size()));
+
+    for (size_t i = 0; i < glob.size(); ++i) {
+        char c = glob[i];
+        if (c == '*') {
+            bool globstar = false;
+            while (i + 1 < glob.size() && glob[i + 1] == '*') {
+                globstar = true;
+                ++i;
+            }
+            program.push_back({globstar ? Op::GLOBSTAR : Op::STAR, 0, 0});
+        } else {
+            program.push_back({Op::CHAR, static_cast<unsigned char>(c), 0});
+        }
+    }
+    program.push_back({Op::ACCEPT, 0, mask});
+    built = false;
+}
+
+void GlobSet::addClosure(uint32_t pc, std::vector<uint32_t>& set) const {
+    if (std::find(set.begin(), set.end(), pc) != set.end()) {
+        return;
+    }
+    set.push_back(pc);
+    if (program[pc].op == Op::STAR || program[pc].op == Op::GLOBSTAR) {
+        addClosure(pc + 1, set);
+    }
+}
+
+void GlobSet::step(const std::vector<uint32_t>& from, unsigned char c, std::vector<uint32_t>& to) const {
+    to.clear();
+    for (uint32_t pc : from) {
+        const Instruction& instruction = program[pc];
+        switch (instruction.op) {
+            case Op::CHAR:
+                if (c == instruction.c) {
+                    addClosure(pc + 1, to);
+                }
+                break;
+            case Op::STAR:
+                if (c != '/') {
+                    addClosure(pc, to);
+                }
+                break;
+            case Op::GLOBSTAR:
+                addClosure(pc, to);
+                break;
+            case Op::ACCEPT:
+                break;
+        }
+    }
+    std::sort(to.begin(), to.end());
+}
+
+uint32_t GlobSet::acceptMask(const std::vector<uint32_t>& set) const {
+    uint32_t mask = 0;
+    for (uint32_t pc : set) {
+        if (program[pc].op == Op::ACCEPT) {
+            mask |= program[pc].mask;
+        }
+    }
+    return mask;
+}
+
+void GlobSet::build() {
+    built = true;
+    useDfa = false;
+    transitions.clear();
+    accepting.clear();
+    classByte.clear();
+    if (starts.empty()) {
+        return;
+    }
+
+    // Bytes named in some glob and '/' each get a class; the rest share class 0
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+    classByte.push_back(0);
+    classCount = 1;
+    byteClass[static_cast<unsigned char>('/')] = static_cast<uint16_t>(classCount++);
+    classByte.push_back('/');
+    for (const auto& instruction : program) {
+        if (instruction.op == Op::CHAR && byteClass[instruction.c] == 0) {
+            byteClass[instruction.c] = static_cast<uint16_t>(classCount++);
+            classByte.push_back(instruction.c);
+        }
+    }
+    for (int c = 1; c < 256; ++c) {
+        if (byteClass[c] == 0) {
+            classByte[0] = static_cast<unsigned char>(c);
+            break;
+        }
+    }
+
+    std::vector<uint32_t> start;
+    for (uint32_t pc : starts) {
+        addClosure(pc, start);
+    }
+    std::sort(start.begin(), start.end());
+
+    // Subset construction; state 0 is the dead state
+    std::map<std::vector<uint32_t>, uint32_t> ids;
+    std::vector<std::vector<uint32_t>> sets;
+    sets.emplace_back();
+    ids[sets[0]] = 0;
+    ids[start] = 1;
+    sets.push_back(start);
+
+    std::vector<uint32_t> next;
+    for (size_t state = 1; state < sets.size(); ++state) {
+        transitions.resize((state + 1) * classCount, 0);
+        for (size_t cls = 0; cls < classCount; ++cls) {
+            step(sets[state], classByte[cls], next);
+            auto it = ids.find(next);
+            uint32_t target;
+            if (it != ids.end()) {
+                target = it->second;
+            } else {
+                if (sets.size() >= MAX_DFA_STATES) {
+                    transitions.clear();
+                    return;
+                }
+                target = static_cast<uint32_t>(sets.size());
+                ids.emplace(next, target);
+                sets.push_back(next);
+            }
+            transitions[state * classCount + cls] = target;
+        }
+    }
+
+    accepting.resize(sets.size());
+    for (size_t state = 0; state < sets.size(); ++state) {
+        accepting[state] = acceptMask(sets[state]);
+    }
+    useDfa = true;
+}
+
+uint32_t GlobSet::match(std::string_view text) const {
+    if (starts.empty()) {
+        return 0;
+    }
+    if (!built || !useDfa) {
+        return simulate(text);
+    }
+
+    uint32_t state = 1;
+    for (char c : text) {
+        state = transitions[state * classCount + byteClass[static_cast<unsigned char>(c)]];
+        if (state == 0) {
+            return 0;
+        }
+    }
+    return accepting[state];
+}
+
+uint32_t GlobSet::simulate(std::string_view text) const {
+    std::vector<uint32_t> current;
+    std::vector<uint32_t> next;
+    for (uint32_t pc : starts) {
+        addClosure(pc, current);
+    }
+    for (char c : text) {
+        step(current, static_cast<unsigned char>(c), next);
+        current.swap(next);
+        if (current.empty()) {
+            return 0;
+        }
+    }
+    return acceptMask(current);
+}
+
+bool GlobSet::empty() const {
+    return starts.empty();
+}
+
+size_t GlobSet::getStateCount() const {
+    return accepting.size();
+}
+
+PathFilter::PathFilter()
+    : hasAllowedPaths(false)
+    , hasExcludedPaths(false) {
+}
+
+PathFilter::PathFilter(const std::vector<std::string>& allowedPaths,
+                       const std::vector<std::string>& excludedPaths,
+                       const std::vector<std::string>& allowedExtensions)
+    : PathFilter() {
+    for (const auto& path : allowedPaths) {
+        addPattern(path, ALLOWED);
+    }
+    for (const auto& path : excludedPaths) {
+        addPattern(path, EXCLUDED);
+    }
+    for (const auto& extension : allowedExtensions) {
+        std::string normalized = normalizeExtension(extension);
+        if (!normalized.empty()) {
+            extensions.insert(normalized);
+        }
+    }
+
+    literals.build();
+    globs.build();
+}
+
+void PathFilter::addPattern(const std::string& pattern, uint32_t mask) {
+    if (pattern.empty()) {
+        return;
+    }
+
+    if (GlobSet::isGlob(pattern)) {
+        globs.add(pattern, mask);
+    } else {
+        literals.add(pattern, static_cast<uint32_t>(literalInfo.size()));
+        literalInfo.push_back({mask, pattern.size(), pattern[0] == '/'});
+    }
+
+    if (mask == ALLOWED) {
+        hasAllowedPaths = true;
+    } else {
+        hasExcludedPaths = true;
+    }
+}
+
+uint32_t PathFilter::matchPath(std::string_view url) const {
+    // Path and query, without scheme, host and fragment
+    size_t schemeEnd = url.find("://");
+    size_t pathStart = url.find_first_of("/?#", schemeEnd == std::string_view::npos ? 0 : schemeEnd + 3);
+    std::string_view target = pathStart == std::string_view::npos ? std::string_view() : url.substr(pathStart);
+    size_t fragment = target.find('#');
+    if (fragment != std::string_view::npos) {
+        target = target.substr(0, fragment);
+    }
+    size_t query = target.find('?');
+    size_t pathLength = query == std::string_view::npos ? target.size() : query;
+    std::string_view path = pathLength == 0 ? std::string_view("/") : target.substr(0, pathLength);
+
+    uint32_t mask = 0;
+    literals.scan(target, [&](uint32_t id, size_t end) {
+        const Literal& literal = literalInfo[id];
+        if (!literal.prefix || end == literal.length) {
+            mask |= literal.mask;
+        }
+        // Nothing can override an exclusion
+        return (mask & EXCLUDED) == 0;
+    });
+    if ((mask & EXCLUDED) == 0) {
+        mask |= globs.match(path);
+    }
+    return mask;
+}
+
+bool PathFilter::isAllowed(std::string_view url) const {
+    if (empty()) {
+        return true;
+    }
+
+    if (hasAllowedPaths || hasExcludedPaths) {
+        uint32_t mask = matchPath(url);
+        if ((mask & EXCLUDED) || (hasAllowedPaths && !(mask & ALLOWED))) {
+            return false;
+        }
+    }
+
+    if (!extensions.empty()) {
+        size_t schemeEnd = url.find("://");
+        size_t pathStart = url.find('/', schemeEnd == std::string_view::npos ? 0 : schemeEnd + 3);
+        if (pathStart == std::string_view::npos) {
+            return true;
+        }
+        size_t pathEnd = url.find_first_of("?#", pathStart);
+        std::string_view path = url.substr(pathStart, pathEnd == std::string_view::npos ? std::string_view::npos
+                                                                                          : pathEnd - pathStart);
+        std::string_view segment = path.substr(path.rfind('/') + 1);
+        size_t dot = segment.rfind('.');
+
+        // Paths without an extension ("/docs/", "/about") are pages
+        if (dot == std::string_view::npos || dot + 1 == segment.size()) {
+            return true;
+        }
+        std::string_view extension = segment.substr(dot + 1);
+        if (extension.size() > 8) {
+            return true;
+        }
+        std::string lowered(extension);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        return extensions.count(lowered) > 0;
+    }
+
+    return true;
+}
+
+bool PathFilter::isExcluded(std::string_view url) const {
+    return hasExcludedPaths && (matchPath(url) & EXCLUDED) != 0;
+}
+
+bool PathFilter::empty() const {
+    return !hasAllowedPaths && !hasExcludedPaths && extensions.empty();
+}
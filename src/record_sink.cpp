@@ -0,0 +1,263 @@
+#include "../include/record_sink.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void appendCsvField(std::string& buffer, const std::string& field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos) {
+        buffer += field;
+        return;
+    }
+    buffer += '"';
+    for (char c : field) {
+        if (c == '"') {
+            buffer += '"';
+        }
+        buffer += c;
+    }
+    buffer += '"';
+}
+
+void appendJsonString(std::string& buffer, const std::string& value) {
+    buffer += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    buffer += escaped;
+                } else {
+                    buffer += c;
+                }
+        }
+    }
+    buffer += '"';
+}
+
+// Integers that JSON and every reader's int64 can represent exactly
+bool isJsonInteger(const std::string& value) {
+    size_t start = !value.empty() && value[0] == '-' ? 1 : 0;
+    size_t digits = value.size() - start;
+    if (digits == 0 || digits > 15 || (value[start] == '0' && digits > 1)) {
+        return false;
+    }
+    for (size_t i = start; i < value.size(); ++i) {
+        if (value[i] < '0' || value[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+RecordSink::RecordSink(const Options& options)
+    : options(options)
+    , head(new Node())
+    , tail(head.load())
+    , pending(0)
+    , stopping(false)
+    , fileOpen(false)
+    , fileBytes(0)
+    , headerBytes(0) {
+    this->options.batchRecords = std::max<size_t>(1, options.batchRecords);
+    if (openFile()) {
+        flusher = std::thread(&RecordSink::flushLoop, this);
+    }
+}
+
+RecordSink::~RecordSink() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+
+    // Records left over when the file could not be opened
+    std::string discarded;
+    drain(discarded);
+    delete tail;
+}
+
+bool RecordSink::isOpen() const {
+    return fileOpen.load(std::memory_order_acquire);
+}
+
+const std::string& RecordSink::getPath() const {
+    return options.path;
+}
+
+RecordSink::Stats RecordSink::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+void RecordSink::write(std::vector<std::string> fields) {
+    Node* node = new Node();
+    node->fields = std::move(fields);
+
+    // Count first, so the flusher never sees more records than pending
+    size_t backlog = pending.fetch_add(1, std::memory_order_relaxed) + 1;
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+
+    // Only the record that completes a batch pays for a wakeup
+    if (backlog == options.batchRecords) {
+        wakeCondition.notify_one();
+    }
+}
+
+size_t RecordSink::drain(std::string& buffer) {
+    size_t count = 0;
+    while (Node* next = tail->next.load(std::memory_order_acquire)) {
+        format(next->fields, buffer);
+        next->fields = std::vector<std::string>();
+        delete tail;
+        tail = next;
+        count++;
+    }
+    pending.fetch_sub(count, std::memory_order_relaxed);
+    return count;
+}
+
+void RecordSink::format(const std::vector<std::string>& fields, std::string& buffer) const {
+    static const std::string empty;
+
+    if (options.format == Format::CSV) {
+        for (size_t i = 0; i < options.columns.size(); ++i) {
+            if (i > 0) {
+                buffer += ',';
+            }
+            appendCsvField(buffer, i < fields.size() ? fields[i] : empty);
+        }
+        buffer += '\n';
+        return;
+    }
+
+    buffer += '{';
+    for (size_t i = 0; i < options.columns.size(); ++i) {
+        if (i > 0) {
+            buffer += ',';
+        }
+        appendJsonString(buffer, options.columns[i]);
+        buffer += ':';
+        const std::string& value = i < fields.size() ? fields[i] : empty;
+        if (isJsonInteger(value)) {
+            buffer += value;
+        } else {
+            appendJsonString(buffer, value);
+        }
+    }
+    buffer += "}\n";
+}
+
+void RecordSink::flushLoop() {
+    std::string buffer;
+    while (true) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, options.flushInterval, [this] {
+                return stopping || pending.load(std::memory_order_relaxed) >= options.batchRecords;
+            });
+            stop = stopping;
+        }
+
+        buffer.clear();
+        size_t count = drain(buffer);
+        if (count > 0) {
+            commit(buffer);
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.records += static_cast<long long>(count);
+        }
+
+        // No records may arrive once destruction has begun
+        if (stop && pending.load(std::memory_order_relaxed) == 0) {
+            break;
+        }
+    }
+    file.close();
+    fileOpen.store(false, std::memory_order_release);
+}
+
+bool RecordSink::openFile() {
+    std::error_code error;
+    uintmax_t size = fs::file_size(options.path, error);
+    fileBytes = error ? 0 : static_cast<uint64_t>(size);
+    headerBytes = 0;
+
+    file.open(options.path, std::ios::binary | std::ios::app);
+    fileOpen.store(file.is_open(), std::memory_order_release);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // The header goes only into files this sink creates
+    if (fileBytes == 0 && options.format == Format::CSV && !options.columns.empty()) {
+        std::string header;
+        for (size_t i = 0; i < options.columns.size(); ++i) {
+            if (i > 0) {
+                header += ',';
+            }
+            appendCsvField(header, options.columns[i]);
+        }
+        header += '\n';
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.flush();
+        fileBytes = header.size();
+        headerBytes = fileBytes;
+    }
+    return true;
+}
+
+void RecordSink::rotate() {
+    file.close();
+
+    fs::path path(options.path);
+    fs::path rotated;
+    for (int n = 1;; ++n) {
+        rotated = path.parent_path() / (path.stem().string() + "." + std::to_string(n) + path.extension().string());
+        if (!fs::exists(rotated)) {
+            break;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(path, rotated, error);
+    if (!openFile()) {
+        // Keep appending to the old file rather than dropping records
+        file.open(error ? options.path : rotated.string(), std::ios::binary | std::ios::app);
+        fileOpen.store(file.is_open(), std::memory_order_release);
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.rotations++;
+}
+
+void RecordSink::commit(const std::string& buffer) {
+    // A batch larger than the rotation size still goes into one file
+    if (options.rotateBytes > 0 && fileBytes > headerBytes && fileBytes + buffer.size() > options.rotateBytes) {
+        rotate();
+    }
+
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    fileBytes += buffer.size();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.bytes += static_cast<long long>(buffer.size());
+    stats.commits++;
+}
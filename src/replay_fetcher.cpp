@@ -0,0 +1,46 @@
+#include "../include/replay_fetcher.hpp"
+
+ReplayFetcher::ReplayFetcher(const std::string& archivePath)
+    : opened(archive.open(archivePath)) {
+}
+
+const char* ReplayFetcher::getName() const {
+    return "replay";
+}
+
+bool ReplayFetcher::isOpen() const {
+    return opened;
+}
+
+const std::string& ReplayFetcher::getError() const {
+    return archive.getError();
+}
+
+size_t ReplayFetcher::size() const {
+    return archive.size();
+}
+
+Fetcher::Result ReplayFetcher::fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) {
+    Result result;
+
+    ResponseArchive::Response response;
+    if (!archive.lookup(request.url, response)) {
+        result.error = "Not in replay archive";
+        return result;
+    }
+
+    result.status = response.status;
+    result.contentType = response.contentType;
+    result.contentLength = response.contentLength;
+    result.wireBytes = static_cast<long long>(response.body.size());
+
+    if (!onHeaders(response.status, response.contentType, response.contentLength)) {
+        return result;
+    }
+    if (!response.body.empty() && !onBody(response.body.data(), response.body.size())) {
+        return result;
+    }
+
+    result.completed = true;
+    return result;
+}
@@ -0,0 +1,436 @@
+#include "../include/response_archive.hpp"
+#include "../include/compression.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::string_view WARC_MAGIC = "WARC/";
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// Calls header(name, value) for each line of a header section and returns
+// the offset just past the blank line that ends it, or npos if there is none
+template <typename Callback>
+size_t parseHeaders(std::string_view text, size_t offset, Callback header) {
+    while (offset < text.size()) {
+        size_t lineEnd = text.find('\n', offset);
+        if (lineEnd == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+        std::string_view line = text.substr(offset, lineEnd - offset);
+        offset = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            return offset;
+        }
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            header(trim(line.substr(0, colon)), trim(line.substr(colon + 1)));
+        }
+    }
+    return std::string_view::npos;
+}
+
+bool decodeChunked(std::string_view input, std::string& output) {
+    output.clear();
+    size_t offset = 0;
+    while (offset < input.size()) {
+        size_t lineEnd = input.find('\n', offset);
+        if (lineEnd == std::string_view::npos) {
+            return false;
+        }
+        char* end = nullptr;
+        std::string sizeLine(input.substr(offset, lineEnd - offset));
+        unsigned long long chunkSize = std::strtoull(sizeLine.c_str(), &end, 16);
+        if (end == sizeLine.c_str()) {
+            return false;
+        }
+        offset = lineEnd + 1;
+        if (chunkSize == 0) {
+            return true;
+        }
+        if (chunkSize > input.size() - offset) {
+            return false;
+        }
+        output.append(input.data() + offset, static_cast<size_t>(chunkSize));
+        offset += static_cast<size_t>(chunkSize);
+        // CRLF after the chunk data
+        while (offset < input.size() && (input[offset] == '\r' || input[offset] == '\n')) {
+            offset++;
+        }
+    }
+    // Archives cut off mid-stream keep what was received
+    return true;
+}
+
+std::string utcTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+const char* reasonPhrase(long status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 410: return "Gone";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+} // namespace
+
+ResponseArchive::ResponseArchive()
+    : data(nullptr)
+    , dataSize(0)
+#ifdef _WIN32
+    , fileHandle(INVALID_HANDLE_VALUE)
+    , mappingHandle(nullptr)
+#else
+    , fd(-1)
+#endif
+{
+}
+
+ResponseArchive::~ResponseArchive() {
+    unmap();
+}
+
+void ResponseArchive::unmap() {
+    index.clear();
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+#else
+    if (data && dataSize > 0) {
+        munmap(const_cast<char*>(data), dataSize);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+    fd = -1;
+#endif
+    data = nullptr;
+    dataSize = 0;
+}
+
+bool ResponseArchive::open(const std::string& path) {
+    unmap();
+    error.clear();
+
+    std::error_code sizeError;
+    uintmax_t fileSize = std::filesystem::file_size(path, sizeError);
+    if (sizeError) {
+        error = "Cannot open " + path + ": " + sizeError.message();
+        return false;
+    }
+    if (fileSize == 0) {
+        // An empty archive is valid and holds nothing
+        return true;
+    }
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        view = nullptr;
+    }
+#endif
+    if (!view) {
+        error = "Cannot map " + path;
+        unmap();
+        return false;
+    }
+    data = static_cast<const char*>(view);
+    dataSize = static_cast<size_t>(fileSize);
+
+    if (!buildIndex()) {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+bool ResponseArchive::buildIndex() {
+    std::string_view text(data, dataSize);
+    size_t offset = 0;
+
+    while (offset < text.size()) {
+        // Records are separated by blank lines
+        while (offset < text.size() && (text[offset] == '\r' || text[offset] == '\n')) {
+            offset++;
+        }
+        if (offset >= text.size()) {
+            break;
+        }
+        if (text.compare(offset, WARC_MAGIC.size(), WARC_MAGIC) != 0) {
+            error = "Not a WARC record at offset " + std::to_string(offset) +
+                    (offset == 0 ? " (.warc.gz archives must be decompressed first)" : "");
+            return false;
+        }
+
+        size_t lineEnd = text.find('\n', offset);
+        if (lineEnd == std::string_view::npos) {
+            break;
+        }
+
+        std::string_view type;
+        std::string_view targetUri;
+        long long length = -1;
+        size_t blockStart = parseHeaders(text, lineEnd + 1, [&](std::string_view name, std::string_view value) {
+            if (equalsIgnoreCase(name, "WARC-Type")) {
+                type = value;
+            } else if (equalsIgnoreCase(name, "WARC-Target-URI")) {
+                targetUri = value;
+            } else if (equalsIgnoreCase(name, "Content-Length")) {
+                length = std::strtoll(std::string(value).c_str(), nullptr, 10);
+            }
+        });
+        if (blockStart == std::string_view::npos || length < 0) {
+            error = "Truncated WARC header at offset " + std::to_string(offset);
+            return false;
+        }
+
+        // A record cut off by an interrupted recording ends the archive
+        size_t blockLength = static_cast<size_t>(length);
+        if (blockLength > text.size() - blockStart) {
+            break;
+        }
+
+        if (type == "response" && !targetUri.empty()) {
+            // Early WARC drafts wrapped the URI in angle brackets
+            if (targetUri.size() >= 2 && targetUri.front() == '<' && targetUri.back() == '>') {
+                targetUri = targetUri.substr(1, targetUri.size() - 2);
+            }
+            index[targetUri] = Record{blockStart, blockLength};
+        }
+
+        offset = blockStart + blockLength;
+    }
+
+    return true;
+}
+
+bool ResponseArchive::lookup(const std::string& url, Response& response) const {
+    auto it = index.find(url);
+    if (it == index.end()) {
+        return false;
+    }
+
+    std::string_view block(data + it->second.offset, it->second.length);
+    if (block.compare(0, 5, "HTTP/") != 0) {
+        return false;
+    }
+    size_t space = block.find(' ');
+    if (space == std::string_view::npos) {
+        return false;
+    }
+    response.status = std::strtol(std::string(block.substr(space + 1, 3)).c_str(), nullptr, 10);
+    response.contentType.clear();
+    response.contentLength = -1;
+
+    bool chunked = false;
+    bool gzipped = false;
+    size_t bodyStart = parseHeaders(block, block.find('\n') + 1, [&](std::string_view name, std::string_view value) {
+        if (equalsIgnoreCase(name, "Content-Type")) {
+            response.contentType.assign(value);
+        } else if (equalsIgnoreCase(name, "Content-Length")) {
+            response.contentLength = std::strtoll(std::string(value).c_str(), nullptr, 10);
+        } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+            chunked = equalsIgnoreCase(value, "chunked");
+        } else if (equalsIgnoreCase(name, "Content-Encoding")) {
+            gzipped = equalsIgnoreCase(value, "gzip") || equalsIgnoreCase(value, "x-gzip");
+        }
+    });
+    if (bodyStart == std::string_view::npos) {
+        return false;
+    }
+    std::string_view body = block.substr(bodyStart);
+
+    std::string dechunked;
+    if (chunked) {
+        if (!decodeChunked(body, dechunked)) {
+            return false;
+        }
+        body = dechunked;
+    }
+
+    response.body.clear();
+    if (gzipped) {
+        GzipInflater inflater([&response](const char* chunk, size_t size) {
+            response.body.append(chunk, size);
+            return true;
+        });
+        if (!inflater.feed(body.data(), body.size()) || !inflater.finish()) {
+            return false;
+        }
+    } else {
+        response.body.assign(body.data(), body.size());
+    }
+    return true;
+}
+
+size_t ResponseArchive::size() const {
+    return index.size();
+}
+
+const std::string& ResponseArchive::getError() const {
+    return error;
+}
+
+ResponseArchiveWriter::ResponseArchiveWriter(const std::string& path)
+    : random(std::random_device{}())
+    , records(0) {
+    std::error_code ignored;
+    bool isNew = !std::filesystem::exists(path, ignored) || std::filesystem::file_size(path, ignored) == 0;
+
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ignored);
+    }
+
+    file.open(path, std::ios::out | std::ios::binary | std::ios::app);
+    if (file.is_open() && isNew) {
+        writeRecord("warcinfo", "", "application/warc-fields",
+                    "software: Multi-Threaded-Web-Crawler/1.0\r\nformat: WARC File Format 1.0\r\n");
+        file.flush();
+    }
+}
+
+bool ResponseArchiveWriter::isOpen() const {
+    return file.is_open();
+}
+
+bool ResponseArchiveWriter::record(const std::string& url, long status, const std::string& contentType,
+                                   long long contentLength, const std::string& body) {
+    std::string block;
+    block.reserve(body.size() + 256);
+    block += "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status) + "\r\n";
+    if (!contentType.empty()) {
+        block += "Content-Type: " + contentType + "\r\n";
+    }
+    block += "Content-Length: " + std::to_string(contentLength >= 0 ? contentLength
+                                                                     : static_cast<long long>(body.size())) + "\r\n";
+    block += "\r\n";
+    block += body;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeRecord("response", url, "application/http; msgtype=response", block);
+    file.flush();
+    records++;
+    return file.good();
+}
+
+size_t ResponseArchiveWriter::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+void ResponseArchiveWriter::writeRecord(const std::string& type, const std::string& targetUri,
+                                        const std::string& contentType, const std::string& block) {
+    file << "WARC/1.0\r\n"
+         << "WARC-Type: " << type << "\r\n"
+         << "WARC-Record-ID: " << makeRecordId() << "\r\n"
+         << "WARC-Date: " << utcTimestamp() << "\r\n";
+    if (!targetUri.empty()) {
+        file << "WARC-Target-URI: " << targetUri << "\r\n";
+    }
+    file << "Content-Type: " << contentType << "\r\n"
+         << "Content-Length: " << block.size() << "\r\n"
+         << "\r\n";
+    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+    file << "\r\n\r\n";
+}
+
+std::string ResponseArchiveWriter::makeRecordId() {
+    // Random (version 4) UUID
+    uint64_t high = random();
+    uint64_t low = random();
+    high = (high & 0xffffffffffff0fffULL) | 0x0000000000004000ULL;
+    low = (low & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "<urn:uuid:%08x-%04x-%04x-%04x-%012llx>",
+                  static_cast<unsigned>(high >> 32), static_cast<unsigned>((high >> 16) & 0xffff),
+                  static_cast<unsigned>(high & 0xffff), static_cast<unsigned>(low >> 48),
+                  static_cast<unsigned long long>(low & 0xffffffffffffULL));
+    return buffer;
+}
@@ -0,0 +1,188 @@
+#include "../include/robots_cache.hpp"
+#include <algorithm>
+#include <cctype>
+
+RobotsCache::RobotsCache(const std::string& userAgent, FetchFunction fetch,
+                         size_t fetchThreads, size_t capacity,
+                         std::chrono::seconds ttl, std::chrono::seconds errorTtl)
+    : userAgent(userAgent)
+    , fetch(std::move(fetch))
+    , capacity(capacity > 0 ? capacity : 1)
+    , ttl(ttl)
+    , errorTtl(errorTtl)
+    , stopping(false)
+    , hits(0)
+    , misses(0) {
+    for (size_t i = 0; i < std::max<size_t>(fetchThreads, 1); ++i) {
+        fetchers.emplace_back(&RobotsCache::fetchThread, this);
+    }
+}
+
+RobotsCache::~RobotsCache() {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        stopping = true;
+    }
+    pendingCondition.notify_all();
+
+    for (auto& thread : fetchers) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+RobotsCache::Verdict RobotsCache::check(const std::string& url, VerdictCallback onReady) {
+    std::string origin = getOrigin(url);
+    if (origin.empty()) {
+        return Verdict::ALLOWED;
+    }
+
+    std::shared_ptr<const RobotsRules> rules;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        auto it = entries.find(origin);
+        if (it != entries.end() && it->second.expires > std::chrono::steady_clock::now()) {
+            lru.splice(lru.begin(), lru, it->second.lruPosition);
+            rules = it->second.rules;
+        } else {
+            misses++;
+            auto flight = inFlight.find(origin);
+            if (flight == inFlight.end()) {
+                flight = inFlight.emplace(origin, std::vector<Waiter>()).first;
+                pending.push_back(origin);
+                pendingCondition.notify_one();
+            }
+            if (onReady) {
+                flight->second.push_back(Waiter{url, std::move(onReady)});
+            }
+            return Verdict::PENDING;
+        }
+    }
+
+    hits++;
+    return rules->isUrlAllowed(url) ? Verdict::ALLOWED : Verdict::DISALLOWED;
+}
+
+std::shared_ptr<const RobotsRules> RobotsCache::getRules(const std::string& url) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = entries.find(getOrigin(url));
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    return it->second.rules;
+}
+
+void RobotsCache::fetchThread() {
+    while (true) {
+        std::string origin;
+        {
+            std::unique_lock<std::mutex> lock(cacheMutex);
+            pendingCondition.wait(lock, [this] {
+                return stopping || !pending.empty();
+            });
+            if (stopping) {
+                return;
+            }
+            origin = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        fetchOrigin(origin);
+    }
+}
+
+void RobotsCache::fetchOrigin(const std::string& origin) {
+    long status = 0;
+    std::string body;
+    bool reachable = fetch && fetch(origin + "/robots.txt", status, body);
+
+    std::shared_ptr<const RobotsRules> rules;
+    std::chrono::seconds lifetime = ttl;
+    if (reachable && status >= 200 && status < 300) {
+        rules = RobotsRules::parse(body, userAgent);
+    } else if (reachable && status >= 400 && status < 500) {
+        rules = RobotsRules::allowAll();
+    } else {
+        rules = RobotsRules::disallowAll();
+        lifetime = errorTtl;
+    }
+
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        insertLocked(origin, rules, lifetime);
+        auto flight = inFlight.find(origin);
+        if (flight != inFlight.end()) {
+            waiters = std::move(flight->second);
+            inFlight.erase(flight);
+        }
+    }
+
+    // Callbacks run without the cache lock so they may call back into it
+    for (auto& waiter : waiters) {
+        waiter.callback(waiter.url, rules->isUrlAllowed(waiter.url));
+    }
+}
+
+void RobotsCache::insertLocked(const std::string& origin, std::shared_ptr<const RobotsRules> rules,
+                               std::chrono::seconds lifetime) {
+    auto it = entries.find(origin);
+    if (it != entries.end()) {
+        lru.erase(it->second.lruPosition);
+        entries.erase(it);
+    }
+
+    while (entries.size() >= capacity && !lru.empty()) {
+        entries.erase(lru.back());
+        lru.pop_back();
+    }
+
+    lru.push_front(origin);
+    Entry entry;
+    entry.rules = std::move(rules);
+    entry.expires = std::chrono::steady_clock::now() + lifetime;
+    entry.lruPosition = lru.begin();
+    entries.emplace(origin, std::move(entry));
+}
+
+std::string RobotsCache::getOrigin(const std::string& url) {
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string::npos) {
+        return "";
+    }
+
+    size_t start = schemeEnd + 3;
+    size_t end = url.find_first_of("/?#", start);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+
+    // Credentials are not part of the origin
+    size_t at = url.rfind('@', end);
+    if (at != std::string::npos && at >= start) {
+        start = at + 1;
+    }
+    if (start == end) {
+        return "";
+    }
+
+    std::string origin = url.substr(0, schemeEnd + 3) + url.substr(start, end - start);
+    std::transform(origin.begin(), origin.end(), origin.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return origin;
+}
+
+size_t RobotsCache::getHits() const {
+    return hits;
+}
+
+size_t RobotsCache::getMisses() const {
+    return misses;
+}
+
+size_t RobotsCache::getSize() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
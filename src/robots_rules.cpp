@@ -0,0 +1,327 @@
+#include "../include/robots_rules.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <utility>
+
+struct RobotsRules::Node {
+    std::vector<std::pair<char, std::unique_ptr<Node>>> children;
+    Node* star = nullptr;       // Child reached through '*'
+    bool isStar = false;        // Node is the target of a '*' edge
+
+    // Longest pattern ending here; -1 if none
+    int allowLength = -1;
+    int disallowLength = -1;
+    int anchoredAllowLength = -1;
+    int anchoredDisallowLength = -1;
+
+    Node* child(char c) const {
+        for (const auto& entry : children) {
+            if (entry.first == c) {
+                return entry.second.get();
+            }
+        }
+        return nullptr;
+    }
+};
+
+namespace {
+
+struct Group {
+    std::vector<std::string> agents;
+    std::vector<std::pair<bool, std::string>> rules;
+    int crawlDelay = -1;
+};
+
+std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(start, end - start + 1);
+}
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return value;
+}
+
+// Product tokens of a User-Agent header ("Mozilla/5.0 Foo-Bot/1.0" -> "foo-bot")
+std::vector<std::string> productTokens(const std::string& userAgent) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (size_t i = 0; i <= userAgent.size(); ++i) {
+        char c = i < userAgent.size() ? userAgent[i] : ' ';
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '-' || c == '_') {
+            current += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            continue;
+        }
+        if (!current.empty() && current != "mozilla" && current != "compatible") {
+            tokens.push_back(current);
+        }
+        current.clear();
+        // Skip version numbers and comments attached to the token
+        if (c == '/') {
+            while (i + 1 < userAgent.size() && userAgent[i + 1] != ' ') {
+                ++i;
+            }
+        }
+    }
+    return tokens;
+}
+
+struct Best {
+    int length = -1;
+    bool allow = true;
+
+    void offer(int candidate, bool candidateAllow) {
+        if (candidate > length || (candidate == length && candidateAllow)) {
+            length = candidate;
+            allow = candidateAllow;
+        }
+    }
+};
+
+} // namespace
+
+RobotsRules::RobotsRules()
+    : root(new Node())
+    , ruleCount(0)
+    , crawlDelay(0) {
+}
+
+RobotsRules::~RobotsRules() = default;
+
+std::shared_ptr<RobotsRules> RobotsRules::parse(const std::string& content, const std::string& userAgent) {
+    auto rules = std::make_shared<RobotsRules>();
+
+    std::vector<Group> groups;
+    bool lastWasAgent = false;
+
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = content.find_first_of("\r\n", pos);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+        std::string line = content.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) {
+            line.resize(hash);
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+
+        std::string key = toLower(trim(line.substr(0, colon)));
+        std::string value = trim(line.substr(colon + 1));
+
+        if (key == "user-agent") {
+            // Consecutive user-agent lines share the rules that follow them
+            if (!lastWasAgent || groups.empty()) {
+                groups.emplace_back();
+            }
+            groups.back().agents.push_back(toLower(value));
+            lastWasAgent = true;
+        } else if (key == "allow" || key == "disallow") {
+            if (!groups.empty()) {
+                groups.back().rules.emplace_back(key == "allow", value);
+            }
+            lastWasAgent = false;
+        } else if (key == "crawl-delay") {
+            if (!groups.empty()) {
+                groups.back().crawlDelay = std::atoi(value.c_str());
+            }
+            lastWasAgent = false;
+        } else if (key == "sitemap") {
+            // Sitemap lines are global and do not end a group
+            if (!value.empty()) {
+                rules->sitemaps.push_back(value);
+            }
+        }
+    }
+
+    // Prefer groups naming one of our product tokens; fall back to "*"
+    std::vector<std::string> tokens = productTokens(userAgent);
+    std::vector<const Group*> selected;
+    for (const auto& group : groups) {
+        for (const auto& agent : group.agents) {
+            if (std::find(tokens.begin(), tokens.end(), agent) != tokens.end()) {
+                selected.push_back(&group);
+                break;
+            }
+        }
+    }
+    if (selected.empty()) {
+        for (const auto& group : groups) {
+            if (std::find(group.agents.begin(), group.agents.end(), "*") != group.agents.end()) {
+                selected.push_back(&group);
+            }
+        }
+    }
+
+    for (const Group* group : selected) {
+        for (const auto& rule : group->rules) {
+            // An empty pattern matches nothing
+            if (!rule.second.empty()) {
+                rules->addPattern(rule.second, rule.first);
+            }
+        }
+        if (group->crawlDelay > rules->crawlDelay) {
+            rules->crawlDelay = group->crawlDelay;
+        }
+    }
+
+    return rules;
+}
+
+std::shared_ptr<RobotsRules> RobotsRules::allowAll() {
+    return std::make_shared<RobotsRules>();
+}
+
+std::shared_ptr<RobotsRules> RobotsRules::disallowAll() {
+    auto rules = std::make_shared<RobotsRules>();
+    rules->addPattern("/", false);
+    return rules;
+}
+
+void RobotsRules::addPattern(const std::string& pattern, bool allow) {
+    std::string body = pattern;
+    bool anchored = !body.empty() && body.back() == '$';
+    if (anchored) {
+        body.pop_back();
+    }
+
+    Node* node = root.get();
+    char previous = 0;
+    for (char c : body) {
+        // "**" is the same as "*"
+        if (c == '*' && previous == '*') {
+            continue;
+        }
+        previous = c;
+
+        if (c == '*') {
+            if (!node->star) {
+                node->children.emplace_back('*', std::unique_ptr<Node>(new Node()));
+                node->star = node->children.back().second.get();
+                node->star->isStar = true;
+            }
+            node = node->star;
+            continue;
+        }
+
+        Node* next = node->child(c);
+        if (!next) {
+            node->children.emplace_back(c, std::unique_ptr<Node>(new Node()));
+            next = node->children.back().second.get();
+        }
+        node = next;
+    }
+
+    int length = static_cast<int>(pattern.size());
+    int& slot = anchored ? (allow ? node->anchoredAllowLength : node->anchoredDisallowLength)
+                         : (allow ? node->allowLength : node->disallowLength);
+    slot = std::max(slot, length);
+    ruleCount++;
+}
+
+bool RobotsRules::isAllowed(const std::string& path) const {
+    if (ruleCount == 0) {
+        return true;
+    }
+
+    // "/robots.txt" itself is always allowed
+    if (path == "/robots.txt") {
+        return true;
+    }
+
+    Best best;
+    std::vector<const Node*> active;
+    std::vector<const Node*> next;
+
+    // Add a state together with the states reachable through empty '*' runs
+    auto addState = [&best](std::vector<const Node*>& states, const Node* node) {
+        while (node) {
+            if (std::find(states.begin(), states.end(), node) != states.end()) {
+                return;
+            }
+            states.push_back(node);
+            if (node->allowLength >= 0) {
+                best.offer(node->allowLength, true);
+            }
+            if (node->disallowLength >= 0) {
+                best.offer(node->disallowLength, false);
+            }
+            node = node->star;
+        }
+    };
+
+    addState(active, root.get());
+
+    for (char c : path) {
+        next.clear();
+        for (const Node* node : active) {
+            if (node->isStar) {
+                addState(next, node);
+            }
+            if (c != '*') {
+                if (const Node* child = node->child(c)) {
+                    addState(next, child);
+                }
+            }
+        }
+        active.swap(next);
+        if (active.empty()) {
+            break;
+        }
+    }
+
+    // '$' patterns only match when the whole path was consumed
+    for (const Node* node : active) {
+        if (node->anchoredAllowLength >= 0) {
+            best.offer(node->anchoredAllowLength, true);
+        }
+        if (node->anchoredDisallowLength >= 0) {
+            best.offer(node->anchoredDisallowLength, false);
+        }
+    }
+
+    return best.allow;
+}
+
+bool RobotsRules::isUrlAllowed(const std::string& url) const {
+    return isAllowed(extractPath(url));
+}
+
+int RobotsRules::getCrawlDelay() const {
+    return crawlDelay;
+}
+
+const std::vector<std::string>& RobotsRules::getSitemaps() const {
+    return sitemaps;
+}
+
+size_t RobotsRules::getRuleCount() const {
+    return ruleCount;
+}
+
+std::string RobotsRules::extractPath(const std::string& url) {
+    size_t schemeEnd = url.find("://");
+    size_t start = url.find_first_of("/?#", schemeEnd == std::string::npos ? 0 : schemeEnd + 3);
+    if (start == std::string::npos || url[start] == '#') {
+        return "/";
+    }
+
+    size_t end = url.find('#', start);
+    std::string path = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    if (path[0] == '?') {
+        path.insert(path.begin(), '/');
+    }
+    return path;
+}
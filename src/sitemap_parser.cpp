@@ -0,0 +1,439 @@
+#include "../include/sitemap_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(start, end - start + 1);
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+long long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+bool readNumber(const std::string& value, size_t& pos, size_t digits, int& out) {
+    if (pos + digits > value.size()) {
+        return false;
+    }
+    out = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        char c = value[pos + i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        out = out * 10 + (c - '0');
+    }
+    pos += digits;
+    return true;
+}
+
+} // namespace
+
+SitemapParser::SitemapParser(EntryCallback onUrl, EntryCallback onSitemap)
+    : onUrl(std::move(onUrl))
+    , onSitemap(std::move(onSitemap)) {
+    reset();
+}
+
+void SitemapParser::reset() {
+    state = State::START;
+    tag.clear();
+    text.clear();
+    quote = 0;
+    pending = 0;
+    depth = 0;
+    entryDepth = -1;
+    entryIsSitemap = false;
+    field = Field::NONE;
+    current = Entry();
+    index = false;
+    urlCount = 0;
+    sitemapCount = 0;
+}
+
+void SitemapParser::feed(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        char c = data[i];
+
+        switch (state) {
+            case State::START:
+                // Skip leading whitespace and a UTF-8 byte order mark
+                if (isSpace(c) || static_cast<unsigned char>(c) >= 0x80) {
+                    ++i;
+                } else {
+                    state = (c == '<') ? State::TEXT : State::PLAIN;
+                }
+                break;
+
+            case State::TEXT: {
+                const char* lt = static_cast<const char*>(std::memchr(data + i, '<', size - i));
+                size_t end = lt ? static_cast<size_t>(lt - data) : size;
+                handleText(data + i, end - i);
+                i = end;
+                if (lt) {
+                    state = State::TAG;
+                    tag.clear();
+                    quote = 0;
+                    ++i;
+                }
+                break;
+            }
+
+            case State::TAG:
+                ++i;
+                if (quote) {
+                    if (c == quote) {
+                        quote = 0;
+                    }
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    handleTag();
+                    state = State::TEXT;
+                    break;
+                }
+                if (tag.size() < MAX_TAG_LENGTH) {
+                    tag += c;
+                }
+                if (tag == "!--") {
+                    state = State::COMMENT;
+                    pending = 0;
+                } else if (tag == "![CDATA[") {
+                    state = State::CDATA;
+                    pending = 0;
+                }
+                break;
+
+            case State::COMMENT:
+                ++i;
+                if (c == '>' && pending >= 2) {
+                    state = State::TEXT;
+                } else {
+                    pending = (c == '-') ? pending + 1 : 0;
+                }
+                break;
+
+            case State::CDATA:
+                ++i;
+                if (c == ']') {
+                    if (pending == 2) {
+                        handleText("]", 1);
+                    } else {
+                        pending++;
+                    }
+                } else if (c == '>' && pending == 2) {
+                    state = State::TEXT;
+                    pending = 0;
+                } else {
+                    handleText("]]", static_cast<size_t>(pending));
+                    pending = 0;
+                    handleText(&c, 1);
+                }
+                break;
+
+            case State::PLAIN:
+                ++i;
+                if (c == '\n') {
+                    finishPlainLine();
+                } else if (text.size() < MAX_FIELD_LENGTH) {
+                    text += c;
+                }
+                break;
+        }
+    }
+}
+
+void SitemapParser::finish() {
+    if (state == State::PLAIN) {
+        finishPlainLine();
+    }
+}
+
+void SitemapParser::handleTag() {
+    if (tag.empty() || tag[0] == '?' || tag[0] == '!') {
+        return;
+    }
+
+    bool closing = tag[0] == '/';
+    bool selfClosing = tag.back() == '/';
+
+    size_t start = closing ? 1 : 0;
+    size_t end = start;
+    while (end < tag.size() && !isSpace(tag[end]) && tag[end] != '/') {
+        ++end;
+    }
+    std::string name = tag.substr(start, end - start);
+
+    // Sitemaps are sometimes written with a namespace prefix ("sm:url")
+    size_t colon = name.find(':');
+    if (colon != std::string::npos) {
+        name = name.substr(colon + 1);
+    }
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char ch) { return std::tolower(ch); });
+
+    if (closing) {
+        if (field != Field::NONE && depth == entryDepth + 1) {
+            finishField();
+        }
+        if (entryDepth >= 0 && depth == entryDepth) {
+            emitEntry(entryIsSitemap);
+            entryDepth = -1;
+        }
+        if (depth > 0) {
+            depth--;
+        }
+        return;
+    }
+
+    if (selfClosing) {
+        return;
+    }
+    depth++;
+
+    if (name == "sitemapindex") {
+        index = true;
+    }
+
+    if (entryDepth < 0) {
+        if (name == "url" || name == "sitemap") {
+            entryDepth = depth;
+            entryIsSitemap = name == "sitemap";
+            current = Entry();
+            current.lastModified = 0;
+            current.priority = 0.5f;
+        }
+        return;
+    }
+
+    // Only direct children count; <image:loc> and friends are nested deeper
+    if (depth == entryDepth + 1) {
+        text.clear();
+        if (name == "loc") {
+            field = Field::LOC;
+        } else if (name == "lastmod") {
+            field = Field::LASTMOD;
+        } else if (name == "priority") {
+            field = Field::PRIORITY;
+        } else if (name == "changefreq") {
+            field = Field::CHANGEFREQ;
+        } else {
+            field = Field::NONE;
+        }
+    }
+}
+
+void SitemapParser::handleText(const char* data, size_t size) {
+    if (field == Field::NONE || size == 0) {
+        return;
+    }
+    size_t room = MAX_FIELD_LENGTH > text.size() ? MAX_FIELD_LENGTH - text.size() : 0;
+    text.append(data, std::min(size, room));
+}
+
+void SitemapParser::finishField() {
+    std::string value = trim(decodeEntities(text));
+    text.clear();
+
+    switch (field) {
+        case Field::LOC:
+            current.loc = value;
+            break;
+        case Field::LASTMOD:
+            current.lastmod = value;
+            current.lastModified = parseW3cDateTime(value);
+            break;
+        case Field::PRIORITY: {
+            float priority = static_cast<float>(std::atof(value.c_str()));
+            current.priority = std::max(0.0f, std::min(1.0f, priority));
+            break;
+        }
+        case Field::CHANGEFREQ:
+            current.changeFrequency = value;
+            break;
+        case Field::NONE:
+            break;
+    }
+    field = Field::NONE;
+}
+
+void SitemapParser::finishPlainLine() {
+    std::string line = trim(text);
+    text.clear();
+
+    if (line.compare(0, 7, "http://") == 0 || line.compare(0, 8, "https://") == 0) {
+        current = Entry();
+        current.loc = line;
+        current.lastModified = 0;
+        current.priority = 0.5f;
+        emitEntry(false);
+    }
+}
+
+void SitemapParser::emitEntry(bool sitemap) {
+    if (current.loc.empty()) {
+        return;
+    }
+
+    if (sitemap) {
+        sitemapCount++;
+        if (onSitemap) {
+            onSitemap(current);
+        }
+    } else {
+        urlCount++;
+        if (onUrl) {
+            onUrl(current);
+        }
+    }
+}
+
+bool SitemapParser::isIndex() const {
+    return index;
+}
+
+size_t SitemapParser::getUrlCount() const {
+    return urlCount;
+}
+
+size_t SitemapParser::getSitemapCount() const {
+    return sitemapCount;
+}
+
+std::string SitemapParser::decodeEntities(const std::string& text) {
+    if (text.find('&') == std::string::npos) {
+        return text;
+    }
+
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '&') {
+            decoded += text[i];
+            continue;
+        }
+
+        size_t semicolon = text.find(';', i);
+        if (semicolon == std::string::npos || semicolon - i > 10) {
+            decoded += text[i];
+            continue;
+        }
+
+        std::string entity = text.substr(i + 1, semicolon - i - 1);
+        if (entity == "amp") {
+            decoded += '&';
+        } else if (entity == "lt") {
+            decoded += '<';
+        } else if (entity == "gt") {
+            decoded += '>';
+        } else if (entity == "quot") {
+            decoded += '"';
+        } else if (entity == "apos") {
+            decoded += '\'';
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            long code = (entity[1] == 'x' || entity[1] == 'X')
+                ? std::strtol(entity.c_str() + 2, nullptr, 16)
+                : std::strtol(entity.c_str() + 1, nullptr, 10);
+            // URLs are ASCII; anything else is left percent-encoded by the site
+            if (code > 0 && code < 0x80) {
+                decoded += static_cast<char>(code);
+            }
+        } else {
+            decoded += text.substr(i, semicolon - i + 1);
+        }
+        i = semicolon;
+    }
+    return decoded;
+}
+
+std::time_t SitemapParser::parseW3cDateTime(const std::string& value) {
+    size_t pos = 0;
+    int year = 0;
+    int month = 1;
+    int day = 1;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+
+    if (!readNumber(value, pos, 4, year)) {
+        return 0;
+    }
+    if (pos < value.size() && value[pos] == '-') {
+        ++pos;
+        if (!readNumber(value, pos, 2, month)) {
+            return 0;
+        }
+        if (pos < value.size() && value[pos] == '-') {
+            ++pos;
+            if (!readNumber(value, pos, 2, day)) {
+                return 0;
+            }
+        }
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+
+    long long offsetSeconds = 0;
+    if (pos < value.size() && (value[pos] == 'T' || value[pos] == 't')) {
+        ++pos;
+        if (!readNumber(value, pos, 2, hour) || pos >= value.size() || value[pos] != ':') {
+            return 0;
+        }
+        ++pos;
+        if (!readNumber(value, pos, 2, minute)) {
+            return 0;
+        }
+        if (pos < value.size() && value[pos] == ':') {
+            ++pos;
+            if (!readNumber(value, pos, 2, second)) {
+                return 0;
+            }
+            // Fractional seconds are ignored
+            if (pos < value.size() && value[pos] == '.') {
+                ++pos;
+                while (pos < value.size() && std::isdigit(static_cast<unsigned char>(value[pos]))) {
+                    ++pos;
+                }
+            }
+        }
+
+        if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+            int sign = value[pos] == '-' ? -1 : 1;
+            int offsetHours = 0;
+            int offsetMinutes = 0;
+            ++pos;
+            if (!readNumber(value, pos, 2, offsetHours)) {
+                return 0;
+            }
+            if (pos < value.size() && value[pos] == ':') {
+                ++pos;
+            }
+            readNumber(value, pos, 2, offsetMinutes);
+            offsetSeconds = sign * (offsetHours * 3600LL + offsetMinutes * 60LL);
+        }
+    }
+
+    long long seconds = daysFromCivil(year, month, day) * 86400LL +
+                        hour * 3600LL + minute * 60LL + second - offsetSeconds;
+    return seconds > 0 ? static_cast<std::time_t>(seconds) : 0;
+}
@@ -0,0 +1,162 @@
+#include "../include/synthetic_fetcher.hpp"
+
+namespace {
+
+// Redirect hops followed before giving up, like a browser's loop guard
+const int MAX_REDIRECTS = 5;
+
+// Split an absolute URL into its origin and its path and query
+void SplitUrl(const std::string& url, std::string& origin, std::string& target) {
+    size_t scheme = url.find("://");
+    size_t hostStart = scheme == std::string::npos ? 0 : scheme + 3;
+    size_t pathStart = url.find('/', hostStart);
+    if (pathStart == std::string::npos) {
+        origin = url;
+        target = "/";
+    } else {
+        origin = url.substr(0, pathStart);
+        target = url.substr(pathStart);
+    }
+
+    size_t fragment = target.find('#');
+    if (fragment != std::string::npos) {
+        target.erase(fragment);
+    }
+}
+
+} // namespace
+
+SyntheticFetcher::SyntheticFetcher(const SyntheticWeb::Options& options)
+    : web(options)
+    , nextSequence(0)
+    , stopping(false) {
+}
+
+SyntheticFetcher::~SyntheticFetcher() {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        stopping = true;
+    }
+    timerCondition.notify_all();
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+}
+
+const char* SyntheticFetcher::getName() const {
+    return "synthetic";
+}
+
+SyntheticWeb::Response SyntheticFetcher::respond(const Request& request) const {
+    std::string origin;
+    std::string target;
+    SplitUrl(request.url, origin, target);
+
+    // Bodies are handed over decoded, so there is nothing to gain from gzip
+    SyntheticWeb::Response response = web.respond(target, false);
+    std::chrono::microseconds delay = response.delay;
+    for (int hop = 0; request.followRedirects && hop < MAX_REDIRECTS; ++hop) {
+        if (response.status < 300 || response.status >= 400 || response.location.empty()) {
+            break;
+        }
+        response = web.respond(response.location, false);
+        delay += response.delay;
+    }
+    response.delay = delay;
+    return response;
+}
+
+Fetcher::Result SyntheticFetcher::deliver(const SyntheticWeb::Response& response, const HeaderHandler& onHeaders,
+                                          const BodyHandler& onBody) {
+    Result result;
+    result.status = response.status;
+    result.contentType = response.contentType;
+    result.contentLength = static_cast<long long>(response.body.size());
+    result.wireBytes = result.contentLength;
+
+    if (!onHeaders(result.status, result.contentType, result.contentLength)) {
+        return result;
+    }
+    if (!response.body.empty() && !onBody(response.body.data(), response.body.size())) {
+        return result;
+    }
+
+    result.completed = true;
+    return result;
+}
+
+Fetcher::Result SyntheticFetcher::fetch(const Request& request, const HeaderHandler& onHeaders, const BodyHandler& onBody) {
+    SyntheticWeb::Response response = respond(request);
+    if (response.delay.count() > 0) {
+        std::this_thread::sleep_for(response.delay);
+    }
+    return deliver(response, onHeaders, onBody);
+}
+
+void SyntheticFetcher::fetchAsync(const Request& request, HeaderHandler onHeaders, BodyHandler onBody,
+                                  CompletionHandler onComplete) {
+    SyntheticWeb::Response response = respond(request);
+    if (response.delay.count() <= 0) {
+        onComplete(deliver(response, onHeaders, onBody));
+        return;
+    }
+
+    Timer timer;
+    timer.deadline = std::chrono::steady_clock::now() + response.delay;
+    timer.task = [response = std::move(response), onHeaders = std::move(onHeaders),
+                  onBody = std::move(onBody), onComplete = std::move(onComplete)](bool cancelled) {
+        if (cancelled) {
+            Result result;
+            result.error = "Fetcher shut down before the response arrived";
+            onComplete(result);
+            return;
+        }
+        onComplete(deliver(response, onHeaders, onBody));
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (!timerThread.joinable()) {
+            timerThread = std::thread(&SyntheticFetcher::timerLoop, this);
+        }
+        timer.sequence = nextSequence++;
+        bool earliest = timers.empty() || timer.deadline < timers.top().deadline;
+        timers.push(std::move(timer));
+        if (!earliest) {
+            return;
+        }
+    }
+    timerCondition.notify_one();
+}
+
+void SyntheticFetcher::timerLoop() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (!stopping) {
+        if (timers.empty()) {
+            timerCondition.wait(lock);
+            continue;
+        }
+
+        auto deadline = timers.top().deadline;
+        if (std::chrono::steady_clock::now() < deadline) {
+            timerCondition.wait_until(lock, deadline);
+            continue;
+        }
+
+        // Moving out of top() is safe since the element is popped right away
+        std::function<void(bool)> task = std::move(const_cast<Timer&>(timers.top()).task);
+        timers.pop();
+        lock.unlock();
+        task(false);
+        lock.lock();
+    }
+
+    // Responses still waiting at shutdown are cancelled, so every fetch completes
+    while (!timers.empty()) {
+        std::function<void(bool)> task = std::move(const_cast<Timer&>(timers.top()).task);
+        timers.pop();
+        lock.unlock();
+        task(true);
+        lock.lock();
+    }
+}
@@ -0,0 +1,190 @@
+#include "../include/synthetic_web.hpp"
+#include "../include/compression.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+const char* const WORDS[] = {
+    "crawler", "frontier", "latency", "socket", "buffer", "thread", "queue", "index",
+    "parser", "render", "server", "client", "packet", "stream", "window", "record",
+    "schema", "lambda", "vector", "matrix", "signal", "kernel", "branch", "commit",
+    "module", "object", "method", "symbol", "memory", "filter", "policy", "target",
+    "domain", "origin", "header", "status", "engine", "region", "bucket", "ledger",
+    "garden", "river", "forest", "canyon", "harbor", "meadow", "valley", "summit",
+    "amber", "cobalt", "indigo", "violet", "silver", "copper", "marble", "granite",
+    "orbit", "comet", "planet", "nebula", "quasar", "photon", "proton", "neutron"
+};
+const size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+// Tag for each derived property, so they are independent of each other
+enum Stream : uint64_t {
+    LINK = 1,
+    TEXT = 2,
+    ERROR_STREAM = 3,
+    REDIRECT = 4,
+    LATENCY = 5
+};
+
+uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Inverse of the standard normal CDF (Acklam's rational approximation)
+double normalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+
+    p = std::min(std::max(p, 1e-12), 1.0 - 1e-12);
+    if (p < 0.02425) {
+        double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - 0.02425) {
+        double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+} // namespace
+
+SyntheticWeb::SyntheticWeb(const Options& options)
+    : options(options) {
+    this->options.pageCount = std::max<size_t>(1, options.pageCount);
+}
+
+const SyntheticWeb::Options& SyntheticWeb::getOptions() const {
+    return options;
+}
+
+std::string SyntheticWeb::pagePath(size_t page) {
+    return "/page/" + std::to_string(page);
+}
+
+std::string SyntheticWeb::pageUrl(size_t page) const {
+    if (options.hostCount <= 1) {
+        return pagePath(page);
+    }
+    return "http://site" + std::to_string(page % options.hostCount) + ".test" + pagePath(page);
+}
+
+uint64_t SyntheticWeb::hash(uint64_t a, uint64_t b) const {
+    return mix(mix(options.seed ^ mix(a)) + b);
+}
+
+double SyntheticWeb::unitValue(uint64_t a, uint64_t b) const {
+    return static_cast<double>(hash(a, b) >> 11) / static_cast<double>(1ULL << 53);
+}
+
+std::chrono::microseconds SyntheticWeb::latencyFor(size_t page) const {
+    if (options.latencyMedianMs <= 0) {
+        return std::chrono::microseconds(0);
+    }
+    // Log-normal with the requested median and 99th percentile
+    double sigma = options.latencyP99Ms > options.latencyMedianMs
+        ? std::log(options.latencyP99Ms / options.latencyMedianMs) / 2.326347874
+        : 0.0;
+    double z = normalQuantile(unitValue(LATENCY, page));
+    double ms = options.latencyMedianMs * std::exp(sigma * z);
+    return std::chrono::microseconds(static_cast<long long>(ms * 1000.0));
+}
+
+SyntheticWeb::Response SyntheticWeb::respond(const std::string& target, bool acceptGzip) const {
+    Response response;
+
+    std::string path = target.substr(0, target.find('?'));
+    if (path == "/robots.txt") {
+        response.contentType = "text/plain";
+        response.body = "User-agent: *\nAllow: /\n";
+        return response;
+    }
+
+    const std::string prefix = "/page/";
+    const char* end = nullptr;
+    unsigned long long page = 0;
+    if (path.empty() || path == "/") {
+        end = path.c_str() + path.size();
+    } else if (path.compare(0, prefix.size(), prefix) == 0 && path.size() > prefix.size()) {
+        char* parsed = nullptr;
+        page = std::strtoull(path.c_str() + prefix.size(), &parsed, 10);
+        end = parsed;
+    }
+    if (!end || *end != '\0' || page >= options.pageCount) {
+        response.status = 404;
+        response.contentType = "text/plain";
+        response.body = "Not found\n";
+        return response;
+    }
+
+    response.delay = latencyFor(page);
+
+    if (unitValue(ERROR_STREAM, page) < options.errorRate) {
+        response.status = 503;
+        response.contentType = "text/plain";
+        response.body = "Service unavailable\n";
+        return response;
+    }
+
+    // Redirects point at the same page with a marker, which is served normally
+    bool redirected = target.find("?moved") != std::string::npos;
+    if (!redirected && unitValue(REDIRECT, page) < options.redirectRate) {
+        response.status = 301;
+        response.location = pagePath(page) + "?moved";
+        response.contentType = "text/html";
+        return response;
+    }
+
+    response.contentType = "text/html; charset=utf-8";
+    response.body = renderPage(page);
+
+    std::string compressed;
+    if (options.gzip && acceptGzip && gzipCompress(response.body.data(), response.body.size(), compressed)) {
+        response.body.swap(compressed);
+        response.contentEncoding = "gzip";
+    }
+    return response;
+}
+
+std::string SyntheticWeb::renderPage(size_t page) const {
+    std::string html;
+    html.reserve(options.pageBytes + 1024);
+    html += "<!DOCTYPE html>\n<html>\n<head>\n<title>Synthetic page ";
+    html += std::to_string(page);
+    html += "</title>\n</head>\n<body>\n<h1>Page ";
+    html += std::to_string(page);
+    html += "</h1>\n<ul>\n";
+
+    // The next page is always linked so the whole graph stays reachable
+    html += "<li><a href=\"" + pageUrl((page + 1) % options.pageCount) + "\">next</a></li>\n";
+    for (size_t i = 0; i < options.fanout; ++i) {
+        size_t target = hash(LINK * options.pageCount + page, i) % options.pageCount;
+        html += "<li><a href=\"" + pageUrl(target) + "\">link " + std::to_string(i) + "</a></li>\n";
+    }
+    html += "</ul>\n<p>\n";
+
+    uint64_t word = 0;
+    while (html.size() < options.pageBytes) {
+        html += WORDS[hash(TEXT * options.pageCount + page, word++) % WORD_COUNT];
+        html += (word % 12 == 0) ? ".\n" : " ";
+    }
+    html += "\n</p>\n</body>\n</html>\n";
+    return html;
+}
@@ -0,0 +1,74 @@
+#include "../include/text_normalizer.hpp"
+#include <cstring>
+
+namespace {
+
+// What each byte is written as, 0 for separators
+struct ByteMap {
+    char lower[256];
+    char preserve[256];
+};
+
+const ByteMap& byteMap() {
+    static const ByteMap map = [] {
+        ByteMap built{};
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+                built.lower[c] = built.preserve[c] = static_cast<char>(c);
+            } else if (c >= 'A' && c <= 'Z') {
+                built.lower[c] = static_cast<char>(c + ('a' - 'A'));
+                built.preserve[c] = static_cast<char>(c);
+            }
+        }
+        return built;
+    }();
+    return map;
+}
+
+} // namespace
+
+void TextNormalizer::normalize(std::string_view text, std::string& out, Case letterCase) {
+    const char* map = letterCase == Case::LOWER ? byteMap().lower : byteMap().preserve;
+
+    // The result is never longer than the input
+    out.resize(text.size());
+    if (text.empty()) {
+        return;
+    }
+
+    char* written = &out[0];
+    const char* p = text.data();
+    const char* end = p + text.size();
+    bool afterSeparator = false;
+    bool tagsMayClose = true;       // Cleared once no '>' is left, so each byte is searched at most once
+
+    while (p < end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '<' && tagsMayClose) {
+            const char* close = static_cast<const char*>(std::memchr(p + 1, '>', end - p - 1));
+            if (close) {
+                p = close + 1;
+                continue;
+            }
+            tagsMayClose = false;
+        }
+
+        char mapped = map[c];
+        if (mapped) {
+            *written++ = mapped;
+            afterSeparator = false;
+        } else if (!afterSeparator) {
+            *written++ = ' ';
+            afterSeparator = true;
+        }
+        ++p;
+    }
+
+    out.resize(static_cast<size_t>(written - out.data()));
+}
+
+std::string TextNormalizer::normalize(std::string_view text, Case letterCase) {
+    std::string out;
+    normalize(text, out, letterCase);
+    return out;
+}
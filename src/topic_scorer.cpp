@@ -0,0 +1,271 @@
+#include "../include/topic_scorer.hpp"
+#include "../include/fnv_hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+constexpr size_t TopicScorer::MAX_WORD_LENGTH;
+
+namespace {
+
+// A term counts fully once it occurs this often
+const double SATURATION = 1.0 + std::log(8.0);
+
+bool isWordChar(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+char toLower(unsigned char c) {
+    return static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+uint64_t hashWord(const char* word, size_t length) {
+    return fnv1a(std::string_view(word, length));
+}
+
+} // namespace
+
+TopicScorer::TopicScorer(const std::string& query)
+    : tableMask(0)
+    , totalWeight(0.0) {
+    size_t position = 0;
+    while (position < query.size()) {
+        size_t start = query.find_first_not_of(" \t\r\n", position);
+        if (start == std::string::npos) {
+            break;
+        }
+        size_t end = query.find_first_of(" \t\r\n", start);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+        position = end;
+        std::string token = query.substr(start, end - start);
+
+        // "term:weight"
+        float weight = 1.0f;
+        size_t colon = token.rfind(':');
+        if (colon != std::string::npos && colon + 1 < token.size()) {
+            char* parsedEnd;
+            double parsed = std::strtod(token.c_str() + colon + 1, &parsedEnd);
+            if (*parsedEnd == '\0') {
+                weight = static_cast<float>(parsed);
+                token.resize(colon);
+            }
+        }
+        if (!(weight > 0.0f)) {
+            continue;
+        }
+
+        // Split the way text is split, so "machine-learning" matches its words
+        std::string word;
+        for (size_t i = 0; i <= token.size(); ++i) {
+            if (i < token.size() && isWordChar(static_cast<unsigned char>(token[i]))) {
+                word.push_back(toLower(static_cast<unsigned char>(token[i])));
+                continue;
+            }
+            if (!word.empty() && word.size() <= MAX_WORD_LENGTH) {
+                auto existing = std::find_if(terms.begin(), terms.end(),
+                    [&word](const Term& term) { return term.text == word; });
+                if (existing == terms.end()) {
+                    terms.push_back(Term{word, weight});
+                } else {
+                    existing->weight = std::max(existing->weight, weight);
+                }
+            }
+            word.clear();
+        }
+    }
+
+    size_t tableSize = 16;
+    while (tableSize < terms.size() * 2) {
+        tableSize *= 2;
+    }
+    table.assign(tableSize, -1);
+    tableMask = tableSize - 1;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        size_t slot = hashWord(terms[i].text.data(), terms[i].text.size()) & tableMask;
+        while (table[slot] >= 0) {
+            slot = (slot + 1) & tableMask;
+        }
+        table[slot] = static_cast<int32_t>(i);
+        totalWeight += terms[i].weight;
+    }
+}
+
+bool TopicScorer::empty() const {
+    return terms.empty();
+}
+
+const std::vector<TopicScorer::Term>& TopicScorer::getTerms() const {
+    return terms;
+}
+
+int TopicScorer::findTerm(const char* word, size_t length) const {
+    size_t slot = hashWord(word, length) & tableMask;
+    while (table[slot] >= 0) {
+        const std::string& text = terms[static_cast<size_t>(table[slot])].text;
+        if (text.size() == length && std::memcmp(text.data(), word, length) == 0) {
+            return table[slot];
+        }
+        slot = (slot + 1) & tableMask;
+    }
+    return -1;
+}
+
+double TopicScorer::score(const std::vector<uint32_t>& counts) const {
+    if (totalWeight <= 0.0) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        if (counts[i] > 0) {
+            total += terms[i].weight * std::min(1.0, (1.0 + std::log(static_cast<double>(counts[i]))) / SATURATION);
+        }
+    }
+    return total / totalWeight;
+}
+
+double TopicScorer::scoreText(std::string_view text) const {
+    if (terms.empty()) {
+        return 0.0;
+    }
+
+    std::vector<uint32_t> counts(terms.size(), 0);
+    char word[MAX_WORD_LENGTH];
+    size_t length = 0;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && isWordChar(static_cast<unsigned char>(text[i]))) {
+            if (length < sizeof(word)) {
+                word[length] = toLower(static_cast<unsigned char>(text[i]));
+            }
+            length++;
+            continue;
+        }
+        if (length > 0 && length <= sizeof(word)) {
+            int term = findTerm(word, length);
+            if (term >= 0) {
+                counts[static_cast<size_t>(term)]++;
+            }
+        }
+        length = 0;
+    }
+    return score(counts);
+}
+
+double TopicScorer::scoreHtml(std::string_view html) const {
+    Counter counter(*this);
+    counter.feed(html.data(), html.size());
+    return counter.finish();
+}
+
+TopicScorer::Counter::Counter(const TopicScorer& scorer)
+    : scorer(scorer)
+    , counts(scorer.terms.size(), 0) {
+    reset();
+}
+
+void TopicScorer::Counter::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    wordLength = 0;
+    inTag = false;
+    tagLength = 0;
+    tagNameDone = false;
+    lastTwo[0] = lastTwo[1] = 0;
+    inComment = false;
+    inRawText = false;
+}
+
+void TopicScorer::Counter::endWord() {
+    if (wordLength > 0 && wordLength <= sizeof(word)) {
+        int term = scorer.findTerm(word, wordLength);
+        if (term >= 0) {
+            counts[static_cast<size_t>(term)]++;
+        }
+    }
+    wordLength = 0;
+}
+
+void TopicScorer::Counter::endTag() {
+    if (tagLength > sizeof(tagName)) {
+        return;
+    }
+    std::string_view name(tagName, tagLength);
+    if (name == "script" || name == "style") {
+        inRawText = true;
+    } else if (name == "/script" || name == "/style") {
+        inRawText = false;
+    }
+}
+
+void TopicScorer::Counter::feed(const char* data, size_t size) {
+    if (scorer.terms.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+
+        if (inTag) {
+            if (inComment) {
+                if (c == '>' && lastTwo[0] == '-' && lastTwo[1] == '-') {
+                    inTag = false;
+                }
+                lastTwo[0] = lastTwo[1];
+                lastTwo[1] = static_cast<char>(c);
+            } else if (c == '>') {
+                endTag();
+                inTag = false;
+            } else if (!tagNameDone) {
+                // The name runs to the first space, or '/' after its first character
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || (c == '/' && tagLength > 0)) {
+                    tagNameDone = true;
+                } else {
+                    if (tagLength < sizeof(tagName)) {
+                        tagName[tagLength] = toLower(c);
+                    }
+                    tagLength++;
+                    if (tagLength == 3 && std::memcmp(tagName, "!--", 3) == 0) {
+                        inComment = true;
+                        lastTwo[0] = lastTwo[1] = 0;
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (c == '<') {
+            endWord();
+            inTag = true;
+            tagLength = 0;
+            tagNameDone = false;
+            inComment = false;
+            continue;
+        }
+        if (inRawText) {
+            continue;
+        }
+
+        if (isWordChar(c)) {
+            if (wordLength < sizeof(word)) {
+                word[wordLength] = toLower(c);
+            }
+            wordLength++;
+        } else if (c == '&') {
+            // Character references such as &amp; are not words
+            endWord();
+            wordLength = sizeof(word) + 1;
+        } else if (c == ';' && wordLength > sizeof(word)) {
+            wordLength = 0;
+        } else {
+            endWord();
+        }
+    }
+}
+
+double TopicScorer::Counter::finish() {
+    if (!inTag) {
+        endWord();
+    }
+    return scorer.score(counts);
+}
@@ -74,6 +74,7 @@ std::string SimpleURLParser::getScheme() const {
 UniversalCrawler::UniversalCrawler() 
     : maxThreads(4),
       maxDepth(3),
+      outputFormat(RecordSink::Format::CSV),
       running(false),
       pagesCrawled(0),
       imagesSaved(0),
@@ -98,7 +99,12 @@ void UniversalCrawler::setMaxDepth(int depth) {
 
 void UniversalCrawler::setAllowedDomains(const std::vector<std::string>& domains) {
     std::lock_guard<std::mutex> lock(mutex);
-    allowedDomains = domains;
+    allowedHosts = HostFilter(domains);
+}
+
+void UniversalCrawler::setOutputFormat(RecordSink::Format format) {
+    std::lock_guard<std::mutex> lock(mutex);
+    outputFormat = format;
 }
 
 void UniversalCrawler::start(const std::string& seedUrl, int depth) {
@@ -117,10 +123,13 @@ void UniversalCrawler::start(const std::string& seedUrl, int depth) {
     activeThreads = 0;
     urlQueue = std::queue<std::pair<std::string, int>>();
     visitedUrls.clear();
+    pendingUrls.clear();
+    trapDetector.clear();
     
     // Add seed URL to the queue
     if (SimpleURLParser::isValidUrl(seedUrl)) {
         urlQueue.push({seedUrl, depth});
+        pendingUrls.insert(seedUrl);
         std::cout << "Added seed URL to queue: " << seedUrl << "\n";
     } else {
         std::cerr << "Error: Invalid seed URL: " << seedUrl << "\n";
@@ -130,6 +139,7 @@ void UniversalCrawler::start(const std::string& seedUrl, int depth) {
     
     // Create data directories if they don't exist
     ensureDirectoriesExist();
+    openSinks();
     
     // Start worker threads
     for (int i = 0; i < maxThreads; ++i) {
@@ -161,6 +171,29 @@ void UniversalCrawler::ensureDirectoriesExist() {
     }
 }
 
+void UniversalCrawler::openSinks() {
+    std::string extension = outputFormat == RecordSink::Format::NDJSON ? ".ndjson" : ".csv";
+    
+    RecordSink::Options pages;
+    pages.path = "data/crawled_pages" + extension;
+    pages.columns = {"URL", "Domain", "Crawl_Depth", "Timestamp"};
+    pages.format = outputFormat;
+    pageSink = std::make_unique<RecordSink>(pages);
+    
+    RecordSink::Options images;
+    images.path = "data/discovered_images" + extension;
+    images.columns = {"Domain", "Image_URL", "Image_Type", "Size_KB", "Timestamp"};
+    images.format = outputFormat;
+    imageSink = std::make_unique<RecordSink>(images);
+    
+    for (auto* sink : {&pageSink, &imageSink}) {
+        if (!(*sink)->isOpen()) {
+            std::cerr << "Error: Could not open database file for writing: " << (*sink)->getPath() << std::endl;
+            sink->reset();
+        }
+    }
+}
+
 void UniversalCrawler::stop() {
     if (!isRunning()) {
         return;
@@ -184,6 +217,10 @@ void UniversalCrawler::stop() {
     // Clear threads vector
     threads.clear();
     
+    // Flush and close the database files
+    pageSink.reset();
+    imageSink.reset();
+    
     std::cout << "Crawler stopped. Processed " << pagesCrawled << " pages and found " 
               << imagesSaved << " images.\n";
 }
@@ -260,11 +297,14 @@ void UniversalCrawler::crawlThread() {
                 // Mark as visited
                 {
                     std::lock_guard<std::mutex> lock(mutex);
+                    pendingUrls.erase(urlEntry.first);
                     visitedUrls.insert(urlEntry.first);
                     pagesCrawled++;
                 }
             } catch (const std::exception& e) {
                 std::cerr << "Error processing URL " << urlEntry.first << ": " << e.what() << std::endl;
+                std::lock_guard<std::mutex> lock(mutex);
+                pendingUrls.erase(urlEntry.first);
             }
         }
     }
@@ -359,32 +399,31 @@ void UniversalCrawler::processUrl(const std::string& url, int depth) {
                 continue;
             }
             
-            // Check if URL is already visited or pending
-            if (visitedUrls.find(fakeUrl) != visitedUrls.end()) {
+            // Check if URL is already visited, queued or being processed, so
+            // each URL reaches the trap detector below only once
+            if (visitedUrls.find(fakeUrl) != visitedUrls.end() ||
+                pendingUrls.find(fakeUrl) != pendingUrls.end()) {
                 continue;
             }
             
             // Check if domain is allowed
-            std::string domain = SimpleURLParser::extractDomain(fakeUrl);
-            if (!allowedDomains.empty()) {
-                bool domainAllowed = false;
-                for (const auto& allowedDomain : allowedDomains) {
-                    if (domain == allowedDomain || 
-                        domain.find(allowedDomain) != std::string::npos ||
-                        (domain.size() > allowedDomain.size() && 
-                         domain.substr(domain.size() - allowedDomain.size()) == allowedDomain)) {
-                        domainAllowed = true;
-                        break;
-                    }
-                }
-                
-                if (!domainAllowed) {
-                    continue;
-                }
+            if (!allowedHosts.matches(SimpleURLParser::extractDomain(fakeUrl))) {
+                continue;
+            }
+            
+            // Generated paths repeat endlessly; the queue is FIFO, so URLs
+            // from a growing pattern are thinned out instead of reprioritized
+            float priorityScale;
+            UrlTrapDetector::Verdict verdict = trapDetector.check(fakeUrl, priorityScale);
+            if (verdict == UrlTrapDetector::Verdict::DROP ||
+                (verdict == UrlTrapDetector::Verdict::THROTTLE &&
+                 rand() % 1000 >= static_cast<int>(priorityScale * 1000))) {
+                continue;
             }
             
             // Add URL to queue
             urlQueue.push({fakeUrl, depth + 1});
+            pendingUrls.insert(fakeUrl);
             addedCount++;
             addedUrls = true;
         }
@@ -624,124 +663,53 @@ int UniversalCrawler::simulateImageDiscovery(const std::string& domain) {
     return 0; // No images found
 }
 
-// Save page data to a simulated database (just writes to a CSV file)
+// Save page data to a simulated database (a CSV or NDJSON file)
 void UniversalCrawler::savePageToDatabase(const std::string& url, int depth) {
-    // Create data directory if it doesn't exist
-    if (!fs::exists("data")) {
-        fs::create_directory("data");
-    }
-    
-    // Lock to prevent multiple threads from writing simultaneously
-    static std::mutex fileMutex;
-    std::lock_guard<std::mutex> lock(fileMutex);
-    
-    std::string filename = "data/crawled_pages.csv";
-    bool fileExists = fs::exists(filename);
-    bool isEmpty = false;
-    
-    if (fileExists) {
-        std::ifstream checkFile(filename);
-        isEmpty = checkFile.peek() == std::ifstream::traits_type::eof();
-        checkFile.close();
+    if (!pageSink) {
+        return;
     }
     
-    std::ofstream file(filename, std::ios::app);
-    if (file.is_open()) {
-        // If new file or empty file, write header
-        if (!fileExists || isEmpty) {
-            file << "URL,Domain,Crawl_Depth,Timestamp\n";
-        }
-        
-        // Get current time
-        auto now = std::chrono::system_clock::now();
-        auto timestamp = std::chrono::system_clock::to_time_t(now);
-        
-        // Extract domain
-        std::string domain = SimpleURLParser::extractDomain(url);
-        
-        // Write data
-        file << url << "," 
-             << domain << "," 
-             << depth << "," 
-             << timestamp << "\n";
-        
-        file.close();
-    } else {
-        std::cerr << "Error: Could not open database file for writing: " << filename << std::endl;
-    }
+    auto timestamp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    pageSink->write({url, SimpleURLParser::extractDomain(url), std::to_string(depth), std::to_string(timestamp)});
 }
 
 // Save image metadata to a simulated database
 void UniversalCrawler::saveImageMetadata(const std::string& domain, int imageIndex) {
-    // Create data directory if it doesn't exist
-    if (!fs::exists("data")) {
-        fs::create_directory("data");
+    if (!imageSink) {
+        return;
     }
     
-    // Lock to prevent multiple threads from writing simultaneously
-    static std::mutex fileMutex;
-    std::lock_guard<std::mutex> lock(fileMutex);
+    auto timestamp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     
-    std::string filename = "data/discovered_images.csv";
-    bool fileExists = fs::exists(filename);
-    bool isEmpty = false;
+    // Generate fake image URL with improved naming
+    std::string imageName = "img_" + std::to_string(imageIndex) + "_" + 
+                           std::to_string(rand() % 10000);
+    std::string imageUrl = "https://" + domain + "/images/" + imageName;
     
-    if (fileExists) {
-        std::ifstream checkFile(filename);
-        isEmpty = checkFile.peek() == std::ifstream::traits_type::eof();
-        checkFile.close();
-    }
+    // Random image type and size
+    static const std::vector<std::string> imageTypes = {"jpg", "png", "gif", "webp"};
+    std::string imageType = imageTypes[rand() % imageTypes.size()];
     
-    std::ofstream file(filename, std::ios::app);
-    if (file.is_open()) {
-        // If new file or empty file, write header
-        if (!fileExists || isEmpty) {
-            file << "Domain,Image_URL,Image_Type,Size_KB,Timestamp\n";
-        }
-        
-        // Get current time
-        auto now = std::chrono::system_clock::now();
-        auto timestamp = std::chrono::system_clock::to_time_t(now);
-        
-        // Generate fake image URL with improved naming
-        std::string imageName = "img_" + std::to_string(imageIndex) + "_" + 
-                               std::to_string(rand() % 10000);
-        std::string imageUrl = "https://" + domain + "/images/" + imageName;
-        
-        // Random image type and size
-        static const std::vector<std::string> imageTypes = {"jpg", "png", "gif", "webp"};
-        std::string imageType = imageTypes[rand() % imageTypes.size()];
-        
-        // Add the image extension to the URL
-        imageUrl += "." + imageType;
-        
-        // More realistic file size distribution
-        int sizeKB;
-        if (imageType == "webp" || imageType == "png") {
-            // WebP and PNG tend to be smaller
-            sizeKB = 10 + (rand() % 500); 
-        } else if (imageType == "gif") {
-            // GIFs can vary widely
-            sizeKB = 5 + (rand() % 1000);
-        } else {
-            // JPGs tend to be larger
-            sizeKB = 20 + (rand() % 1000);
-        }
-        
-        // Write data
-        file << domain << "," 
-             << imageUrl << "," 
-             << imageType << "," 
-             << sizeKB << "," 
-             << timestamp << "\n";
-        
-        file.close();
-        
-        // Simulate saving image to filesystem
-        saveImageToFileSystem(domain, imageName, imageType, imageIndex);
+    // Add the image extension to the URL
+    imageUrl += "." + imageType;
+    
+    // More realistic file size distribution
+    int sizeKB;
+    if (imageType == "webp" || imageType == "png") {
+        // WebP and PNG tend to be smaller
+        sizeKB = 10 + (rand() % 500); 
+    } else if (imageType == "gif") {
+        // GIFs can vary widely
+        sizeKB = 5 + (rand() % 1000);
     } else {
-        std::cerr << "Error: Could not open image database file for writing: " << filename << std::endl;
+        // JPGs tend to be larger
+        sizeKB = 20 + (rand() % 1000);
     }
+    
+    imageSink->write({domain, imageUrl, imageType, std::to_string(sizeKB), std::to_string(timestamp)});
+    
+    // Simulate saving image to filesystem
+    saveImageToFileSystem(domain, imageName, imageType, imageIndex);
 }
 
 // New method to simulate saving images to file system
@@ -0,0 +1,194 @@
+#include "../include/url_exchange.hpp"
+#include "../include/fnv_hash.hpp"
+#include "../include/varint.hpp"
+#include <algorithm>
+
+namespace {
+
+// First byte of every encoded batch, so the format can evolve
+const unsigned char FORMAT_FRONT_CODED = 1;
+
+// Longest URL accepted from the wire
+const size_t MAX_URL_BYTES = 64 * 1024;
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+UrlExchange::UrlExchange(const Options& options)
+    : options(options)
+    , recent(roundUpToPowerOfTwo(std::max<size_t>(1, options.recentCapacity)), 0) {
+    this->options.batchSize = std::max<size_t>(1, options.batchSize);
+}
+
+uint64_t UrlExchange::fingerprint(std::string_view url) {
+    uint64_t hash = fnv1a(url);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash ? hash : 1;
+}
+
+bool UrlExchange::add(const std::string& destination, std::string url, int depth) {
+    uint64_t print = fingerprint(url);
+    uint64_t& slot = recent[print & (recent.size() - 1)];
+    if (slot == print) {
+        stats.duplicatesDropped++;
+        return false;
+    }
+    slot = print;
+
+    Buffer& buffer = buffers[destination];
+    if (buffer.entries.empty()) {
+        buffer.started = Clock::now();
+    }
+    buffer.bytes += url.size();
+    buffer.entries.push_back({print, std::move(url), depth});
+    stats.urlsAdded++;
+    return true;
+}
+
+bool UrlExchange::isFull(const Buffer& buffer) const {
+    return buffer.entries.size() >= options.batchSize || buffer.bytes >= options.batchBytes;
+}
+
+std::vector<UrlExchange::Batch> UrlExchange::takeReady(Clock::time_point now, bool all) {
+    std::vector<Batch> batches;
+    for (auto& [destination, buffer] : buffers) {
+        if (buffer.entries.empty()) {
+            continue;
+        }
+        if (all || isFull(buffer) || now - buffer.started >= options.flushInterval) {
+            batches.push_back({destination, std::move(buffer.entries), buffer.started});
+            buffer.entries.clear();
+            buffer.bytes = 0;
+        }
+    }
+    stats.batchesTaken += static_cast<long long>(batches.size());
+    return batches;
+}
+
+std::vector<UrlExchange::Entry> UrlExchange::takeAll(const std::string& destination) {
+    std::vector<Entry> entries;
+    auto it = buffers.find(destination);
+    if (it != buffers.end()) {
+        entries = std::move(it->second.entries);
+        buffers.erase(it);
+    }
+    return entries;
+}
+
+void UrlExchange::restore(Batch batch) {
+    Buffer& buffer = buffers[batch.destination];
+    for (const auto& entry : batch.entries) {
+        buffer.bytes += entry.url.size();
+    }
+    batch.entries.insert(batch.entries.end(), std::make_move_iterator(buffer.entries.begin()),
+                         std::make_move_iterator(buffer.entries.end()));
+    buffer.entries = std::move(batch.entries);
+    buffer.started = batch.started;
+}
+
+void UrlExchange::forgetRecent() {
+    std::fill(recent.begin(), recent.end(), 0);
+}
+
+bool UrlExchange::hasFullBuffer() const {
+    for (const auto& [destination, buffer] : buffers) {
+        if (isFull(buffer)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UrlExchange::empty() const {
+    for (const auto& [destination, buffer] : buffers) {
+        if (!buffer.entries.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+UrlExchange::Stats UrlExchange::getStats() const {
+    return stats;
+}
+
+std::string UrlExchange::encode(std::vector<Entry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.url < b.url; });
+
+    std::string out;
+    out.push_back(static_cast<char>(FORMAT_FRONT_CODED));
+    putVarint(out, entries.size());
+
+    const std::string* previous = nullptr;
+    for (const auto& entry : entries) {
+        size_t shared = 0;
+        if (previous) {
+            size_t limit = std::min(previous->size(), entry.url.size());
+            while (shared < limit && (*previous)[shared] == entry.url[shared]) {
+                shared++;
+            }
+        }
+        putVarint(out, shared);
+        putVarint(out, entry.url.size() - shared);
+        out.append(entry.url, shared, std::string::npos);
+        putVarint(out, static_cast<uint64_t>(std::max(0, entry.depth)));
+        previous = &entry.url;
+    }
+    return out;
+}
+
+bool UrlExchange::decode(std::string_view payload, std::vector<std::pair<std::string, int>>& urls) {
+    urls.clear();
+    if (payload.empty() || static_cast<unsigned char>(payload[0]) != FORMAT_FRONT_CODED) {
+        return false;
+    }
+
+    size_t offset = 1;
+    uint64_t count;
+    // Every entry takes at least three bytes
+    if (!getVarint(payload, offset, count) || count > payload.size() / 3) {
+        return false;
+    }
+    urls.reserve(static_cast<size_t>(count));
+
+    std::string previous;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t shared;
+        uint64_t suffix;
+        uint64_t depth;
+        if (!getVarint(payload, offset, shared) || !getVarint(payload, offset, suffix) ||
+            shared > previous.size() || suffix > payload.size() - offset || shared + suffix > MAX_URL_BYTES) {
+            urls.clear();
+            return false;
+        }
+
+        std::string url;
+        url.reserve(static_cast<size_t>(shared + suffix));
+        url.append(previous, 0, static_cast<size_t>(shared));
+        url.append(payload.data() + offset, static_cast<size_t>(suffix));
+        offset += static_cast<size_t>(suffix);
+
+        if (!getVarint(payload, offset, depth) || depth > static_cast<uint64_t>(INT32_MAX)) {
+            urls.clear();
+            return false;
+        }
+
+        previous = url;
+        urls.emplace_back(std::move(url), static_cast<int>(depth));
+    }
+
+    if (offset != payload.size()) {
+        urls.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+#include "../include/url_frontier.hpp"
+#include <algorithm>
+#include <utility>
+
+constexpr float UrlFrontier::DEFAULT_PRIORITY;
+
+UrlFrontier::UrlFrontier()
+    : nextSequence(0) {
+}
+
+bool UrlFrontier::push(Entry entry) {
+    if (!queued.insert(entry.url).second) {
+        return false;
+    }
+    heap.push_back(Item{std::move(entry), nextSequence++});
+    std::push_heap(heap.begin(), heap.end(), servedAfter);
+    return true;
+}
+
+void UrlFrontier::pushBatch(std::vector<Entry>& entries) {
+    if (entries.empty()) {
+        return;
+    }
+
+    size_t existing = heap.size();
+    heap.reserve(existing + entries.size());
+    for (auto& entry : entries) {
+        if (queued.insert(entry.url).second) {
+            heap.push_back(Item{std::move(entry), nextSequence++});
+        }
+    }
+    entries.clear();
+    if (heap.size() == existing) {
+        return;
+    }
+
+    // Rebuilding is linear; sifting each entry up costs log n apiece
+    if (heap.size() - existing > existing / 16) {
+        std::make_heap(heap.begin(), heap.end(), servedAfter);
+    } else {
+        for (size_t i = existing + 1; i <= heap.size(); ++i) {
+            std::push_heap(heap.begin(), heap.begin() + i, servedAfter);
+        }
+    }
+}
+
+bool UrlFrontier::pop(Entry& entry) {
+    if (heap.empty()) {
+        return false;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), servedAfter);
+    entry = std::move(heap.back().entry);
+    heap.pop_back();
+    queued.erase(entry.url);
+    return true;
+}
+
+void UrlFrontier::reprioritize(const std::function<void(Entry&)>& update) {
+    for (auto& item : heap) {
+        update(item.entry);
+    }
+    std::make_heap(heap.begin(), heap.end(), servedAfter);
+}
+
+bool UrlFrontier::contains(const std::string& url) const {
+    return queued.count(url) != 0;
+}
+
+size_t UrlFrontier::size() const {
+    return heap.size();
+}
+
+bool UrlFrontier::empty() const {
+    return heap.empty();
+}
+
+void UrlFrontier::clear() {
+    heap.clear();
+    queued.clear();
+    nextSequence = 0;
+}
+
+bool UrlFrontier::servedAfter(const Item& a, const Item& b) {
+    float aPriority = a.entry.priority + a.entry.rank;
+    float bPriority = b.entry.priority + b.entry.rank;
+    if (aPriority != bPriority) {
+        return aPriority < bPriority;
+    }
+    if (a.entry.lastModified != b.entry.lastModified) {
+        return a.entry.lastModified < b.entry.lastModified;
+    }
+    return a.sequence > b.sequence;
+}
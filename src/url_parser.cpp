@@ -190,24 +190,15 @@ bool URLParser::shouldCrawl(const std::string& url, const std::vector<std::strin
         return false;
     }
     
-    // Parse URL to get domain
-    std::string domain = getDomain(url);
-    
     // If allowed domains list is empty, allow all
     if (allowedDomains.empty()) {
         return true;
     }
     
-    // Check if domain is in allowed domains
-    for (const auto& allowedDomain : allowedDomains) {
-        if (domain == allowedDomain || 
-            (domain.length() >= allowedDomain.length() + 1 &&
-             domain.compare(domain.length() - allowedDomain.length() - 1, 
-                            allowedDomain.length() + 1, 
-                            "." + allowedDomain) == 0)) {
-            return true;
-        }
-    }
-    
-    return false;
+    // Callers checking many URLs should compile the list into a HostFilter once
+    return HostFilter(allowedDomains).matchesUrl(url);
+}
+
+bool URLParser::shouldCrawl(const std::string& url, const HostFilter& allowedHosts) {
+    return isValid(url) && allowedHosts.matchesUrl(url);
 }
@@ -0,0 +1,226 @@
+#include "../include/url_trap_detector.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// URLs longer than this are almost always generated
+const size_t MAX_URL_LENGTH = 2048;
+
+// Deeper paths are treated as recursive link structures
+const size_t MAX_PATH_SEGMENTS = 24;
+
+// Distinct parameter-name combinations per path before new ones are dropped
+const size_t MAX_PARAM_COMBINATIONS = 64;
+
+// Templates tracked per host; further templates are throttled unrecorded
+const size_t MAX_TEMPLATES_PER_HOST = 4096;
+
+// Priority factor for URLs of a host whose template table is full
+const float OVERFLOW_PRIORITY_SCALE = 0.1f;
+
+// Segments this long made of hex digits are IDs, hashes or UUIDs
+const size_t MIN_ID_LENGTH = 16;
+
+bool isIdToken(const std::string& segment) {
+    if (segment.size() < MIN_ID_LENGTH) {
+        return false;
+    }
+    bool hasDigit = false;
+    for (char c : segment) {
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            hasDigit = true;
+        } else if (!std::isxdigit(static_cast<unsigned char>(c)) && c != '-') {
+            return false;
+        }
+    }
+    return hasDigit;
+}
+
+// "post-12" -> "post-#", "2024" -> "#"
+void appendSegmentTemplate(const std::string& segment, std::string& out) {
+    if (isIdToken(segment)) {
+        out += "{id}";
+        return;
+    }
+    bool inDigits = false;
+    for (char c : segment) {
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            if (!inDigits) {
+                out += '#';
+                inDigits = true;
+            }
+        } else {
+            out += c;
+            inDigits = false;
+        }
+    }
+}
+
+} // namespace
+
+UrlTrapDetector::UrlTrapDetector(size_t softLimit, size_t hardLimit, size_t maxRepeatedSegments)
+    : softLimit(std::max<size_t>(1, softLimit))
+    , hardLimit(std::max(softLimit, hardLimit))
+    , maxRepeatedSegments(std::max<size_t>(1, maxRepeatedSegments))
+    , throttled(0)
+    , dropped(0) {
+}
+
+UrlTrapDetector::Verdict UrlTrapDetector::check(const std::string& url, float& priorityScale) {
+    priorityScale = 1.0f;
+
+    std::string host;
+    std::string pathTemplate;
+    std::string paramNames;
+    std::vector<std::string> segments;
+    if (!makeTemplate(url, host, pathTemplate, paramNames, segments)) {
+        return Verdict::ACCEPT;
+    }
+
+    // Relative links resolved against the wrong base keep appending the
+    // same segments: /a/b/a/b/a/b/...
+    bool repeating = false;
+    if (segments.size() > maxRepeatedSegments) {
+        std::sort(segments.begin(), segments.end());
+        size_t run = 1;
+        for (size_t i = 1; i < segments.size() && !repeating; ++i) {
+            run = segments[i] == segments[i - 1] ? run + 1 : 1;
+            repeating = run > maxRepeatedSegments;
+        }
+    }
+    if (repeating || url.size() > MAX_URL_LENGTH || segments.size() > MAX_PATH_SEGMENTS) {
+        priorityScale = 0.0f;
+        dropped++;
+        return Verdict::DROP;
+    }
+
+    HostPatterns& patterns = hosts[host];
+    auto pathIt = patterns.paths.find(pathTemplate);
+    if (pathIt == patterns.paths.end()) {
+        if (patterns.paths.size() >= MAX_TEMPLATES_PER_HOST) {
+            priorityScale = OVERFLOW_PRIORITY_SCALE;
+            throttled++;
+            return Verdict::THROTTLE;
+        }
+        pathIt = patterns.paths.emplace(pathTemplate, PathPattern()).first;
+    }
+
+    // Faceted search: every filter combination is a new parameter set
+    PathPattern& path = pathIt->second;
+    auto variantIt = path.variants.find(paramNames);
+    if (variantIt == path.variants.end()) {
+        if (path.variants.size() >= MAX_PARAM_COMBINATIONS) {
+            priorityScale = 0.0f;
+            dropped++;
+            return Verdict::DROP;
+        }
+        variantIt = path.variants.emplace(paramNames, 0).first;
+    }
+
+    size_t count = ++variantIt->second;
+
+    if (count > hardLimit) {
+        priorityScale = 0.0f;
+        dropped++;
+        return Verdict::DROP;
+    }
+    if (count > softLimit) {
+        // The penalty deepens as the pattern keeps growing
+        priorityScale = static_cast<float>(softLimit) / static_cast<float>(count);
+        throttled++;
+        return Verdict::THROTTLE;
+    }
+    return Verdict::ACCEPT;
+}
+
+bool UrlTrapDetector::makeTemplate(const std::string& url, std::string& host, std::string& pathTemplate,
+                                   std::string& paramNames, std::vector<std::string>& segments) {
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string::npos) {
+        return false;
+    }
+
+    size_t hostStart = schemeEnd + 3;
+    size_t hostEnd = url.find_first_of("/?#", hostStart);
+    if (hostEnd == std::string::npos) {
+        hostEnd = url.size();
+    }
+    if (hostEnd == hostStart) {
+        return false;
+    }
+    host = url.substr(hostStart, hostEnd - hostStart);
+    std::transform(host.begin(), host.end(), host.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    size_t pathEnd = url.find_first_of("?#", hostEnd);
+    if (pathEnd == std::string::npos) {
+        pathEnd = url.size();
+    }
+
+    pathTemplate.clear();
+    segments.clear();
+    size_t pos = hostEnd;
+    while (pos < pathEnd) {
+        size_t next = url.find('/', pos + 1);
+        if (next == std::string::npos || next > pathEnd) {
+            next = pathEnd;
+        }
+        size_t start = url[pos] == '/' ? pos + 1 : pos;
+        if (next > start) {
+            segments.push_back(url.substr(start, next - start));
+            pathTemplate += '/';
+            appendSegmentTemplate(segments.back(), pathTemplate);
+        }
+        pos = next;
+    }
+    if (pathTemplate.empty()) {
+        pathTemplate = "/";
+    }
+
+    paramNames.clear();
+    if (pathEnd < url.size() && url[pathEnd] == '?') {
+        size_t queryEnd = url.find('#', pathEnd);
+        if (queryEnd == std::string::npos) {
+            queryEnd = url.size();
+        }
+
+        std::vector<std::string> names;
+        size_t start = pathEnd + 1;
+        while (start < queryEnd) {
+            size_t end = url.find_first_of("&;", start);
+            if (end == std::string::npos || end > queryEnd) {
+                end = queryEnd;
+            }
+            size_t equals = url.find('=', start);
+            size_t nameEnd = (equals != std::string::npos && equals < end) ? equals : end;
+            if (nameEnd > start) {
+                names.push_back(url.substr(start, nameEnd - start));
+            }
+            start = end + 1;
+        }
+
+        // Parameter order and repetition do not make a new page
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        for (const auto& name : names) {
+            paramNames += paramNames.empty() ? "?" : "&";
+            paramNames += name;
+        }
+    }
+    return true;
+}
+
+void UrlTrapDetector::clear() {
+    hosts.clear();
+    throttled = 0;
+    dropped = 0;
+}
+
+size_t UrlTrapDetector::getThrottled() const {
+    return throttled;
+}
+
+size_t UrlTrapDetector::getDropped() const {
+    return dropped;
+}
@@ -0,0 +1,234 @@
+"""Reader for the columnar crawl results written by ColumnarWriter (.wcol).
+
+Usage as a module:
+
+    import wcol
+    columns = wcol.read("results.wcol", ["host", "status", "bytes"])
+    frame = wcol.read_dataframe("results.wcol")   # needs pandas
+
+From the command line:
+
+    python tools/wcol.py results.wcol              # schema and summary
+    python tools/wcol.py results.wcol --csv out.csv
+
+Only the requested columns are read from disk, one chunk per row group.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+
+MAGIC = b"WCOL"
+FORMAT_VERSION = 1
+
+INT64, STRING, HASH64 = 1, 2, 3
+PLAIN, DICTIONARY = 0, 1
+UNCOMPRESSED, GZIP = 0, 1
+
+
+class FormatError(Exception):
+    pass
+
+
+class _Cursor:
+    def __init__(self, data, offset=0):
+        self.data = data
+        self.offset = offset
+
+    def varint(self):
+        value = 0
+        shift = 0
+        data = self.data
+        while True:
+            if self.offset >= len(data):
+                raise FormatError("truncated varint")
+            byte = data[self.offset]
+            self.offset += 1
+            value |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return value
+            shift += 7
+
+    def byte(self):
+        if self.offset >= len(self.data):
+            raise FormatError("truncated data")
+        value = self.data[self.offset]
+        self.offset += 1
+        return value
+
+    def bytes(self, size):
+        end = self.offset + size
+        if end > len(self.data):
+            raise FormatError("truncated data")
+        value = self.data[self.offset:end]
+        self.offset = end
+        return value
+
+    def string(self):
+        return self.bytes(self.varint()).decode("utf-8", "replace")
+
+
+def _decode_varints(data, count):
+    values = [0] * count
+    offset = 0
+    for i in range(count):
+        value = 0
+        shift = 0
+        while True:
+            byte = data[offset]
+            offset += 1
+            value |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                break
+            shift += 7
+        values[i] = value
+    return values
+
+
+def _decode_chunk(chunk, column_type, rows):
+    cursor = _Cursor(chunk)
+    encoding = cursor.byte()
+    compression = cursor.byte()
+    raw_size = cursor.varint()
+    stored = cursor.bytes(cursor.varint())
+    if compression == GZIP:
+        raw = zlib.decompress(stored, 16 + zlib.MAX_WBITS)
+    elif compression == UNCOMPRESSED:
+        raw = stored
+    else:
+        raise FormatError("unknown compression %d" % compression)
+    if len(raw) != raw_size:
+        raise FormatError("column chunk has the wrong size")
+
+    if column_type == INT64:
+        return [(v >> 1) ^ -(v & 1) for v in _decode_varints(raw, rows)]
+    if column_type == HASH64:
+        return list(struct.unpack("<%dQ" % rows, raw))
+    if column_type != STRING:
+        raise FormatError("unknown column type %d" % column_type)
+
+    cursor = _Cursor(raw)
+    if encoding == DICTIONARY:
+        dictionary = [cursor.string() for _ in range(cursor.varint())]
+        indices = _decode_varints(raw[cursor.offset:], rows)
+        return [dictionary[i] for i in indices]
+    if encoding == PLAIN:
+        return [cursor.string() for _ in range(rows)]
+    raise FormatError("unknown encoding %d" % encoding)
+
+
+class WcolFile:
+    """An open results file; columns are read on demand."""
+
+    def __init__(self, path):
+        self._file = open(path, "rb")
+        header = self._file.read(len(MAGIC) + 1)
+        if header[:len(MAGIC)] != MAGIC or len(header) != len(MAGIC) + 1:
+            raise FormatError("not a .wcol file")
+        if header[len(MAGIC)] != FORMAT_VERSION:
+            raise FormatError("unsupported version %d" % header[len(MAGIC)])
+
+        self._file.seek(-8, 2)
+        trailer = self._file.read(8)
+        if trailer[4:] != MAGIC:
+            raise FormatError("footer missing; the writer was not closed")
+        footer_size = struct.unpack("<I", trailer[:4])[0]
+        self._file.seek(-8 - footer_size, 2)
+        cursor = _Cursor(self._file.read(footer_size))
+
+        self.columns = []
+        for _ in range(cursor.varint()):
+            name = cursor.string()
+            self.columns.append((name, cursor.byte()))
+
+        self.row_groups = []
+        for _ in range(cursor.varint()):
+            rows = cursor.varint()
+            chunks = [(cursor.varint(), cursor.varint()) for _ in self.columns]
+            self.row_groups.append((rows, chunks))
+        self.rows = cursor.varint()
+
+    def close(self):
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    @property
+    def column_names(self):
+        return [name for name, _ in self.columns]
+
+    def read_column(self, name):
+        try:
+            index = self.column_names.index(name)
+        except ValueError:
+            raise KeyError(name)
+        column_type = self.columns[index][1]
+        values = []
+        for rows, chunks in self.row_groups:
+            offset, size = chunks[index]
+            self._file.seek(offset)
+            values.extend(_decode_chunk(self._file.read(size), column_type, rows))
+        return values
+
+
+def read(path, columns=None):
+    """Return {column name: list of values} for the given columns (all by default)."""
+    with WcolFile(path) as results:
+        names = columns if columns is not None else results.column_names
+        return {name: results.read_column(name) for name in names}
+
+
+def read_dataframe(path, columns=None):
+    """Return the given columns as a pandas DataFrame."""
+    import pandas
+    return pandas.DataFrame(read(path, columns))
+
+
+def _summarize(path):
+    with WcolFile(path) as results:
+        print("%s: %d rows in %d row groups" % (path, results.rows, len(results.row_groups)))
+        for name, column_type in results.columns:
+            print("  %-14s %s" % (name, {INT64: "int64", STRING: "string", HASH64: "hash64"}.get(column_type, "?")))
+        if results.rows == 0:
+            return
+
+        status = results.read_column("status")
+        hosts = results.read_column("host")
+        counts = {}
+        for code in status:
+            counts[code] = counts.get(code, 0) + 1
+        print("status: " + ", ".join("%d x%d" % (code, n) for code, n in sorted(counts.items())))
+        print("hosts: %d" % len(set(hosts)))
+        print("bytes: %d" % sum(results.read_column("bytes")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Inspect or convert a .wcol crawl results file")
+    parser.add_argument("path")
+    parser.add_argument("--csv", help="write every column to this CSV file")
+    args = parser.parse_args()
+
+    try:
+        if args.csv:
+            columns = read(args.path)
+            names = list(columns)
+            with open(args.csv, "w", newline="") as out:
+                writer = csv.writer(out)
+                writer.writerow(names)
+                writer.writerows(zip(*(columns[name] for name in names)))
+        else:
+            _summarize(args.path)
+    except FormatError as error:
+        print("%s: %s" % (args.path, error), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())